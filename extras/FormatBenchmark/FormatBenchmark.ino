@@ -0,0 +1,248 @@
+
+//      ******************************************************************
+//      *                                                                *
+//      *     Benchmark comparing the UI's number formatting with the    *
+//      *                  core's itoa() and dtostrf()                   *
+//      *                                                                *
+//      *            S. Reifel & Co.                4/25/2023            *
+//      *                                                                *
+//      ******************************************************************
+
+// The number printing functions (lcdPrint(), lcdPrintCentered(), the Number Boxes
+// and the Numeric Keypad) format numbers with uiFormatInt() and uiFormatFloat() 
+// rather than itoa() and dtostrf().  This sketch times each of them against the 
+// core's functions, and checks that they give the same text.  Nothing is drawn, 
+// so a display isn't needed.  Open the Serial Monitor at 115200 baud to see the 
+// results.
+//
+// On the host build (extras/host) the clock is virtual, so the times printed 
+// there are meaningless, but the text is still checked.
+//
+
+
+// ***********************************************************************
+
+
+#include <Arduino.h>
+#include <TouchUserInterfaceForArduino.h>
+
+
+//
+// number of times each function is timed, and the numbers formatted
+//
+const int BENCHMARK_REPEAT_COUNT = 20;
+const int BENCHMARK_VALUE_COUNT = 50;
+
+long intValues[BENCHMARK_VALUE_COUNT];
+double floatValues[BENCHMARK_VALUE_COUNT];
+
+volatile char benchmarkSink;
+
+
+// ---------------------------------------------------------------------------------
+//                                 Setup and Loop
+// ---------------------------------------------------------------------------------
+
+void setup() 
+{
+  Serial.begin(115200);
+  delay(2000);
+
+  //
+  // make numbers of all sizes, positive and negative
+  //
+  randomSeed(1);
+  for (int i = 0; i < BENCHMARK_VALUE_COUNT; i++)
+  {
+    long magnitude = 1L << (i % 31);
+    intValues[i] = random(magnitude);
+    floatValues[i] = (double) random(1000000) / 1000.0 * (double) (1L << (i % 20)) / 1024.0;
+    if (i & 1)
+    {
+      intValues[i] = -intValues[i];
+      floatValues[i] = -floatValues[i];
+    }
+  }
+
+  Serial.println("function                        us per call     mismatches");
+  benchmarkInt();
+  benchmarkFloat(0);
+  benchmarkFloat(2);
+  benchmarkFloat(4);
+  benchmarkFixed();
+}
+
+
+
+void loop() 
+{
+  delay(1000);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                   The benchmarks
+// ---------------------------------------------------------------------------------
+
+//
+// time itoa() and uiFormatInt()
+//
+void benchmarkInt(void)
+{
+  char coreBuffer[40];
+  char uiBuffer[UI_NUMBER_BUFFER_LENGTH];
+  unsigned long startTime;
+
+  startTime = micros();
+  for (int repeat = 0; repeat < BENCHMARK_REPEAT_COUNT; repeat++)
+  {
+    for (int i = 0; i < BENCHMARK_VALUE_COUNT; i++)
+    {
+      ltoa(intValues[i], coreBuffer, 10);
+      benchmarkSink = coreBuffer[0];
+    }
+  }
+  printResult("ltoa()", micros() - startTime, -1);
+
+  startTime = micros();
+  for (int repeat = 0; repeat < BENCHMARK_REPEAT_COUNT; repeat++)
+  {
+    for (int i = 0; i < BENCHMARK_VALUE_COUNT; i++)
+    {
+      uiFormatInt(uiBuffer, intValues[i]);
+      benchmarkSink = uiBuffer[0];
+    }
+  }
+  unsigned long elapsedTime = micros() - startTime;
+
+  int mismatchCount = 0;
+  for (int i = 0; i < BENCHMARK_VALUE_COUNT; i++)
+  {
+    ltoa(intValues[i], coreBuffer, 10);
+    uiFormatInt(uiBuffer, intValues[i]);
+    mismatchCount += checkResult(coreBuffer, uiBuffer);
+  }
+  printResult("uiFormatInt()", elapsedTime, mismatchCount);
+}
+
+
+
+//
+// time dtostrf() and uiFormatFloat()
+//  Enter:  digitsRightOfDecimal = number of digits to format right of the decimal point
+//
+void benchmarkFloat(int digitsRightOfDecimal)
+{
+  char coreBuffer[40];
+  char uiBuffer[UI_NUMBER_BUFFER_LENGTH];
+  char name[40];
+  unsigned long startTime;
+
+  startTime = micros();
+  for (int repeat = 0; repeat < BENCHMARK_REPEAT_COUNT; repeat++)
+  {
+    for (int i = 0; i < BENCHMARK_VALUE_COUNT; i++)
+    {
+      dtostrf(floatValues[i], 1, digitsRightOfDecimal, coreBuffer);
+      benchmarkSink = coreBuffer[0];
+    }
+  }
+  sprintf(name, "dtostrf(), %d digits", digitsRightOfDecimal);
+  printResult(name, micros() - startTime, -1);
+
+  startTime = micros();
+  for (int repeat = 0; repeat < BENCHMARK_REPEAT_COUNT; repeat++)
+  {
+    for (int i = 0; i < BENCHMARK_VALUE_COUNT; i++)
+    {
+      uiFormatFloat(uiBuffer, floatValues[i], digitsRightOfDecimal);
+      benchmarkSink = uiBuffer[0];
+    }
+  }
+  unsigned long elapsedTime = micros() - startTime;
+
+  int mismatchCount = 0;
+  for (int i = 0; i < BENCHMARK_VALUE_COUNT; i++)
+  {
+    dtostrf(floatValues[i], 1, digitsRightOfDecimal, coreBuffer);
+    uiFormatFloat(uiBuffer, floatValues[i], digitsRightOfDecimal);
+    mismatchCount += checkResult(coreBuffer, uiBuffer);
+  }
+  sprintf(name, "uiFormatFloat(), %d digits", digitsRightOfDecimal);
+  printResult(name, elapsedTime, mismatchCount);
+}
+
+
+
+//
+// time uiFormatFixed(), checking it against dtostrf() of the same number
+//
+void benchmarkFixed(void)
+{
+  char coreBuffer[40];
+  char uiBuffer[UI_NUMBER_BUFFER_LENGTH];
+  unsigned long startTime;
+
+  startTime = micros();
+  for (int repeat = 0; repeat < BENCHMARK_REPEAT_COUNT; repeat++)
+  {
+    for (int i = 0; i < BENCHMARK_VALUE_COUNT; i++)
+    {
+      uiFormatFixed(uiBuffer, intValues[i], 2);
+      benchmarkSink = uiBuffer[0];
+    }
+  }
+  unsigned long elapsedTime = micros() - startTime;
+
+  int mismatchCount = 0;
+  for (int i = 0; i < BENCHMARK_VALUE_COUNT; i++)
+  {
+    long n = intValues[i] / 4;
+    dtostrf((double) n / 100.0, 1, 2, coreBuffer);
+    uiFormatFixed(uiBuffer, n, 2);
+    mismatchCount += checkResult(coreBuffer, uiBuffer);
+  }
+  printResult("uiFormatFixed(), 2 digits", elapsedTime, mismatchCount);
+}
+
+
+
+//
+// compare the text from the core and the UI, printing it if it differs
+//  Exit:   1 returned if they differ, else 0
+//
+int checkResult(const char *coreText, const char *uiText)
+{
+  if (strcmp(coreText, uiText) == 0)
+    return(0);
+
+  Serial.print("    differs: ");
+  Serial.print(coreText);
+  Serial.print("  ");
+  Serial.println(uiText);
+  return(1);
+}
+
+
+
+//
+// print the time per call
+//  Enter:  name -> name of the function timed
+//          elapsedTime = time for all of the calls, in us
+//          mismatchCount = number of numbers formatted differently, -1 if not checked
+//
+void printResult(const char *name, unsigned long elapsedTime, int mismatchCount)
+{
+  char line[80];
+  double microsPerCall = (double) elapsedTime / (BENCHMARK_REPEAT_COUNT * BENCHMARK_VALUE_COUNT);
+
+  sprintf(line, "%-30s %10s", name, "");
+  Serial.print(line);
+  Serial.print(microsPerCall, 2);
+  if (mismatchCount >= 0)
+  {
+    Serial.print("     ");
+    Serial.print(mismatchCount);
+  }
+  Serial.println();
+}
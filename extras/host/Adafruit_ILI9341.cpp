@@ -0,0 +1,717 @@
+//      ******************************************************************
+//      *                                                                *
+//      *              Host stand-in for Adafruit_ILI9341.h              *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+#include "Adafruit_ILI9341.h"
+#include "HostSim.h"
+#include <stdio.h>
+#include <execinfo.h>
+#include <cxxabi.h>
+
+static Adafruit_ILI9341 *registeredDisplay = NULL;
+
+static FILE *transactionLog = NULL;
+static bool transactionsSinceFrameFlg = false;
+static int frameNumber = 0;
+
+static const char *overdrawPrefix = NULL;
+static FILE *overdrawReport = NULL;
+static const char LIBRARY_CLASS_PREFIX[] = "TouchUserInterfaceForArduino::";
+
+
+//
+// get the most recently created display
+//
+Adafruit_ILI9341 *hostGetDisplay(void)
+{
+  return(registeredDisplay);
+}
+
+
+
+//
+// set the display returned by hostGetDisplay()
+//
+void hostRegisterDisplay(Adafruit_ILI9341 *display)
+{
+  registeredDisplay = display;
+}
+
+
+
+//
+// log each SPI transaction to a file, see spi_cost_model.py for the format
+//  Enter:  fileName -> log file to write
+//  Exit:   true returned on success
+//
+bool hostOpenTransactionLog(const char *fileName)
+{
+  transactionLog = fopen(fileName, "w");
+  if (transactionLog == NULL)
+    return(false);
+
+  fprintf(transactionLog, "# T callChain commandBytes dataBytes addressWindows pixels\n");
+  fprintf(transactionLog, "# F virtualTimeMillis\n");
+  return(true);
+}
+
+
+
+//
+// count how many times each pixel is written in every frame, saving a heatmap 
+// of each frame and a report of the overdraw
+//  Enter:  prefix -> start of the file names: the heatmaps are <prefix>-NNN.ppm
+//                    and the report is <prefix>.txt
+//  Exit:   true returned on success
+//
+bool hostOpenOverdrawReport(const char *prefix)
+{
+  char fileName[512];
+
+  snprintf(fileName, sizeof(fileName), "%s.txt", prefix);
+  overdrawReport = fopen(fileName, "w");
+  if (overdrawReport == NULL)
+    return(false);
+
+  overdrawPrefix = prefix;
+  if (registeredDisplay != NULL)
+    registeredDisplay->hostEnableOverdraw();
+  fprintf(overdrawReport, "%-6s %8s %8s %8s %9s %5s  %s\n", "frame", "at ms", "pixels", "writes", 
+    "overdraw", "max", "heatmap");
+  return(true);
+}
+
+
+
+//
+// mark the end of a frame, the UI has finished drawing and is reading the touch
+// screen: write a marker to the transaction log and report the frame's overdraw
+//
+void hostEndDisplayFrame(void)
+{
+  if (!transactionsSinceFrameFlg)
+    return;
+
+  unsigned long long frameMillis = hostGetMicros() / 1000ULL;
+  if (transactionLog != NULL)
+    fprintf(transactionLog, "F %llu\n", frameMillis);
+
+  if ((overdrawReport != NULL) && (registeredDisplay != NULL))
+  {
+    char fileName[512];
+    unsigned long pixels, writes, maxWrites;
+
+    snprintf(fileName, sizeof(fileName), "%s-%03d.ppm", overdrawPrefix, frameNumber);
+    registeredDisplay->hostGetOverdraw(pixels, writes, maxWrites);
+    registeredDisplay->hostSaveOverdrawHeatmap(fileName);
+    fprintf(overdrawReport, "%-6d %8llu %8lu %8lu %9.2f %5lu  %s\n", frameNumber, frameMillis, pixels, 
+      writes, pixels ? (double) writes / pixels : 0.0, maxWrites, fileName);
+    fflush(overdrawReport);
+    registeredDisplay->hostResetOverdraw();
+  }
+
+  transactionsSinceFrameFlg = false;
+  frameNumber++;
+}
+
+
+
+//
+// find the chain of library functions that started a transaction by walking the
+// call stack (the program is linked with -rdynamic so the names can be found), 
+// ie: "selectAndDrawMenu>drawMenu>drawMenuItem>drawButton>lcdDrawFilledRectangle"
+//  Enter:  chain -> storage for the chain, outermost call first
+//
+static void findLibraryCallChain(char *chain, size_t size)
+{
+  void *frames[64];
+  int frameCount = backtrace(frames, 64);
+  char **symbols = backtrace_symbols(frames, frameCount);
+  char names[16][64];
+  int nameCount = 0;
+
+  snprintf(chain, size, "-");
+  if (symbols == NULL)
+    return;
+
+  //
+  // collect the innermost run of library functions, symbols look like 
+  // "program(mangledName+0x1c) [0x5612...]"
+  //
+  for (int i = 0; (i < frameCount) && (nameCount < 16); i++)
+  {
+    char *start = strchr(symbols[i], '(');
+    char *end = (start != NULL) ? strchr(start, '+') : NULL;
+    if ((start == NULL) || (end == NULL) || (end == start + 1))
+      continue;
+    *end = 0;
+
+    int status;
+    char *name = abi::__cxa_demangle(start + 1, NULL, NULL, &status);
+    if (name == NULL)
+      continue;
+
+    bool libraryFlg = (strncmp(name, LIBRARY_CLASS_PREFIX, sizeof(LIBRARY_CLASS_PREFIX) - 1) == 0);
+    if (libraryFlg)
+    {
+      char *shortName = name + sizeof(LIBRARY_CLASS_PREFIX) - 1;
+      char *args = strchr(shortName, '(');
+      if (args != NULL)
+        *args = 0;
+      snprintf(names[nameCount++], sizeof(names[0]), "%s", shortName);
+    }
+    free(name);
+
+    if (!libraryFlg && (nameCount > 0))
+      break;
+  }
+  free(symbols);
+
+  //
+  // join them, outermost first
+  //
+  size_t length = 0;
+  for (int i = nameCount - 1; (i >= 0) && (length < size - 1); i--)
+    length += snprintf(chain + length, size - length, (i == nameCount - 1) ? "%s" : ">%s", names[i]);
+}
+
+
+
+Adafruit_ILI9341::Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t rst) :
+  Adafruit_GFX(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT)
+{
+  (void) cs; (void) dc; (void) rst;
+  memset(frameMemory, 0, sizeof(frameMemory));
+  windowX = windowY = windowIndex = 0;
+  windowW = windowH = 1;
+  hostResetCounts();
+  pixelWrites = NULL;
+  if (overdrawPrefix != NULL)
+    hostEnableOverdraw();
+  hostRegisterDisplay(this);
+}
+
+
+
+Adafruit_ILI9341::Adafruit_ILI9341(SPIClass *spiClass, int8_t dc, int8_t cs, int8_t rst) :
+  Adafruit_ILI9341(cs, dc, rst)
+{
+  (void) spiClass;
+}
+
+
+
+//
+// initialize the display
+//
+void Adafruit_ILI9341::begin(uint32_t freq)
+{
+  (void) freq;
+  setRotation(0);
+  hostResetCounts();
+}
+
+
+
+//
+// set the rotation of the display
+//
+void Adafruit_ILI9341::setRotation(uint8_t r)
+{
+  Adafruit_GFX::setRotation(r);
+
+  startWrite();                             // MADCTL command and its parameter
+  counts.commandBytes++;
+  counts.dataBytes++;
+  endWrite();
+}
+
+
+
+//
+// start a group of writes (selects the display on real hardware)
+//
+void Adafruit_ILI9341::startWrite(void)
+{
+  counts.transactions++;
+
+  if (transactionLog != NULL)
+  {
+    transactionStartCounts = counts;
+    findLibraryCallChain(transactionCallChain, sizeof(transactionCallChain));
+  }
+}
+
+
+
+//
+// end a group of writes, logging the transaction
+//
+void Adafruit_ILI9341::endWrite(void)
+{
+  transactionsSinceFrameFlg = true;
+  if (transactionLog == NULL)
+    return;
+
+  fprintf(transactionLog, "T %s %lu %lu %lu %lu\n", transactionCallChain, 
+    counts.commandBytes - transactionStartCounts.commandBytes, 
+    counts.dataBytes - transactionStartCounts.dataBytes,
+    counts.addressWindows - transactionStartCounts.addressWindows, 
+    counts.pixels - transactionStartCounts.pixels);
+}
+
+
+
+//
+// set the window of frame memory that following pixels are written into
+//
+void Adafruit_ILI9341::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  windowX = x;
+  windowY = y;
+  windowW = w;
+  windowH = h;
+  windowIndex = 0;
+
+  counts.addressWindows++;                  // CASET + 4 bytes, PASET + 4 bytes, RAMWR
+  counts.commandBytes += 3;
+  counts.dataBytes += 8;
+  hostCountDisplayWrite();
+}
+
+
+
+//
+// store the next pixel of the address window, mapping the logical (rotated) 
+// coordinate to the panel's native frame memory the way MADCTL does
+//
+void Adafruit_ILI9341::pushPixel(uint16_t color)
+{
+  counts.pixels++;
+  counts.dataBytes += 2;
+  hostCountDisplayWrite();
+
+  if ((windowW <= 0) || (windowH <= 0))
+    return;
+
+  int32_t x = windowX + (windowIndex % windowW);
+  int32_t y = windowY + (windowIndex / windowW);
+  windowIndex++;
+  if (windowIndex >= (int32_t) windowW * windowH)
+    windowIndex = 0;
+
+  if ((x < 0) || (x >= _width) || (y < 0) || (y >= _height))
+    return;
+
+  int32_t idx = nativeIndex(x, y);
+  frameMemory[idx] = color;
+  if ((pixelWrites != NULL) && (pixelWrites[idx] < 0xffff))
+    pixelWrites[idx]++;
+}
+
+
+
+//
+// get the index into the panel's native frame memory of a logical (rotated) 
+// coordinate, the way MADCTL maps them
+//
+int32_t Adafruit_ILI9341::nativeIndex(int32_t x, int32_t y)
+{
+  int32_t px, py;
+  switch(rotation)
+  {
+    case 0:  px = ILI9341_TFTWIDTH - 1 - x;  py = y;  break;
+    case 1:  px = ILI9341_TFTWIDTH - 1 - y;  py = ILI9341_TFTHEIGHT - 1 - x;  break;
+    case 2:  px = x;  py = ILI9341_TFTHEIGHT - 1 - y;  break;
+    default: px = y;  py = x;  break;
+  }
+  return(py * ILI9341_TFTWIDTH + px);
+}
+
+
+
+//
+// write pixels into the address window
+//
+void Adafruit_ILI9341::writePixels(uint16_t *colors, uint32_t len, bool block, bool bigEndian)
+{
+  (void) block; (void) bigEndian;
+  while (len--)
+    pushPixel(*colors++);
+}
+
+
+
+//
+// write the same color to len pixels of the address window
+//
+void Adafruit_ILI9341::writeColor(uint16_t color, uint32_t len)
+{
+  while (len--)
+    pushPixel(color);
+}
+
+
+
+//
+// write one pixel, within startWrite()/endWrite()
+//
+void Adafruit_ILI9341::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+  if ((x >= 0) && (x < _width) && (y >= 0) && (y < _height))
+  {
+    setAddrWindow(x, y, 1, 1);
+    pushPixel(color);
+  }
+}
+
+
+
+//
+// draw one pixel
+//
+void Adafruit_ILI9341::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  if ((x >= 0) && (x < _width) && (y >= 0) && (y < _height))
+  {
+    startWrite();
+    setAddrWindow(x, y, 1, 1);
+    pushPixel(color);
+    endWrite();
+  }
+}
+
+
+
+//
+// fill a rectangle that's known to be on the screen
+//
+void Adafruit_ILI9341::writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  setAddrWindow(x, y, w, h);
+  writeColor(color, (uint32_t) w * h);
+}
+
+
+
+//
+// fill a rectangle clipped to the screen, within startWrite()/endWrite()
+//
+void Adafruit_ILI9341::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  if (w && h)
+  {
+    if (w < 0)
+    {
+      x += w + 1;
+      w = -w;
+    }
+    if (x < _width)
+    {
+      if (h < 0)
+      {
+        y += h + 1;
+        h = -h;
+      }
+      if (y < _height)
+      {
+        int16_t x2 = x + w - 1;
+        if (x2 >= 0)
+        {
+          int16_t y2 = y + h - 1;
+          if (y2 >= 0)
+          {
+            if (x < 0)
+            {
+              x = 0;
+              w = x2 + 1;
+            }
+            if (y < 0)
+            {
+              y = 0;
+              h = y2 + 1;
+            }
+            if (x2 >= _width)
+              w = _width - x;
+            if (y2 >= _height)
+              h = _height - y;
+            writeFillRectPreclipped(x, y, w, h, color);
+          }
+        }
+      }
+    }
+  }
+}
+
+
+
+//
+// draw a filled rectangle
+//
+void Adafruit_ILI9341::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  startWrite();
+  writeFillRect(x, y, w, h, color);
+  endWrite();
+}
+
+
+
+//
+// draw a horizontal line clipped to the screen, within startWrite()/endWrite()
+//
+void Adafruit_ILI9341::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  if ((y >= 0) && (y < _height) && w)
+  {
+    if (w < 0)
+    {
+      x += w + 1;
+      w = -w;
+    }
+    if (x < _width)
+    {
+      int16_t x2 = x + w - 1;
+      if (x2 >= 0)
+      {
+        if (x < 0)
+        {
+          x = 0;
+          w = x2 + 1;
+        }
+        if (x2 >= _width)
+          w = _width - x;
+        writeFillRectPreclipped(x, y, w, 1, color);
+      }
+    }
+  }
+}
+
+
+
+//
+// draw a vertical line clipped to the screen, within startWrite()/endWrite()
+//
+void Adafruit_ILI9341::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  if ((x >= 0) && (x < _width) && h)
+  {
+    if (h < 0)
+    {
+      y += h + 1;
+      h = -h;
+    }
+    if (y < _height)
+    {
+      int16_t y2 = y + h - 1;
+      if (y2 >= 0)
+      {
+        if (y < 0)
+        {
+          y = 0;
+          h = y2 + 1;
+        }
+        if (y2 >= _height)
+          h = _height - y;
+        writeFillRectPreclipped(x, y, 1, h, color);
+      }
+    }
+  }
+}
+
+
+
+//
+// draw a horizontal line
+//
+void Adafruit_ILI9341::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  startWrite();
+  writeFastHLine(x, y, w, color);
+  endWrite();
+}
+
+
+
+//
+// draw a vertical line
+//
+void Adafruit_ILI9341::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  startWrite();
+  writeFastVLine(x, y, h, color);
+  endWrite();
+}
+
+
+
+//
+// the RAM version of drawRGBBitmap() streams the image through one address window
+//
+void Adafruit_ILI9341::drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w, int16_t h)
+{
+  int16_t x2, y2;
+  if ((x >= _width) || (y >= _height) || ((x2 = (x + w - 1)) < 0) || ((y2 = (y + h - 1)) < 0))
+    return;
+
+  int16_t bx1 = 0, by1 = 0, saveW = w;
+  if (x < 0)
+  {
+    w += x;
+    bx1 = -x;
+    x = 0;
+  }
+  if (y < 0)
+  {
+    h += y;
+    by1 = -y;
+    y = 0;
+  }
+  if (x2 >= _width)
+    w = _width - x;
+  if (y2 >= _height)
+    h = _height - y;
+
+  pcolors += by1 * saveW + bx1;
+  startWrite();
+  setAddrWindow(x, y, w, h);
+  while (h--)
+  {
+    writePixels(pcolors, w);
+    pcolors += saveW;
+  }
+  endWrite();
+}
+
+
+
+//
+// read a pixel back using logical (rotated) coordinates
+//
+uint16_t Adafruit_ILI9341::hostGetPixel(int16_t x, int16_t y)
+{
+  if ((x < 0) || (x >= _width) || (y < 0) || (y >= _height))
+    return(0);
+
+  return(frameMemory[nativeIndex(x, y)]);
+}
+
+
+
+//
+// save the screen, as currently rotated, as a binary PPM image
+//
+bool Adafruit_ILI9341::hostSavePPM(const char *fileName)
+{
+  FILE *f = fopen(fileName, "wb");
+  if (f == NULL)
+    return(false);
+
+  fprintf(f, "P6\n%d %d\n255\n", _width, _height);
+  for (int16_t y = 0; y < _height; y++)
+  {
+    for (int16_t x = 0; x < _width; x++)
+    {
+      uint16_t c = hostGetPixel(x, y);
+      uint8_t rgb[3];
+      rgb[0] = ((c >> 11) & 0x1f) * 255 / 31;
+      rgb[1] = ((c >> 5) & 0x3f) * 255 / 63;
+      rgb[2] = (c & 0x1f) * 255 / 31;
+      fwrite(rgb, 1, 3, f);
+    }
+  }
+  fclose(f);
+  return(true);
+}
+
+
+
+//
+// get the overdraw since it was last reset
+//  Exit:   pixels = number of pixels written at least once
+//          writes = total number of pixel writes
+//          maxWrites = most times any one pixel was written
+//
+void Adafruit_ILI9341::hostGetOverdraw(unsigned long &pixels, unsigned long &writes, unsigned long &maxWrites)
+{
+  pixels = writes = maxWrites = 0;
+  if (pixelWrites == NULL)
+    return;
+
+  for (int32_t i = 0; i < ILI9341_TFTWIDTH * ILI9341_TFTHEIGHT; i++)
+  {
+    if (pixelWrites[i] == 0)
+      continue;
+    pixels++;
+    writes += pixelWrites[i];
+    if (pixelWrites[i] > maxWrites)
+      maxWrites = pixelWrites[i];
+  }
+}
+
+
+
+//
+// start counting the writes to each pixel
+//
+void Adafruit_ILI9341::hostEnableOverdraw(void)
+{
+  if (pixelWrites == NULL)
+    pixelWrites = (uint16_t *) calloc(ILI9341_TFTWIDTH * ILI9341_TFTHEIGHT, sizeof(uint16_t));
+}
+
+
+
+//
+// clear the count of writes to each pixel
+//
+void Adafruit_ILI9341::hostResetOverdraw(void)
+{
+  if (pixelWrites != NULL)
+    memset(pixelWrites, 0, ILI9341_TFTWIDTH * ILI9341_TFTHEIGHT * sizeof(uint16_t));
+}
+
+
+
+//
+// save a heatmap of the writes to each pixel as a PPM image: pixels not written 
+// show the screen dimmed, then written once is blue, twice green, three times 
+// yellow, four orange, and five or more red
+//
+bool Adafruit_ILI9341::hostSaveOverdrawHeatmap(const char *fileName)
+{
+  static const uint8_t heat[5][3] = 
+    {{0, 64, 255}, {0, 200, 0}, {255, 255, 0}, {255, 140, 0}, {255, 0, 0}};
+
+  if (pixelWrites == NULL)
+    return(false);
+
+  FILE *f = fopen(fileName, "wb");
+  if (f == NULL)
+    return(false);
+
+  fprintf(f, "P6\n%d %d\n255\n", _width, _height);
+  for (int16_t y = 0; y < _height; y++)
+  {
+    for (int16_t x = 0; x < _width; x++)
+    {
+      uint16_t writes = pixelWrites[nativeIndex(x, y)];
+      uint8_t rgb[3];
+      if (writes == 0)
+      {
+        uint16_t c = hostGetPixel(x, y);
+        uint8_t gray = (((c >> 11) & 0x1f) * 8 + ((c >> 5) & 0x3f) * 4 + (c & 0x1f) * 8) / 12;
+        rgb[0] = rgb[1] = rgb[2] = gray;
+      }
+      else
+        memcpy(rgb, heat[writes > 5 ? 4 : writes - 1], 3);
+      fwrite(rgb, 1, 3, f);
+    }
+  }
+  fclose(f);
+  return(true);
+}
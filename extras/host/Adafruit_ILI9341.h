@@ -0,0 +1,93 @@
+//      ******************************************************************
+//      *                                                                *
+//      *              Host stand-in for Adafruit_ILI9341.h              *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Pixels are stored in an in-memory copy of the ILI9341's 240 x 320 RGB565
+// frame memory.  Drawing goes through the same address-window sequence used by
+// the real SPI driver (one window per pixel, line or filled rectangle).
+//
+
+#ifndef _ADAFRUIT_ILI9341H_
+#define _ADAFRUIT_ILI9341H_
+
+#include <Adafruit_GFX.h>
+#include <SPI.h>
+
+#define ILI9341_TFTWIDTH 240
+#define ILI9341_TFTHEIGHT 320
+
+#define ILI9341_BLACK 0x0000
+#define ILI9341_WHITE 0xFFFF
+
+
+//
+// counts of the SPI traffic the real driver would send
+//
+typedef struct
+{
+  unsigned long transactions;               // startWrite() or single command, CS low to CS high
+  unsigned long addressWindows;             // setAddrWindow(): CASET, PASET and RAMWR commands
+  unsigned long commandBytes;               // bytes sent with DC low
+  unsigned long dataBytes;                  // bytes sent with DC high, including pixels
+  unsigned long pixels;                     // pixels written to frame memory
+} HOST_SPI_COUNTS;
+
+class Adafruit_ILI9341 : public Adafruit_GFX
+{
+  public:
+    Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t rst = -1);
+    Adafruit_ILI9341(SPIClass *spiClass, int8_t dc, int8_t cs = -1, int8_t rst = -1);
+
+    void begin(uint32_t freq = 0);
+    void setRotation(uint8_t r);
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    void startWrite(void);
+    void endWrite(void);
+    void writePixel(int16_t x, int16_t y, uint16_t color);
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+
+    using Adafruit_GFX::drawRGBBitmap;
+    void drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w, int16_t h);
+
+    void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void writePixels(uint16_t *colors, uint32_t len, bool block = true, bool bigEndian = false);
+    void writeColor(uint16_t color, uint32_t len);
+
+    //
+    // host only: read back the panel, count SPI traffic, and count writes to each pixel
+    //
+    uint16_t hostGetPixel(int16_t x, int16_t y);
+    bool hostSavePPM(const char *fileName);
+    HOST_SPI_COUNTS hostGetCounts(void) { return(counts); }
+    void hostResetCounts(void) { memset(&counts, 0, sizeof(counts)); }
+    void hostEnableOverdraw(void);
+    void hostGetOverdraw(unsigned long &pixels, unsigned long &writes, unsigned long &maxWrites);
+    void hostResetOverdraw(void);
+    bool hostSaveOverdrawHeatmap(const char *fileName);
+
+  private:
+    void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void pushPixel(uint16_t color);
+    int32_t nativeIndex(int32_t x, int32_t y);
+
+    uint16_t frameMemory[ILI9341_TFTWIDTH * ILI9341_TFTHEIGHT];
+    int16_t windowX, windowY, windowW, windowH;
+    int32_t windowIndex;
+    HOST_SPI_COUNTS counts;
+    uint16_t *pixelWrites;
+    HOST_SPI_COUNTS transactionStartCounts;
+    char transactionCallChain[512];
+};
+
+#endif
@@ -0,0 +1,215 @@
+//      ******************************************************************
+//      *                                                                *
+//      *               Host stand-in for the Arduino core               *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// The virtual clock, Serial, and the few avr-libc conversion functions used
+// by the library.
+//
+
+#include "Arduino.h"
+#include "HostSim.h"
+#include <stdio.h>
+#include <SPI.h>
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+static unsigned long long clockMicros = 0;
+static unsigned long long runLimitMicros = 0;
+static void (*runLimitCallback)(void) = NULL;
+
+
+//
+// advance the virtual clock, ending the run if the run limit is reached
+//
+void hostAdvanceMicros(unsigned long us)
+{
+  clockMicros += us;
+  if ((runLimitCallback != NULL) && (clockMicros >= runLimitMicros))
+  {
+    void (*callback)(void) = runLimitCallback;
+    runLimitCallback = NULL;
+    callback();
+  }
+}
+
+
+
+//
+// get the virtual clock in microseconds
+//
+unsigned long long hostGetMicros(void)
+{
+  return(clockMicros);
+}
+
+
+
+//
+// set a time on the virtual clock when the run ends, onLimit() is called then
+//
+void hostSetRunLimitMillis(unsigned long ms, void (*onLimit)(void))
+{
+  runLimitMicros = (unsigned long long) ms * 1000ULL;
+  runLimitCallback = onLimit;
+}
+
+
+
+//
+// reading the clock costs a microsecond, so polling loops always make progress
+//
+unsigned long millis(void)
+{
+  hostAdvanceMicros(1);
+  return((unsigned long) (clockMicros / 1000ULL));
+}
+
+
+
+//
+// get the virtual clock in microseconds, this also costs a microsecond
+//
+unsigned long micros(void)
+{
+  hostAdvanceMicros(1);
+  return((unsigned long) clockMicros);
+}
+
+
+
+//
+// delaying advances the virtual clock
+//
+void delay(unsigned long ms)
+{
+  hostAdvanceMicros(ms * 1000UL);
+}
+
+
+
+//
+// delaying advances the virtual clock
+//
+void delayMicroseconds(unsigned int us)
+{
+  hostAdvanceMicros(us);
+}
+
+
+
+//
+// pins do nothing on the host
+//
+void pinMode(int pin, int mode) { (void) pin; (void) mode; }
+void digitalWrite(int pin, int value) { (void) pin; (void) value; }
+int digitalRead(int pin) { (void) pin; return(LOW); }
+
+
+
+//
+// convert a long to a string
+//
+char *ltoa(long value, char *str, int base)
+{
+  char digits[34];
+  int i = 0;
+  bool negative = false;
+  unsigned long v;
+
+  if ((base == 10) && (value < 0))
+  {
+    negative = true;
+    v = (unsigned long) -value;
+  }
+  else
+    v = (unsigned long) value;
+
+  do
+  {
+    int d = v % base;
+    digits[i++] = (char) (d < 10 ? '0' + d : 'a' + d - 10);
+    v /= base;
+  } while (v);
+
+  char *p = str;
+  if (negative)
+    *p++ = '-';
+  while (i)
+    *p++ = digits[--i];
+  *p = 0;
+  return(str);
+}
+
+
+
+//
+// convert an int to a string
+//
+char *itoa(int value, char *str, int base)
+{
+  if (base == 10)
+    return(ltoa(value, str, base));
+  return(ltoa((long) (unsigned int) value, str, base));
+}
+
+
+
+//
+// convert a double to a string with the given width and digits right of the decimal point
+//
+char *dtostrf(double value, signed char width, unsigned char precision, char *str)
+{
+  sprintf(str, "%*.*f", width, precision, value);
+  return(str);
+}
+
+
+
+//
+// random numbers
+//
+long random(long howBig)
+{
+  if (howBig == 0)
+    return(0);
+  return(rand() % howBig);
+}
+
+
+
+//
+// random numbers
+//
+long random(long howSmall, long howBig)
+{
+  if (howSmall >= howBig)
+    return(howSmall);
+  return(random(howBig - howSmall) + howSmall);
+}
+
+
+
+//
+// seed the random numbers
+//
+void randomSeed(unsigned long seed)
+{
+  if (seed != 0)
+    srand(seed);
+}
+
+
+
+//
+// re-map a number from one range to another
+//
+long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+  return((x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin);
+}
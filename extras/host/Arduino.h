@@ -0,0 +1,149 @@
+//      ******************************************************************
+//      *                                                                *
+//      *                  Host stand-in for Arduino.h                   *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// This header lets the TouchUserInterfaceForArduino library, and the example
+// sketches, be compiled and run on a Linux workstation.  Only the parts of the
+// Arduino core used by the library and examples are provided.  Time is virtual:
+// it advances only when the program delays, reads the clock, or samples the
+// touch screen, so runs are deterministic.
+//
+
+//
+// This header lets the TouchUserInterfaceForArduino library, and the example 
+// sketches, be compiled and run on a Linux workstation.  Only the parts of the 
+// Arduino core used by the library and examples are provided.  Time is virtual:
+// it advances only when the program delays, reads the clock, or samples the 
+// touch screen, so runs are deterministic.
+//
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#ifndef PROGMEM
+  #define PROGMEM
+#endif
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LED_BUILTIN 25
+
+#define noInterrupts()
+#define interrupts()
+
+//
+// virtual clock
+//
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+//
+// let other tasks run, this only does something when the ESP32's tasks are used 
+// (see FreeRTOS.cpp)
+//
+void yield(void);
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+int digitalRead(int pin);
+
+char *itoa(int value, char *str, int base);
+char *ltoa(long value, char *str, int base);
+char *dtostrf(double value, signed char width, unsigned char precision, char *str);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifdef __cplusplus
+
+#include <stdio.h>
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+template<class T, class L> auto min(const T &a, const L &b) -> decltype((b < a) ? b : a) { return (b < a) ? b : a; }
+template<class T, class L> auto max(const T &a, const L &b) -> decltype((b < a) ? b : a) { return (a < b) ? b : a; }
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+//
+// minimal Print/Stream, output goes to stdout
+//
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) { return(fputc(c, stdout) == EOF ? 0 : 1); }
+    size_t write(const char *s) { size_t n = 0; while (*s) n += write((uint8_t) *s++); return(n); }
+    size_t print(const char *s) { return(write(s)); }
+    size_t print(char c) { return(write((uint8_t) c)); }
+    size_t print(int n) { char b[16]; snprintf(b, sizeof(b), "%d", n); return(write(b)); }
+    size_t print(unsigned int n) { char b[16]; snprintf(b, sizeof(b), "%u", n); return(write(b)); }
+    size_t print(long n) { char b[24]; snprintf(b, sizeof(b), "%ld", n); return(write(b)); }
+    size_t print(unsigned long n) { char b[24]; snprintf(b, sizeof(b), "%lu", n); return(write(b)); }
+    size_t print(double n, int digits = 2) { char b[48]; snprintf(b, sizeof(b), "%.*f", digits, n); return(write(b)); }
+    size_t println(void) { return(write((uint8_t) '\n')); }
+    template<class T> size_t println(T v) { size_t n = print(v); return(n + println()); }
+    size_t println(double v, int digits) { size_t n = print(v, digits); return(n + println()); }
+};
+
+class Stream : public Print
+{
+  public:
+    virtual int available(void) { return(0); }
+    virtual int read(void) { return(-1); }
+};
+
+class HardwareSerial : public Stream
+{
+  public:
+    void begin(unsigned long baud) { (void) baud; }
+    operator bool() { return(true); }
+};
+
+extern HardwareSerial Serial;
+
+#endif
+
+//
+// the ESP32's core includes FreeRTOS
+//
+#if defined(ARDUINO_ARCH_ESP32)
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/task.h"
+  #include "freertos/semphr.h"
+#endif
+
+#endif
@@ -0,0 +1,280 @@
+//      ******************************************************************
+//      *                                                                *
+//      *            Tests of the buttons drawn in a single pass         *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Buttons are drawn by a compositor that builds their face, frame, text, arrow and
+// bars in a small buffer, then sends them through one address window.  While the 
+// render queue is running they're drawn with the LCD functions instead, and both
+// must set the same pixels.  Random buttons, title bars and menus are drawn each 
+// way, some of them clipped, and their pixels and the cursor they leave are 
+// compared.  Buttons wider than the compositor's buffer are drawn a piece of a row
+// at a time, and some of the buttons are that wide.
+//
+// usage: ButtonCompositeTest
+//
+// Build:  extras/host/build_sketch.sh extras/host/ButtonCompositeTest /tmp/ButtonCompositeTest
+//
+
+#include <Arduino.h>
+#include <Adafruit_ILI9341.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <UI_Fonts.h>
+#include "HostSim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+static const int LCD_CS_PIN   = 1;
+static const int LCD_DC_PIN   = 4;
+static const int TOUCH_CS_PIN = 5;
+
+static const int SCREEN_WIDTH = 320;
+static const int SCREEN_HEIGHT = 240;
+static const int DRAW_COUNT = 6000;
+static const int RENDER_QUEUE_SIZE = 8192;
+static const int MENU_ITEMS = 8;
+
+static TouchUserInterfaceForArduino ui;
+static RENDER_COMMAND renderQueueBuffer[RENDER_QUEUE_SIZE];
+static uint16_t compositedPixels[SCREEN_WIDTH * SCREEN_HEIGHT];
+static int failures = 0;
+static int compositedCount = 0;
+
+
+//
+// the fonts and text the buttons are drawn with
+//
+static const byte *fonts[] = {UI_Font_9, UI_Font_10, UI_Font_11_Bold, UI_Font_12_Bold, 
+  UI_Font_13, UI_Font_14_Bold, UI_Font_16_Bold};
+static const int FONT_COUNT = sizeof(fonts) / sizeof(fonts[0]);
+
+static const char *texts[] = {"OK", "Back", "Hello World", "Set the clock now", 
+  "A much longer label that breaks", "Wide", "x", "Two Words", "Exit\tTab"};
+static const int TEXT_COUNT = sizeof(texts) / sizeof(texts[0]);
+
+
+//
+// what's drawn: a button, a title bar with the Back or Menu button, or a menu
+//
+enum DRAW_KIND {DRAW_BUTTON, DRAW_TITLE_BAR_WITH_BACK_BUTTON, DRAW_TITLE_BAR_WITH_MENU_BUTTON, 
+  DRAW_MENU, DRAW_KIND_COUNT};
+
+static const char *drawKindNames[DRAW_KIND_COUNT] = {"button", "title bar with Back button",
+  "title bar with Menu button", "menu"};
+
+static DRAW_KIND drawKind;
+static BUTTON_EXTENDED button;
+static char titleBarText[40];
+static MENU_ITEM menu[MENU_ITEMS + 2];
+
+
+//
+// a random number from min to max
+//
+static int randomBetween(int min, int max)
+{
+  return(min + (int) (drand48() * (max - min + 1)));
+}
+
+static uint16_t randomColor(void)
+{
+  return((uint16_t) randomBetween(0, 0xffff));
+}
+
+
+
+//
+// make something random to draw, with random colors and fonts
+//
+static void makeDrawing(int drawNumber)
+{
+  drawKind = (DRAW_KIND) randomBetween(0, DRAW_KIND_COUNT - 1);
+
+  //
+  // half of the buttons are all on the screen, the rest may be partly off of it
+  //
+  button.labelText = texts[randomBetween(0, TEXT_COUNT - 1)];
+  button.width = (drand48() < 0.25) ? randomBetween(120, SCREEN_WIDTH) : randomBetween(1, 200);
+  button.height = randomBetween(1, 80);
+  if (drand48() < 0.5)
+  {
+    button.centerX = randomBetween(button.width / 2, SCREEN_WIDTH - (button.width + 1) / 2);
+    button.centerY = randomBetween(button.height / 2, SCREEN_HEIGHT - (button.height + 1) / 2);
+  }
+  else
+  {
+    button.centerX = randomBetween(-20, SCREEN_WIDTH + 20);
+    button.centerY = randomBetween(-20, SCREEN_HEIGHT + 20);
+  }
+  button.buttonColor = randomColor();
+  button.buttonSelectedColor = randomColor();
+  button.buttonFrameColor = randomColor();
+  button.buttonTextColor = randomColor();
+  button.buttonFont = fonts[randomBetween(0, FONT_COUNT - 1)];
+
+  snprintf(titleBarText, sizeof(titleBarText), "Title %d", drawNumber);
+  ui.setTitleBarFont(fonts[randomBetween(0, FONT_COUNT - 1)]);
+  ui.setTitleBarColors(randomColor(), randomColor(), randomColor(), randomColor());
+  ui.setMenuColors(randomColor(), randomColor(), randomColor(), randomColor(), randomColor());
+
+  //
+  // a menu with 1 to 4 columns of commands and sub menus, the sub menus have arrows
+  //
+  static void (*const menuColumns[])() = {MENU_COLUMNS_1, MENU_COLUMNS_2, MENU_COLUMNS_3, MENU_COLUMNS_4};
+  int itemCount = randomBetween(1, MENU_ITEMS);
+  menu[0].MenuItemType = MENU_ITEM_TYPE_MAIN_MENU_HEADER;
+  menu[0].MenuItemText = titleBarText;
+  menu[0].MenuItemFunction = menuColumns[randomBetween(0, 3)];
+  menu[0].MenuItemSubMenu = NULL;
+  for (int i = 1; i <= itemCount; i++)
+  {
+    menu[i].MenuItemType = (drand48() < 0.5) ? MENU_ITEM_TYPE_SUB_MENU : MENU_ITEM_TYPE_COMMAND;
+    menu[i].MenuItemText = texts[randomBetween(0, TEXT_COUNT - 1)];
+    menu[i].MenuItemFunction = NULL;
+    menu[i].MenuItemSubMenu = menu;
+  }
+  menu[itemCount + 1].MenuItemType = MENU_ITEM_TYPE_END_OF_MENU;
+  menu[itemCount + 1].MenuItemText = "";
+  menu[itemCount + 1].MenuItemFunction = NULL;
+  menu[itemCount + 1].MenuItemSubMenu = NULL;
+}
+
+
+
+//
+// draw it, starting from a cleared screen, the cursor in the corner and the 
+// default font, counting only what drawing it sends to the display
+//
+static void draw(boolean clipFlg, int clipX, int clipY, int clipWidth, int clipHeight)
+{
+  hostGetDisplay()->fillRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0);
+  hostGetDisplay()->hostResetCounts();
+  ui.lcdSetCursorXY(5, 5);
+  ui.lcdSetFont(UI_Font_13_Bold);
+  if (clipFlg)
+    ui.pushClip(clipX, clipY, clipWidth, clipHeight);
+
+  switch(drawKind)
+  {
+    case DRAW_BUTTON:
+      ui.drawButton(button);
+      break;
+    case DRAW_TITLE_BAR_WITH_BACK_BUTTON:
+      ui.drawTitleBarWithBackButton(titleBarText);
+      break;
+    case DRAW_TITLE_BAR_WITH_MENU_BUTTON:
+      ui.drawTitleBarWithMenuButton(titleBarText);
+      break;
+    case DRAW_MENU:
+      ui.selectAndDrawMenu(menu, true);
+      break;
+    default:
+      break;
+  }
+
+  if (clipFlg)
+    ui.popClip();
+}
+
+
+
+//
+// print what was drawn differently
+//
+static void printFailure(const char *what, boolean clipFlg)
+{
+  failures++;
+  if (failures > 20)
+    return;
+
+  printf("FAILED: %s", drawKindNames[drawKind]);
+  if (drawKind == DRAW_BUTTON)
+    printf(" \"%s\" at (%d, %d) %d x %d", button.labelText, button.centerX, button.centerY, 
+      button.width, button.height);
+  printf("%s: %s\n", clipFlg ? " clipped" : "", what);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                     The tests
+// ---------------------------------------------------------------------------------
+
+//
+// draw something directly, where its buttons are composited, then through the 
+// render queue, where they aren't, and compare them
+//
+static void testDrawing(int drawNumber)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+
+  makeDrawing(drawNumber);
+  boolean clipFlg = (drand48() < 0.25);
+  int clipX = randomBetween(0, SCREEN_WIDTH - 20);
+  int clipY = randomBetween(0, SCREEN_HEIGHT - 20);
+  int clipWidth = randomBetween(0, 200);
+  int clipHeight = randomBetween(0, 150);
+
+  draw(clipFlg, clipX, clipY, clipWidth, clipHeight);
+  if ((drawKind == DRAW_BUTTON) && (display->hostGetCounts().addressWindows == 1))
+    compositedCount++;
+  int compositedCursorX, compositedCursorY;
+  ui.lcdGetCursorXY(&compositedCursorX, &compositedCursorY);
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+      compositedPixels[y * SCREEN_WIDTH + x] = display->hostGetPixel(x, y);
+  }
+
+  ui.startRenderQueue(renderQueueBuffer, RENDER_QUEUE_SIZE);
+  draw(clipFlg, clipX, clipY, clipWidth, clipHeight);
+  ui.renderQueuedCommands();
+  ui.stopRenderQueue();
+  int cursorX, cursorY;
+  ui.lcdGetCursorXY(&cursorX, &cursorY);
+
+  if ((cursorX != compositedCursorX) || (cursorY != compositedCursorY))
+    printFailure("the cursor is left in a different place", clipFlg);
+
+  int differentPixels = 0;
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+    {
+      if (compositedPixels[y * SCREEN_WIDTH + x] != display->hostGetPixel(x, y))
+        differentPixels++;
+    }
+  }
+  if (differentPixels != 0)
+    printFailure("pixels differ from the ones drawn through the render queue", clipFlg);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    Main program
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  (void) argc;
+  (void) argv;
+  srand48(1);
+
+  ui.begin(LCD_CS_PIN, LCD_DC_PIN, TOUCH_CS_PIN, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT, UI_Font_13_Bold);
+
+  for (int i = 0; i < DRAW_COUNT; i++)
+    testDrawing(i);
+
+  if (failures != 0)
+  {
+    printf("%d drawing(s) differ\n", failures);
+    return(1);
+  }
+  printf("all %d random buttons, title bars and menus match (%d buttons composited)\n", 
+    DRAW_COUNT, compositedCount);
+  return(0);
+}
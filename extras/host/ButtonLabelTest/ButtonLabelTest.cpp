@@ -0,0 +1,191 @@
+//      ******************************************************************
+//      *                                                                *
+//      *          Tests of buttons drawn with labels from UI_TEXT()     *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// A button drawn with a label measured by UI_TEXT() must look the same as the
+// button drawn from its string, which is how it's redrawn when it's touched.  Each
+// label is drawn on buttons of many widths, so it fits on one line, wraps at each
+// of its spaces, or doesn't fit, with the font set by lcdSetFont() different from
+// the button's font.  The pixels of the two buttons are compared.
+//
+// usage: ButtonLabelTest
+//
+// Build:  extras/host/build_sketch.sh extras/host/ButtonLabelTest /tmp/ButtonLabelTest
+//
+
+#include <Arduino.h>
+#include <Adafruit_ILI9341.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <UI_Fonts.h>
+#include "HostSim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+static const int LCD_CS_PIN   = 1;
+static const int LCD_DC_PIN   = 4;
+static const int TOUCH_CS_PIN = 5;
+
+static const int SCREEN_WIDTH = 320;
+static const int SCREEN_HEIGHT = 240;
+
+static const int MIN_BUTTON_WIDTH = 30;
+static const int MAX_BUTTON_WIDTH = 200;
+static const int BUTTON_WIDTH_STEP = 7;
+static const int BUTTON_HEIGHT = 60;
+
+static TouchUserInterfaceForArduino ui;
+static uint16_t labelPixels[SCREEN_WIDTH * SCREEN_HEIGHT];
+static int failures = 0;
+
+
+//
+// the labels, measured in the menu font, and in the extended button's font
+//
+static constexpr UI_LABEL menuFontLabels[] = {
+  UI_TEXT("OK", UI_Font_12_Bold),
+  UI_TEXT("Set the Time Now", UI_Font_12_Bold),
+  UI_TEXT("Start the motor", UI_Font_12_Bold),
+  UI_TEXT("A very long label with many words", UI_Font_12_Bold),
+  UI_TEXT("Calibrate", UI_Font_12_Bold)
+};
+
+static constexpr UI_LABEL extendedFontLabels[] = {
+  UI_TEXT("Set the Time Now", UI_Font_15_Bold),
+  UI_TEXT("Stop all of it", UI_Font_15_Bold)
+};
+
+
+//
+// copy the screen, and compare it with a copy
+//
+static void copyScreen(uint16_t *pixels)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+      pixels[y * SCREEN_WIDTH + x] = display->hostGetPixel(x, y);
+  }
+}
+
+static int countDifferentPixels(const uint16_t *pixels)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  int count = 0;
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+    {
+      if (pixels[y * SCREEN_WIDTH + x] != display->hostGetPixel(x, y))
+        count++;
+    }
+  }
+  return(count);
+}
+
+
+
+//
+// draw a BUTTON with its label, then from its string, and compare them
+//  Enter:  label -> the label, measured in the menu font
+//          width = width of the button
+//          currentFont -> font set with lcdSetFont() before each is drawn
+//
+static void checkButton(const UI_LABEL &label, int width, const byte *currentFont)
+{
+  BUTTON button = {label.text, 160, 120, width, BUTTON_HEIGHT};
+
+  ui.lcdClearScreen(LCD_BLACK);
+  ui.lcdSetFont(currentFont);
+  ui.drawButton(button, label);
+  copyScreen(labelPixels);
+
+  ui.lcdClearScreen(LCD_BLACK);
+  ui.lcdSetFont(currentFont);
+  ui.drawButton(button);
+
+  int differentPixels = countDifferentPixels(labelPixels);
+  if (differentPixels != 0)
+  {
+    printf("FAILED: \"%s\" on a BUTTON %d wide, %d pixels differ\n", label.text, width, differentPixels);
+    failures++;
+  }
+}
+
+
+
+//
+// draw a BUTTON_EXTENDED with its label, then from its string, and compare them
+//  Enter:  label -> the label, measured in UI_Font_15_Bold
+//          width = width of the button
+//          currentFont -> font set with lcdSetFont() before each is drawn
+//
+static void checkExtendedButton(const UI_LABEL &label, int width, const byte *currentFont)
+{
+  BUTTON_EXTENDED button = {label.text, 160, 120, width, BUTTON_HEIGHT, 
+    LCD_BLUE, LCD_RED, LCD_WHITE, LCD_YELLOW, UI_Font_15_Bold};
+
+  ui.lcdClearScreen(LCD_BLACK);
+  ui.lcdSetFont(currentFont);
+  ui.drawButton(button, label);
+  copyScreen(labelPixels);
+
+  ui.lcdClearScreen(LCD_BLACK);
+  ui.lcdSetFont(currentFont);
+  ui.drawButton(button);
+
+  int differentPixels = countDifferentPixels(labelPixels);
+  if (differentPixels != 0)
+  {
+    printf("FAILED: \"%s\" on a BUTTON_EXTENDED %d wide, %d pixels differ\n", label.text, width, differentPixels);
+    failures++;
+  }
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    Main program
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  (void) argc;
+  (void) argv;
+  static const byte *currentFonts[] = {UI_Font_12_Bold, UI_Font_14_Bold, UI_Font_9, UI_Font_16_Bold};
+  const int currentFontCount = sizeof(currentFonts) / sizeof(currentFonts[0]);
+  int buttonCount = 0;
+
+  ui.begin(LCD_CS_PIN, LCD_DC_PIN, TOUCH_CS_PIN, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT, UI_Font_13_Bold);
+  ui.setMenuFont(UI_Font_12_Bold);
+
+  for (int f = 0; f < currentFontCount; f++)
+  {
+    for (int width = MIN_BUTTON_WIDTH; width <= MAX_BUTTON_WIDTH; width += BUTTON_WIDTH_STEP)
+    {
+      for (size_t i = 0; i < sizeof(menuFontLabels) / sizeof(menuFontLabels[0]); i++)
+      {
+        checkButton(menuFontLabels[i], width, currentFonts[f]);
+        buttonCount++;
+      }
+      for (size_t i = 0; i < sizeof(extendedFontLabels) / sizeof(extendedFontLabels[0]); i++)
+      {
+        checkExtendedButton(extendedFontLabels[i], width, currentFonts[f]);
+        buttonCount++;
+      }
+    }
+  }
+
+  if (failures != 0)
+  {
+    printf("%d of %d button(s) differ\n", failures, buttonCount);
+    return(1);
+  }
+  printf("all %d buttons drawn from labels match the buttons drawn from strings\n", buttonCount);
+  return(0);
+}
@@ -0,0 +1,615 @@
+//      ******************************************************************
+//      *                                                                *
+//      *                       Tests of the clipping                    *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Draws random shapes of every kind, text and images, each one first with no clip,
+// then inside of random nested clips set with pushClip(), both directly and through
+// the render queue.  Inside of the clip the pixels must be the same as the ones 
+// drawn with no clip, outside of it they must not be changed, and once the clips 
+// are popped drawing the shape again must finish it.  A shape entirely outside of
+// the clip must not send any pixels or address windows to the display.  Some of
+// the clips are nested deeper than CLIP_STACK_DEPTH, where pushClip() returns 
+// false and leaves the clip as it was.
+//
+// usage: ClipTest
+//
+// Build:  extras/host/build_sketch.sh extras/host/ClipTest /tmp/ClipTest
+//
+
+#include <Arduino.h>
+#include <Adafruit_ILI9341.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <UI_Fonts.h>
+#include "HostSim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+static const int LCD_CS_PIN   = 1;
+static const int LCD_DC_PIN   = 4;
+static const int TOUCH_CS_PIN = 5;
+
+static const int SCREEN_WIDTH = 320;
+static const int SCREEN_HEIGHT = 240;
+static const int SHAPE_COUNT = 3000;
+static const int RENDER_QUEUE_SIZE = 256;
+static const int MAX_CLIPS = CLIP_STACK_DEPTH + 2;
+static const int MAX_IMAGE_SIZE = 40;
+static const int MAX_TEXT_LENGTH = 12;
+
+static const uint16_t BACKGROUND_COLOR = 0x1234;
+
+static TouchUserInterfaceForArduino ui;
+static RENDER_COMMAND renderQueueBuffer[RENDER_QUEUE_SIZE];
+static uint16_t unclippedPixels[SCREEN_WIDTH * SCREEN_HEIGHT];
+static uint16_t image[MAX_IMAGE_SIZE * MAX_IMAGE_SIZE];
+static int failures = 0;
+static int clippedOutCount = 0;
+static int tooDeepCount = 0;
+
+
+//
+// a shape: the kinds that draw in a box use x, y, width, height and radius, the 
+// triangles and lines use the points, the circles x, y and radius
+//
+enum SHAPE_KIND {PIXEL, LINE, HORIZONTAL_LINE, VERTICAL_LINE, RECTANGLE, 
+  ROUNDED_RECTANGLE, TRIANGLE, CIRCLE, FILLED_RECTANGLE, FILLED_ROUNDED_RECTANGLE, 
+  FILLED_TRIANGLE, FILLED_CIRCLE, TEXT, IMAGE, SHAPE_KIND_COUNT};
+
+static const char *shapeNames[SHAPE_KIND_COUNT] = {"pixel", "line", "horizontal line",
+  "vertical line", "rectangle", "rounded rectangle", "triangle", "circle", 
+  "filled rectangle", "filled rounded rectangle", "filled triangle", "filled circle",
+  "text", "image"};
+
+typedef struct
+{
+  SHAPE_KIND kind;
+  int x, y, width, height, radius;
+  int x0, y0, x1, y1, x2, y2;
+  uint16_t color;
+  char text[MAX_TEXT_LENGTH + 1];
+  int leftX, topY, rightX, bottomY;         // a box that the shape is inside of
+} SHAPE;
+
+
+//
+// the clips pushed for a shape, and the one they leave in use
+//
+typedef struct
+{
+  int count;
+  int x[MAX_CLIPS], y[MAX_CLIPS], width[MAX_CLIPS], height[MAX_CLIPS];
+  int leftX, topY, rightX, bottomY;
+} CLIPS;
+
+
+//
+// check a condition, printing the line when it fails
+//
+#define CHECK(condition) checkCondition((condition), #condition, __LINE__)
+
+static void checkCondition(bool passedFlg, const char *condition, int line)
+{
+  if (!passedFlg)
+  {
+    printf("FAILED line %d: %s\n", line, condition);
+    failures++;
+  }
+}
+
+
+
+//
+// a random number from min to max
+//
+static int randomBetween(int min, int max)
+{
+  return(min + (int) (drand48() * (max - min + 1)));
+}
+
+
+
+//
+// make a random shape, around the screen and sometimes off it
+//
+static void makeShape(SHAPE &shape)
+{
+  memset(&shape, 0, sizeof(shape));
+  shape.kind = (SHAPE_KIND) randomBetween(0, SHAPE_KIND_COUNT - 1);
+  shape.color = (uint16_t) randomBetween(0, 0xffff);
+  if (shape.color == BACKGROUND_COLOR)
+    shape.color = ~BACKGROUND_COLOR;
+
+  shape.x = randomBetween(-60, SCREEN_WIDTH + 20);
+  shape.y = randomBetween(-60, SCREEN_HEIGHT + 20);
+  shape.width = randomBetween(0, 160);
+  shape.height = randomBetween(0, 120);
+  shape.radius = randomBetween(0, min(shape.width, shape.height) / 2);
+  shape.x0 = randomBetween(-60, SCREEN_WIDTH + 60);
+  shape.y0 = randomBetween(-60, SCREEN_HEIGHT + 60);
+  shape.x1 = shape.x0 + randomBetween(-150, 150);
+  shape.y1 = shape.y0 + randomBetween(-150, 150);
+  shape.x2 = shape.x0 + randomBetween(-150, 150);
+  shape.y2 = shape.y0 + randomBetween(-150, 150);
+
+  shape.leftX = shape.x;
+  shape.topY = shape.y;
+  shape.rightX = shape.x + shape.width - 1;
+  shape.bottomY = shape.y + shape.height - 1;
+
+  switch(shape.kind)
+  {
+    case PIXEL:
+      shape.rightX = shape.x;
+      shape.bottomY = shape.y;
+      break;
+
+    case LINE:
+    case TRIANGLE:
+    case FILLED_TRIANGLE:
+      if (shape.kind == LINE)
+      {
+        shape.x2 = shape.x0;
+        shape.y2 = shape.y0;
+      }
+      shape.leftX = min(shape.x0, min(shape.x1, shape.x2));
+      shape.topY = min(shape.y0, min(shape.y1, shape.y2));
+      shape.rightX = max(shape.x0, max(shape.x1, shape.x2));
+      shape.bottomY = max(shape.y0, max(shape.y1, shape.y2));
+      break;
+
+    case HORIZONTAL_LINE:
+      shape.bottomY = shape.y;
+      break;
+
+    case VERTICAL_LINE:
+      shape.rightX = shape.x;
+      break;
+
+    case CIRCLE:
+    case FILLED_CIRCLE:
+      shape.radius = randomBetween(0, 80);
+      shape.leftX = shape.x - shape.radius;
+      shape.topY = shape.y - shape.radius;
+      shape.rightX = shape.x + shape.radius;
+      shape.bottomY = shape.y + shape.radius;
+      break;
+
+    case TEXT:
+    {
+      int length = randomBetween(1, MAX_TEXT_LENGTH);
+      for (int i = 0; i < length; i++)
+        shape.text[i] = (char) randomBetween(' ', '~');
+      shape.text[length] = 0;
+
+      //
+      // the cursor can't be set off the screen, and a box with a margin around the 
+      // characters
+      //
+      shape.x = randomBetween(0, SCREEN_WIDTH - 1);
+      shape.y = randomBetween(0, SCREEN_HEIGHT - 1);
+      shape.leftX = shape.x - 2;
+      shape.topY = shape.y - 2;
+      shape.rightX = shape.x + ui.lcdStringWidthInPixels(shape.text) + 2;
+      shape.bottomY = shape.y + ui.lcdGetFontHeightWithDecenders() + 2;
+      break;
+    }
+
+    case IMAGE:
+      shape.width = randomBetween(1, MAX_IMAGE_SIZE);
+      shape.height = randomBetween(1, MAX_IMAGE_SIZE);
+      shape.rightX = shape.x + shape.width - 1;
+      shape.bottomY = shape.y + shape.height - 1;
+      for (int i = 0; i < shape.width * shape.height; i++)
+        image[i] = (uint16_t) randomBetween(0, 0xffff);
+      break;
+
+    default:
+      break;
+  }
+}
+
+
+
+//
+// draw a shape with the library's LCD functions
+//
+static void drawShape(const SHAPE &shape)
+{
+  switch(shape.kind)
+  {
+    case PIXEL:
+      ui.lcdDrawPixel(shape.x, shape.y, shape.color);
+      break;
+    case LINE:
+      ui.lcdDrawLine(shape.x0, shape.y0, shape.x1, shape.y1, shape.color);
+      break;
+    case HORIZONTAL_LINE:
+      ui.lcdDrawHorizontalLine(shape.x, shape.y, shape.width, shape.color);
+      break;
+    case VERTICAL_LINE:
+      ui.lcdDrawVerticalLine(shape.x, shape.y, shape.height, shape.color);
+      break;
+    case RECTANGLE:
+      ui.lcdDrawRectangle(shape.x, shape.y, shape.width, shape.height, shape.color);
+      break;
+    case ROUNDED_RECTANGLE:
+      ui.lcdDrawRoundedRectangle(shape.x, shape.y, shape.width, shape.height, shape.radius, shape.color);
+      break;
+    case TRIANGLE:
+      ui.lcdDrawTriangle(shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2, shape.color);
+      break;
+    case CIRCLE:
+      ui.lcdDrawCircle(shape.x, shape.y, shape.radius, shape.color);
+      break;
+    case FILLED_RECTANGLE:
+      ui.lcdDrawFilledRectangle(shape.x, shape.y, shape.width, shape.height, shape.color);
+      break;
+    case FILLED_ROUNDED_RECTANGLE:
+      ui.lcdDrawFilledRoundedRectangle(shape.x, shape.y, shape.width, shape.height, shape.radius, shape.color);
+      break;
+    case FILLED_TRIANGLE:
+      ui.lcdDrawFilledTriangle(shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2, shape.color);
+      break;
+    case FILLED_CIRCLE:
+      ui.lcdDrawFilledCircle(shape.x, shape.y, shape.radius, shape.color);
+      break;
+    case TEXT:
+      ui.lcdSetFontColor(shape.color);
+      ui.lcdSetCursorXY(shape.x, shape.y);
+      ui.lcdPrint(shape.text);
+      break;
+    case IMAGE:
+      ui.lcdDrawImage(shape.x, shape.y, shape.width, shape.height, image);
+      break;
+    default:
+      break;
+  }
+}
+
+
+
+//
+// make random nested clips, each one somewhere around the shape so that it's
+// often partly inside of them, and sometimes more than CLIP_STACK_DEPTH deep
+//
+static void makeClips(CLIPS &clips, const SHAPE &shape)
+{
+  clips.count = (drand48() < 0.05) ? MAX_CLIPS : randomBetween(1, 3);
+  clips.leftX = 0;
+  clips.topY = 0;
+  clips.rightX = SCREEN_WIDTH - 1;
+  clips.bottomY = SCREEN_HEIGHT - 1;
+
+  int centerX = constrain((shape.leftX + shape.rightX) / 2, -20, SCREEN_WIDTH + 20);
+  int centerY = constrain((shape.topY + shape.bottomY) / 2, -20, SCREEN_HEIGHT + 20);
+  for (int i = 0; i < clips.count; i++)
+  {
+    clips.x[i] = centerX + randomBetween(-100, 10);
+    clips.y[i] = centerY + randomBetween(-80, 10);
+    clips.width[i] = randomBetween(0, 200);
+    clips.height[i] = randomBetween(0, 160);
+
+    if (i < CLIP_STACK_DEPTH)
+    {
+      clips.leftX = max(clips.leftX, clips.x[i]);
+      clips.topY = max(clips.topY, clips.y[i]);
+      clips.rightX = min(clips.rightX, clips.x[i] + clips.width[i] - 1);
+      clips.bottomY = min(clips.bottomY, clips.y[i] + clips.height[i] - 1);
+    }
+  }
+}
+
+
+
+//
+// push the clips, checking that only the ones too deep fail
+//
+static void pushClips(const CLIPS &clips)
+{
+  for (int i = 0; i < clips.count; i++)
+  {
+    boolean pushedFlg = ui.pushClip(clips.x[i], clips.y[i], clips.width[i], clips.height[i]);
+    CHECK(pushedFlg == (i < CLIP_STACK_DEPTH));
+  }
+}
+
+static void popClips(const CLIPS &clips)
+{
+  for (int i = 0; i < clips.count; i++)
+    ui.popClip();
+}
+
+
+
+//
+// check that the screen is the same as the unclipped shape inside of the clip, 
+// and the background outside of it
+//  Exit:   number of pixels that are wrong returned
+//
+static int countWrongPixels(const CLIPS &clips)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  int count = 0;
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+    {
+      boolean insideFlg = (x >= clips.leftX) && (x <= clips.rightX) && 
+        (y >= clips.topY) && (y <= clips.bottomY);
+      uint16_t expected = insideFlg ? unclippedPixels[y * SCREEN_WIDTH + x] : BACKGROUND_COLOR;
+      if (display->hostGetPixel(x, y) != expected)
+        count++;
+    }
+  }
+  return(count);
+}
+
+static int countPixelsNotUnclipped(void)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  int count = 0;
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+    {
+      if (display->hostGetPixel(x, y) != unclippedPixels[y * SCREEN_WIDTH + x])
+        count++;
+    }
+  }
+  return(count);
+}
+
+
+
+//
+// count the commands in the render queue's buffer, its unused entries are filled 
+// with NO_COMMAND before it's started
+//
+static const byte NO_COMMAND = 0xff;
+
+static int countQueuedCommands(void)
+{
+  int count = 0;
+  for (int i = 0; i < RENDER_QUEUE_SIZE; i++)
+  {
+    if (renderQueueBuffer[i].opcode != NO_COMMAND)
+      count++;
+  }
+  return(count);
+}
+
+
+
+//
+// print a shape and its clips that were drawn wrong, with what was wrong and how many
+//
+static void printShape(const SHAPE &shape, const CLIPS &clips, const char *what, int count)
+{
+  failures++;
+  if (failures > 20)
+    return;
+
+  printf("FAILED: %s in box (%d, %d)-(%d, %d) clipped to (%d, %d)-(%d, %d) by %d clips, "
+    "%s: %d\n", shapeNames[shape.kind], shape.leftX, shape.topY, 
+    shape.rightX, shape.bottomY, clips.leftX, clips.topY, clips.rightX, clips.bottomY, 
+    clips.count, what, count);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                     The tests
+// ---------------------------------------------------------------------------------
+
+//
+// draw a shape clipped, directly or through the render queue, then check its 
+// pixels, what was sent or queued for a shape that's clipped out, and that drawing
+// it again after the clips are popped isn't clipped
+//
+static void checkClippedShape(const SHAPE &shape, const CLIPS &clips, boolean queuedFlg)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  const char *how = queuedFlg ? "wrong pixels drawn through the render queue" : "wrong pixels drawn directly";
+  boolean clippedOutFlg = (shape.rightX < clips.leftX) || (shape.leftX > clips.rightX) || 
+    (shape.bottomY < clips.topY) || (shape.topY > clips.bottomY);
+
+  ui.lcdClearScreen(BACKGROUND_COLOR);
+  if (queuedFlg)
+  {
+    for (int i = 0; i < RENDER_QUEUE_SIZE; i++)
+      renderQueueBuffer[i].opcode = NO_COMMAND;
+    ui.startRenderQueue(renderQueueBuffer, RENDER_QUEUE_SIZE);
+  }
+  pushClips(clips);
+  int commandsBeforeShape = countQueuedCommands();
+  display->hostResetCounts();
+  drawShape(shape);
+  HOST_SPI_COUNTS counts = display->hostGetCounts();
+  if (queuedFlg && clippedOutFlg && (countQueuedCommands() != commandsBeforeShape))
+    printShape(shape, clips, "commands queued though clipped out", countQueuedCommands() - commandsBeforeShape);
+  popClips(clips);
+  if (queuedFlg)
+  {
+    display->hostResetCounts();
+    ui.renderQueuedCommands();
+    counts = display->hostGetCounts();
+    ui.stopRenderQueue();
+  }
+
+  int wrongPixels = countWrongPixels(clips);
+  if (wrongPixels != 0)
+    printShape(shape, clips, how, wrongPixels);
+
+  //
+  // nothing may be sent for a shape that can't be seen
+  //
+  if (clippedOutFlg && ((counts.pixels != 0) || (counts.addressWindows != 0)))
+    printShape(shape, clips, "pixels sent though clipped out", (int) counts.pixels);
+
+  //
+  // with the clips popped, drawing the shape again fills in the rest of it
+  //
+  drawShape(shape);
+  wrongPixels = countPixelsNotUnclipped();
+  if (wrongPixels != 0)
+    printShape(shape, clips, "wrong pixels drawn again after the clips were popped", wrongPixels);
+}
+
+
+
+//
+// draw a random shape with no clip, then clipped directly and through the render
+// queue
+//
+static void testClippedShape(void)
+{
+  SHAPE shape;
+  CLIPS clips;
+  makeShape(shape);
+  makeClips(clips, shape);
+
+  ui.lcdClearScreen(BACKGROUND_COLOR);
+  drawShape(shape);
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+      unclippedPixels[y * SCREEN_WIDTH + x] = display->hostGetPixel(x, y);
+  }
+
+  checkClippedShape(shape, clips, false);
+  checkClippedShape(shape, clips, true);
+
+  if ((shape.rightX < clips.leftX) || (shape.leftX > clips.rightX) || 
+      (shape.bottomY < clips.topY) || (shape.topY > clips.bottomY))
+    clippedOutCount++;
+  if (clips.count > CLIP_STACK_DEPTH)
+    tooDeepCount++;
+}
+
+
+
+//
+// push clips deeper than CLIP_STACK_DEPTH, then pop them one at a time, filling the
+// screen after each to check that the clip in use is the one pushed before it
+//
+static void testClipStack(boolean queuedFlg)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  int leftX[MAX_CLIPS + 1], topY[MAX_CLIPS + 1], rightX[MAX_CLIPS + 1], bottomY[MAX_CLIPS + 1];
+
+  for (int repeat = 0; repeat < 100; repeat++)
+  {
+    //
+    // each clip is a little inside of the one before it, the ones too deep aren't used
+    //
+    leftX[0] = 0;
+    topY[0] = 0;
+    rightX[0] = SCREEN_WIDTH - 1;
+    bottomY[0] = SCREEN_HEIGHT - 1;
+    if (queuedFlg)
+      ui.startRenderQueue(renderQueueBuffer, RENDER_QUEUE_SIZE);
+    for (int depth = 1; depth <= MAX_CLIPS; depth++)
+    {
+      int x = leftX[depth - 1] + randomBetween(-5, 15);
+      int y = topY[depth - 1] + randomBetween(-5, 10);
+      int width = rightX[depth - 1] - x + 1 - randomBetween(-5, 15);
+      int height = bottomY[depth - 1] - y + 1 - randomBetween(-5, 10);
+      CHECK(ui.pushClip(x, y, width, height) == (depth <= CLIP_STACK_DEPTH));
+
+      leftX[depth] = leftX[depth - 1];
+      topY[depth] = topY[depth - 1];
+      rightX[depth] = rightX[depth - 1];
+      bottomY[depth] = bottomY[depth - 1];
+      if (depth <= CLIP_STACK_DEPTH)
+      {
+        leftX[depth] = max(leftX[depth], x);
+        topY[depth] = max(topY[depth], y);
+        rightX[depth] = min(rightX[depth], x + width - 1);
+        bottomY[depth] = min(bottomY[depth], y + height - 1);
+      }
+    }
+
+    for (int depth = MAX_CLIPS; depth >= 0; depth--)
+    {
+      display->hostResetCounts();
+      ui.lcdDrawFilledRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (uint16_t) depth);
+      if (queuedFlg)
+        ui.renderQueuedCommands();
+      long area = (long) max(rightX[depth] - leftX[depth] + 1, 0) * max(bottomY[depth] - topY[depth] + 1, 0);
+      CHECK((long) display->hostGetCounts().pixels == area);
+      if (depth > 0)
+        ui.popClip();
+    }
+    if (queuedFlg)
+      ui.stopRenderQueue();
+  }
+}
+
+
+
+//
+// a clip with no width or height, or entirely off the screen, draws nothing
+//
+static void testEmptyClips(void)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  ui.lcdClearScreen(BACKGROUND_COLOR);
+
+  CHECK(ui.pushClip(10, 10, 0, 100));
+  display->hostResetCounts();
+  ui.lcdDrawFilledRectangle(0, 0, 320, 240, LCD_WHITE);
+  CHECK(display->hostGetCounts().pixels == 0);
+  ui.popClip();
+
+  CHECK(ui.pushClip(-50, 20, 40, 40));
+  display->hostResetCounts();
+  ui.lcdDrawFilledRectangle(0, 0, 320, 240, LCD_WHITE);
+  CHECK(display->hostGetCounts().pixels == 0);
+  ui.popClip();
+
+  CHECK(display->hostGetPixel(10, 10) == BACKGROUND_COLOR);
+  CHECK(display->hostGetPixel(0, 20) == BACKGROUND_COLOR);
+
+  //
+  // popping more than was pushed leaves no clip
+  //
+  ui.popClip();
+  display->hostResetCounts();
+  ui.lcdDrawFilledRectangle(0, 0, 320, 240, LCD_WHITE);
+  CHECK(display->hostGetCounts().pixels == 320 * 240);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    Main program
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  (void) argc;
+  (void) argv;
+  srand48(1);
+
+  ui.begin(LCD_CS_PIN, LCD_DC_PIN, TOUCH_CS_PIN, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT, UI_Font_13_Bold);
+
+  for (int i = 0; i < SHAPE_COUNT; i++)
+    testClippedShape();
+  testClipStack(false);
+  testClipStack(true);
+  testEmptyClips();
+
+  if (failures != 0)
+  {
+    printf("%d check(s) failed\n", failures);
+    return(1);
+  }
+  printf("all %d random shapes clipped correctly (%d clipped out, %d nested too deep)\n", 
+    SHAPE_COUNT, clippedOutCount, tooDeepCount);
+  return(0);
+}
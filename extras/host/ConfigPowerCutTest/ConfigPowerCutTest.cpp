@@ -0,0 +1,305 @@
+//      ******************************************************************
+//      *                                                                *
+//      *        Tests of losing power while configuration is saved      *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Starts with configuration values saved by a library that didn't have A/B slots,
+// then saves three sets of new values: the first moves them into the slots, and
+// two more follow.  This is repeated with the power cut after each number of
+// EEPROM bytes written, N = 0, 1, 2... up to all of them: every write after the
+// Nth is lost.  The board is then powered up again, and the values it loads must
+// all be from the same save, either the one that was being written or the one
+// before it.
+//
+// The saves are done both by flushConfiguration(), and by getTouchEvents() one
+// byte at a time once the UI is idle.  Each run and each power up is a child
+// process, so the library starts with nothing loaded, the same as after a reset.
+//
+// usage: ConfigPowerCutTest [--verbose]
+//
+// Build:  extras/host/build_sketch.sh extras/host/ConfigPowerCutTest /tmp/ConfigPowerCutTest
+//
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <UI_Fonts.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+
+//
+// the values: VALUE_COUNT ints saved at EEPROM addresses 0, 5, 10..., each save
+// changes all of them
+//
+static const int VALUE_COUNT = 20;
+static const int VALUE_SPACING = 5;
+static const int SAVE_COUNT = 3;
+
+static const int LCD_CS_PIN   = 1;
+static const int LCD_DC_PIN   = 4;
+static const int TOUCH_CS_PIN = 5;
+
+static const int NOT_FROM_ONE_SAVE = 100;
+
+static bool verboseFlg = false;
+
+
+//
+// the value saved at an index by a save, save 0 is the values left by the old library
+//
+static int valueForSave(int save, int index)
+{
+  return(1000 * (save + 1) + 37 * index);
+}
+
+
+
+//
+// the EEPROM left by a library without A/B slots: each value is a marker byte of 0
+// followed by the int's bytes
+//
+static void makeLegacyEEPROM(void)
+{
+  uint8_t *image = EEPROM.hostGetImage();
+  memset(image, 0xff, HOST_EEPROM_SIZE);
+
+  for (int i = 0; i < VALUE_COUNT; i++)
+  {
+    int value = valueForSave(0, i);
+    image[i * VALUE_SPACING] = 0;
+    memcpy(&image[i * VALUE_SPACING + 1], &value, sizeof(value));
+  }
+}
+
+
+
+//
+// write one save's values and save them to the EEPROM
+//  Enter:  ui = the UI, begin() has been called if idleCommitFlg is true
+//          save = which save, 1 to SAVE_COUNT
+//          idleCommitFlg = true to let getTouchEvents() save the values, false
+//            to use flushConfiguration()
+//
+static void saveValues(TouchUserInterfaceForArduino &ui, int save, boolean idleCommitFlg)
+{
+  CONFIGURATION_COMMIT_STATS stats;
+  ui.getConfigurationCommitStats(stats);
+  unsigned long commitCount = stats.commitCount;
+
+  for (int i = 0; i < VALUE_COUNT; i++)
+    ui.writeConfigurationInt(i * VALUE_SPACING, valueForSave(save, i));
+
+  if (!idleCommitFlg)
+  {
+    ui.flushConfiguration();
+    return;
+  }
+
+  while (stats.commitCount == commitCount)
+  {
+    ui.getTouchEvents();
+    ui.getConfigurationCommitStats(stats);
+  }
+}
+
+
+
+//
+// run the saves in a child process with the power cut after a number of writes,
+// returning what's left in the EEPROM
+//  Enter:  writeBudget = number of bytes written before the power is cut, -1 for
+//            no power cut
+//          idleCommitFlg = true to save with getTouchEvents(), false with
+//            flushConfiguration()
+//          image -> storage for the EEPROM left after the saves
+//          writeCounts -> storage for the number of bytes written by the end of
+//            each save, or NULL
+//  Exit:   true returned if the child ran
+//
+static bool runSaves(long writeBudget, bool idleCommitFlg, uint8_t *image, long *writeCounts)
+{
+  int pipeFds[2];
+  if (pipe(pipeFds) != 0)
+    return(false);
+
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    long counts[SAVE_COUNT];
+    TouchUserInterfaceForArduino ui;
+    close(pipeFds[0]);
+    makeLegacyEEPROM();
+    if (idleCommitFlg)
+    {
+      ui.begin(LCD_CS_PIN, LCD_DC_PIN, TOUCH_CS_PIN, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT, UI_Font_13_Bold);
+      ui.setConfigurationCommitDelay(0);
+    }
+    EEPROM.hostSetWriteBudget(writeBudget);
+
+    for (int save = 1; save <= SAVE_COUNT; save++)
+    {
+      saveValues(ui, save, idleCommitFlg);
+      counts[save - 1] = EEPROM.hostGetWriteCount();
+    }
+
+    bool okFlg = (write(pipeFds[1], EEPROM.hostGetImage(), HOST_EEPROM_SIZE) == HOST_EEPROM_SIZE) &&
+                 (write(pipeFds[1], counts, sizeof(counts)) == sizeof(counts));
+    _exit(okFlg ? 0 : 1);
+  }
+
+  close(pipeFds[1]);
+  long counts[SAVE_COUNT];
+  FILE *f = fdopen(pipeFds[0], "rb");
+  bool okFlg = (fread(image, 1, HOST_EEPROM_SIZE, f) == HOST_EEPROM_SIZE) &&
+               (fread(counts, 1, sizeof(counts), f) == sizeof(counts));
+  fclose(f);
+
+  int status;
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+    return(false);
+
+  if (okFlg && (writeCounts != NULL))
+    memcpy(writeCounts, counts, sizeof(counts));
+  return(okFlg);
+}
+
+
+
+//
+// power up with an EEPROM in a child process and find which save the values
+// loaded are from
+//  Enter:  image -> the EEPROM
+//  Exit:   the save (0 for the old library's values), or NOT_FROM_ONE_SAVE if the
+//            values aren't all from the same save
+//
+static int loadedSave(const uint8_t *image)
+{
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    TouchUserInterfaceForArduino ui;
+    memcpy(EEPROM.hostGetImage(), image, HOST_EEPROM_SIZE);
+
+    int first = ui.readConfigurationInt(0, -1);
+    int save;
+    for (save = 0; save <= SAVE_COUNT; save++)
+    {
+      if (first == valueForSave(save, 0))
+        break;
+    }
+    if (save > SAVE_COUNT)
+      _exit(NOT_FROM_ONE_SAVE);
+
+    for (int i = 1; i < VALUE_COUNT; i++)
+    {
+      if (ui.readConfigurationInt(i * VALUE_SPACING, -1) != valueForSave(save, i))
+        _exit(NOT_FROM_ONE_SAVE);
+    }
+    _exit(save);
+  }
+
+  int status;
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status))
+    return(NOT_FROM_ONE_SAVE);
+  return(WEXITSTATUS(status));
+}
+
+
+
+//
+// cut the power after each number of bytes written, checking what's loaded after
+//  Enter:  idleCommitFlg = true to save with getTouchEvents(), false with
+//            flushConfiguration()
+//  Exit:   number of failures returned
+//
+static int testPowerCuts(bool idleCommitFlg)
+{
+  const char *method = idleCommitFlg ? "getTouchEvents()" : "flushConfiguration()";
+  uint8_t image[HOST_EEPROM_SIZE];
+  long writeCounts[SAVE_COUNT];
+  int failures = 0;
+
+  //
+  // without a power cut, find how many bytes each save writes
+  //
+  if (!runSaves(-1, idleCommitFlg, image, writeCounts))
+  {
+    printf("FAILED: saving with %s didn't run\n", method);
+    return(1);
+  }
+  if (loadedSave(image) != SAVE_COUNT)
+  {
+    printf("FAILED: saving with %s, the last save isn't loaded without a power cut\n", method);
+    return(1);
+  }
+
+  long totalWrites = writeCounts[SAVE_COUNT - 1];
+  for (long n = 0; n <= totalWrites; n++)
+  {
+    int completedSaves = 0;
+    while ((completedSaves < SAVE_COUNT) && (writeCounts[completedSaves] <= n))
+      completedSaves++;
+
+    if (!runSaves(n, idleCommitFlg, image, NULL))
+    {
+      printf("FAILED: saving with %s and the power cut after %ld bytes didn't run\n", method, n);
+      failures++;
+      continue;
+    }
+
+    int save = loadedSave(image);
+    if (verboseFlg)
+      printf("%s, power cut after %ld bytes: save %d loaded\n", method, n, save);
+
+    if ((save != completedSaves) && (save != completedSaves + 1))
+    {
+      if (save == NOT_FROM_ONE_SAVE)
+        printf("FAILED: %s, power cut after %ld bytes: the values loaded are from more than one save\n", method, n);
+      else
+        printf("FAILED: %s, power cut after %ld bytes: save %d loaded, expected %d or %d\n",
+          method, n, save, completedSaves, completedSaves + 1);
+      failures++;
+    }
+  }
+
+  printf("%s: %ld power cuts, from 0 bytes to all %ld bytes of %d saves written\n",
+    method, totalWrites + 1, totalWrites, SAVE_COUNT);
+  return(failures);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    Main program
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--verbose") == 0)
+      verboseFlg = true;
+    else
+    {
+      fprintf(stderr, "usage: %s [--verbose]\n", argv[0]);
+      return(2);
+    }
+  }
+
+  int failures = testPowerCuts(false) + testPowerCuts(true);
+  if (failures != 0)
+  {
+    printf("%d power cut(s) failed\n", failures);
+    return(1);
+  }
+  printf("every power cut loaded the values of one whole save\n");
+  return(0);
+}
@@ -0,0 +1,373 @@
+//      ******************************************************************
+//      *                                                                *
+//      *             Tests of the configuration schema functions        *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Saves a struct with a configuration schema, then checks what loadConfiguration()
+// gives back after the board is powered up again: the values loaded in bulk, the
+// defaults when the block has never been saved or one of its bytes is corrupt,
+// defaults for values out of range, and the new fields and migrate function call
+// when the schema's version is bumped.
+//
+// Each power up runs in a child process, so the library starts with nothing
+// loaded, the same as after a reset.  The EEPROM is kept in a file between them.
+//
+// usage: ConfigSchemaTest
+//
+// Build:  extras/host/build_sketch.sh extras/host/ConfigSchemaTest /tmp/ConfigSchemaTest
+//
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+
+//
+// the app's configuration, version 1 of the schema has the first three fields,
+// version 2 adds the last two
+//
+typedef struct
+{
+  int xOffset;
+  float xScaler;
+  byte brightness;
+  short contrast;
+  int anyValue;
+} TEST_CONFIG;
+
+static const CONFIG_FIELD fieldsVersion1[] = {
+  {CONFIG_FIELD_TYPE_INT,   offsetof(TEST_CONFIG, xOffset),    17,    -100,   100,    1},
+  {CONFIG_FIELD_TYPE_FLOAT, offsetof(TEST_CONFIG, xScaler),    11.5,  1.0,    20.0,   1},
+  {CONFIG_FIELD_TYPE_BYTE,  offsetof(TEST_CONFIG, brightness), 80,    0,      100,    1},
+  {CONFIG_FIELD_TYPE_END_OF_FIELDS}
+};
+
+static const CONFIG_FIELD fieldsVersion2[] = {
+  {CONFIG_FIELD_TYPE_INT,   offsetof(TEST_CONFIG, xOffset),    17,    -100,   100,    1},
+  {CONFIG_FIELD_TYPE_FLOAT, offsetof(TEST_CONFIG, xScaler),    11.5,  1.0,    20.0,   1},
+  {CONFIG_FIELD_TYPE_BYTE,  offsetof(TEST_CONFIG, brightness), 80,    0,      100,    1},
+  {CONFIG_FIELD_TYPE_SHORT, offsetof(TEST_CONFIG, contrast),   -3,    -10,    10,     2},
+  {CONFIG_FIELD_TYPE_INT,   offsetof(TEST_CONFIG, anyValue),   1234,  0,      0,      2},
+  {CONFIG_FIELD_TYPE_END_OF_FIELDS}
+};
+
+static const int BLOCK_ADDRESS = 100;
+
+static void migrateToVersion2(byte oldVersion, void *configStruct);
+
+static const CONFIG_SCHEMA schemaVersion1 = {BLOCK_ADDRESS, 1, fieldsVersion1, NULL};
+static const CONFIG_SCHEMA schemaVersion2 = {BLOCK_ADDRESS, 2, fieldsVersion2, migrateToVersion2};
+
+static const char *eepromFile;
+static int migrateCallCount;
+static int migrateOldVersion;
+static int failures = 0;
+
+static const int SLOT_B_ADDRESS = 1024;
+static const int SLOT_HEADERS_ADDRESS = 2048;
+static const int SLOT_HEADERS_SIZE = 12;
+
+
+//
+// check a condition, printing it if it fails
+//
+#define CHECK(condition) checkCondition((condition), #condition, __LINE__)
+
+static void checkCondition(bool passedFlg, const char *condition, int line)
+{
+  if (passedFlg)
+    return;
+  printf("FAILED line %d: %s\n", line, condition);
+  failures++;
+}
+
+
+
+//
+// the migrate function for version 2, it converts the brightness from the old
+// 0 to 50 scale and records that it was called
+//
+static void migrateToVersion2(byte oldVersion, void *configStruct)
+{
+  TEST_CONFIG *config = (TEST_CONFIG*) configStruct;
+  migrateCallCount++;
+  migrateOldVersion = oldVersion;
+  config->brightness = config->brightness * 2;
+}
+
+
+
+//
+// run a test as if the board had just powered up, in a child process so that the
+// library's RAM copy of the EEPROM is loaded from the file
+//  Enter:  test -> the test, it returns the number of failed checks
+//  Exit:   number of failed checks returned
+//
+static int afterPowerUp(int (*test)(TouchUserInterfaceForArduino &ui))
+{
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    TouchUserInterfaceForArduino ui;
+    EEPROM.hostSetFile(eepromFile);
+    failures = 0;
+    int result = test(ui);
+    fflush(stdout);
+    _exit(result);
+  }
+
+  int status;
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status))
+  {
+    printf("FAILED: the test crashed\n");
+    return(1);
+  }
+  return(WEXITSTATUS(status));
+}
+
+
+
+//
+// read or write the EEPROM file directly, the way a board loses power or the
+// EEPROM is left by an older version of the library
+//
+static void readEEPROMFile(uint8_t *image)
+{
+  EEPROM.hostSetFile(eepromFile);
+  memcpy(image, EEPROM.hostGetImage(), HOST_EEPROM_SIZE);
+}
+
+static void writeEEPROMFile(const uint8_t *image)
+{
+  EEPROM.hostSetFile(eepromFile);
+  memcpy(EEPROM.hostGetImage(), image, HOST_EEPROM_SIZE);
+  EEPROM.write(0, image[0]);                // writing a byte saves the file
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    The tests
+// ---------------------------------------------------------------------------------
+
+//
+// an EEPROM that has never been saved gives the defaults, then save version 1
+//
+static int testSaveVersion1(TouchUserInterfaceForArduino &ui)
+{
+  TEST_CONFIG config;
+  memset(&config, 0, sizeof(config));
+
+  CHECK(!ui.loadConfiguration(schemaVersion1, &config));
+  CHECK(config.xOffset == 17);
+  CHECK(config.xScaler == 11.5);
+  CHECK(config.brightness == 80);
+  CHECK(ui.getConfigurationSize(schemaVersion1) == 5 + 4 + 4 + 1);
+
+  config.xOffset = -42;
+  config.xScaler = 3.25;
+  config.brightness = 30;
+  ui.saveConfiguration(schemaVersion1, &config);
+  ui.flushConfiguration();
+  return(failures);
+}
+
+
+
+//
+// the block is loaded in bulk after powering up
+//
+static int testLoadVersion1(TouchUserInterfaceForArduino &ui)
+{
+  TEST_CONFIG config;
+  memset(&config, 0, sizeof(config));
+
+  CHECK(ui.loadConfiguration(schemaVersion1, &config));
+  CHECK(config.xOffset == -42);
+  CHECK(config.xScaler == 3.25);
+  CHECK(config.brightness == 30);
+  return(failures);
+}
+
+
+
+//
+// a block with a bad CRC gives the defaults for every field
+//
+static int testCorruptBlock(TouchUserInterfaceForArduino &ui)
+{
+  TEST_CONFIG config;
+  memset(&config, 0, sizeof(config));
+
+  CHECK(!ui.loadConfiguration(schemaVersion1, &config));
+  CHECK(config.xOffset == 17);
+  CHECK(config.xScaler == 11.5);
+  CHECK(config.brightness == 80);
+  return(failures);
+}
+
+
+
+//
+// loading with version 2 keeps the saved fields, gives the new ones their defaults,
+// calls the migrate function once, and saves the block in the new version
+//
+static int testMigrateToVersion2(TouchUserInterfaceForArduino &ui)
+{
+  TEST_CONFIG config;
+  memset(&config, 0, sizeof(config));
+  migrateCallCount = 0;
+
+  CHECK(ui.loadConfiguration(schemaVersion2, &config));
+  CHECK(migrateCallCount == 1);
+  CHECK(migrateOldVersion == 1);
+  CHECK(config.xOffset == -42);
+  CHECK(config.xScaler == 3.25);
+  CHECK(config.brightness == 60);
+  CHECK(config.contrast == -3);
+  CHECK(config.anyValue == 1234);
+  ui.flushConfiguration();
+  return(failures);
+}
+
+
+
+//
+// after the migration the block is version 2, it loads without migrating again
+//
+static int testLoadVersion2(TouchUserInterfaceForArduino &ui)
+{
+  TEST_CONFIG config;
+  memset(&config, 0, sizeof(config));
+  migrateCallCount = 0;
+
+  CHECK(ui.loadConfiguration(schemaVersion2, &config));
+  CHECK(migrateCallCount == 0);
+  CHECK(config.xOffset == -42);
+  CHECK(config.brightness == 60);
+  CHECK(config.contrast == -3);
+  CHECK(config.anyValue == 1234);
+
+  //
+  // a block saved by a newer version isn't loaded
+  //
+  memset(&config, 0, sizeof(config));
+  CHECK(!ui.loadConfiguration(schemaVersion1, &config));
+  CHECK(config.xOffset == 17);
+  return(failures);
+}
+
+
+
+//
+// save values outside of their ranges
+//
+static int testSaveOutOfRange(TouchUserInterfaceForArduino &ui)
+{
+  TEST_CONFIG config;
+  CHECK(ui.loadConfiguration(schemaVersion2, &config));
+
+  config.xOffset = 500;
+  config.xScaler = 0.5;
+  config.brightness = 101;
+  config.contrast = 7;
+  config.anyValue = -99999;
+  ui.saveConfiguration(schemaVersion2, &config);
+  ui.flushConfiguration();
+  return(failures);
+}
+
+
+
+//
+// values out of range are replaced by their defaults, the others are kept, and a
+// field with no range keeps any value
+//
+static int testLoadOutOfRange(TouchUserInterfaceForArduino &ui)
+{
+  TEST_CONFIG config;
+  memset(&config, 0, sizeof(config));
+  migrateCallCount = 0;
+
+  CHECK(ui.loadConfiguration(schemaVersion2, &config));
+  CHECK(migrateCallCount == 0);
+  CHECK(config.xOffset == 17);
+  CHECK(config.xScaler == 11.5);
+  CHECK(config.brightness == 80);
+  CHECK(config.contrast == 7);
+  CHECK(config.anyValue == -99999);
+  return(failures);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    Main program
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  (void) argc;
+  (void) argv;
+  uint8_t image[HOST_EEPROM_SIZE];
+  char fileName[] = "/tmp/ConfigSchemaTest-XXXXXX";
+
+  int fd = mkstemp(fileName);
+  if (fd < 0)
+  {
+    printf("can't create a temporary file\n");
+    return(2);
+  }
+  close(fd);
+  unlink(fileName);
+  eepromFile = fileName;
+
+  int failed = 0;
+  failed += afterPowerUp(testSaveVersion1);
+  failed += afterPowerUp(testLoadVersion1);
+
+  //
+  // move the block to where a library without A/B slots saved it, so the schema's
+  // own CRC is what finds the corruption below
+  //
+  readEEPROMFile(image);
+  memcpy(image, image + SLOT_B_ADDRESS, SLOT_B_ADDRESS);
+  memset(image + SLOT_B_ADDRESS, 0xff, SLOT_B_ADDRESS);
+  memset(image + SLOT_HEADERS_ADDRESS, 0xff, SLOT_HEADERS_SIZE);
+  writeEEPROMFile(image);
+  failed += afterPowerUp(testLoadVersion1);
+
+  //
+  // corrupt one byte of the block's data, then put it back
+  //
+  uint8_t goodImage[HOST_EEPROM_SIZE];
+  memcpy(goodImage, image, HOST_EEPROM_SIZE);
+  image[BLOCK_ADDRESS + 5 + 4] ^= 0x01;
+  writeEEPROMFile(image);
+  failed += afterPowerUp(testCorruptBlock);
+  writeEEPROMFile(goodImage);
+
+  failed += afterPowerUp(testMigrateToVersion2);
+  failed += afterPowerUp(testLoadVersion2);
+  failed += afterPowerUp(testSaveOutOfRange);
+  failed += afterPowerUp(testLoadOutOfRange);
+
+  unlink(fileName);
+
+  if (failed != 0)
+  {
+    printf("%d check(s) failed\n", failed);
+    return(1);
+  }
+  printf("all configuration schema checks passed\n");
+  return(0);
+}
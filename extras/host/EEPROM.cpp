@@ -0,0 +1,108 @@
+//      ******************************************************************
+//      *                                                                *
+//      *                   Host stand-in for EEPROM.h                   *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+#include "EEPROM.h"
+#include "HostSim.h"
+#include <stdio.h>
+
+EEPROMClass EEPROM;
+
+
+//
+// constructor, the EEPROM starts erased
+//
+EEPROMClass::EEPROMClass(void)
+{
+  memset(image, 0xff, sizeof(image));
+  backingFile = NULL;
+  writeMicros = 0;
+  writeBudget = -1;
+  writeCount = 0;
+}
+
+
+
+//
+// use a file to hold the EEPROM's contents between runs, a missing file is an
+// erased EEPROM
+//
+void EEPROMClass::hostSetFile(const char *fileName)
+{
+  backingFile = fileName;
+  memset(image, 0xff, sizeof(image));
+
+  FILE *f = fopen(fileName, "rb");
+  if (f != NULL)
+  {
+    size_t n = fread(image, 1, sizeof(image), f);
+    (void) n;
+    fclose(f);
+  }
+}
+
+
+
+//
+// erase the EEPROM (all bytes 0xff)
+//
+void EEPROMClass::hostErase(void)
+{
+  memset(image, 0xff, sizeof(image));
+  save();
+}
+
+
+
+//
+// read a byte
+//
+uint8_t EEPROMClass::read(int address)
+{
+  if ((address < 0) || (address >= HOST_EEPROM_SIZE))
+    return(0xff);
+  return(image[address]);
+}
+
+
+
+//
+// write a byte, when the write budget runs out the "power is cut": later 
+// writes are lost
+//
+void EEPROMClass::write(int address, uint8_t value)
+{
+  if ((address < 0) || (address >= HOST_EEPROM_SIZE))
+    return;
+
+  if (writeBudget == 0)
+    return;
+  if (writeBudget > 0)
+    writeBudget--;
+
+  image[address] = value;
+  writeCount++;
+  hostAdvanceMicros(writeMicros);
+  save();
+}
+
+
+
+//
+// copy the EEPROM to its backing file
+//
+void EEPROMClass::save(void)
+{
+  if (backingFile == NULL)
+    return;
+
+  FILE *f = fopen(backingFile, "wb");
+  if (f == NULL)
+    return;
+  fwrite(image, 1, sizeof(image), f);
+  fclose(f);
+}
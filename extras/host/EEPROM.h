@@ -0,0 +1,54 @@
+//      ******************************************************************
+//      *                                                                *
+//      *                   Host stand-in for EEPROM.h                   *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// A byte addressed EEPROM held in memory and optionally backed by a file.
+// Writes can be given a simulated write time, and a write budget that simulates
+// losing power: once the budget is used up later writes are lost.
+//
+
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include <Arduino.h>
+
+const int HOST_EEPROM_SIZE = 4096;
+
+class EEPROMClass
+{
+  public:
+    EEPROMClass(void);
+    void begin(int size) { (void) size; }
+    bool commit(void) { return(true); }
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    void update(int address, uint8_t value) { if (read(address) != value) write(address, value); }
+    int length(void) { return(HOST_EEPROM_SIZE); }
+
+    //
+    // host only: backing file, simulated write time and power cuts
+    //
+    void hostSetFile(const char *fileName);
+    void hostErase(void);
+    void hostSetWriteMicros(unsigned long us) { writeMicros = us; }
+    void hostSetWriteBudget(long writes) { writeBudget = writes; }
+    long hostGetWriteCount(void) { return(writeCount); }
+    uint8_t *hostGetImage(void) { return(image); }
+
+  private:
+    uint8_t image[HOST_EEPROM_SIZE];
+    const char *backingFile;
+    unsigned long writeMicros;
+    long writeBudget;
+    long writeCount;
+    void save(void);
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,279 @@
+//      ******************************************************************
+//      *                                                                *
+//      *          Tests of the filled circles, rounded rectangles       *
+//      *                         and triangles                          *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// The library fills circles, rounded rectangles and triangles with its own merged
+// rectangles rather than Adafruit's fillCircle(), fillRoundRect() and 
+// fillTriangle(), and they must set exactly the same pixels.  Random shapes of 
+// each kind are drawn by the library, both directly and through the render queue, 
+// then by Adafruit's function, and the pixels are compared.  They include shapes 
+// partly off the screen, radii too big for the library's rasterizer, flat and 
+// narrow triangles, and empty shapes.
+//
+// usage: FilledShapeTest
+//
+// Build:  extras/host/build_sketch.sh extras/host/FilledShapeTest /tmp/FilledShapeTest
+//
+
+#include <Arduino.h>
+#include <Adafruit_ILI9341.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <UI_Fonts.h>
+#include "HostSim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+static const int LCD_CS_PIN   = 1;
+static const int LCD_DC_PIN   = 4;
+static const int TOUCH_CS_PIN = 5;
+
+static const int SCREEN_WIDTH = 320;
+static const int SCREEN_HEIGHT = 240;
+static const int SHAPES_OF_EACH_KIND = 2000;
+static const int RENDER_QUEUE_SIZE = 16;
+
+static const uint16_t BACKGROUND_COLOR = 0x1234;
+
+static TouchUserInterfaceForArduino ui;
+static RENDER_COMMAND renderQueueBuffer[RENDER_QUEUE_SIZE];
+static uint16_t screenPixels[SCREEN_WIDTH * SCREEN_HEIGHT];
+static int failures = 0;
+
+
+//
+// a shape: FILLED_CIRCLE uses x, y and radius, FILLED_ROUNDED_RECTANGLE uses x, y, 
+// width, height and radius, FILLED_TRIANGLE uses the three points
+//
+enum SHAPE_KIND {FILLED_CIRCLE, FILLED_ROUNDED_RECTANGLE, FILLED_TRIANGLE};
+
+typedef struct
+{
+  SHAPE_KIND kind;
+  int x, y, width, height, radius;
+  int x0, y0, x1, y1, x2, y2;
+  uint16_t color;
+} SHAPE;
+
+
+//
+// a random number from min to max
+//
+static int randomBetween(int min, int max)
+{
+  return(min + (int) (drand48() * (max - min + 1)));
+}
+
+
+
+//
+// make a random shape, around the screen and sometimes partly off it
+//
+static void makeShape(SHAPE &shape, SHAPE_KIND kind)
+{
+  memset(&shape, 0, sizeof(shape));
+  shape.kind = kind;
+  shape.color = (uint16_t) randomBetween(0, 0xffff);
+  if (shape.color == BACKGROUND_COLOR)
+    shape.color = ~BACKGROUND_COLOR;
+
+  switch(kind)
+  {
+    case FILLED_CIRCLE:
+      shape.x = randomBetween(-60, SCREEN_WIDTH + 60);
+      shape.y = randomBetween(-60, SCREEN_HEIGHT + 60);
+      shape.radius = (drand48() < 0.9) ? randomBetween(0, 90) : randomBetween(150, 200);
+      break;
+
+    case FILLED_ROUNDED_RECTANGLE:
+      shape.x = randomBetween(-100, SCREEN_WIDTH);
+      shape.y = randomBetween(-100, SCREEN_HEIGHT);
+      shape.width = randomBetween(0, 250);
+      shape.height = randomBetween(0, 200);
+      shape.radius = randomBetween(0, min(shape.width, shape.height) / 2);
+      if (drand48() < 0.05)
+        shape.radius = randomBetween(0, 200);
+      break;
+
+    case FILLED_TRIANGLE:
+    {
+      //
+      // a third are narrow, the library draws these in columns
+      //
+      int spanX = (drand48() < 0.33) ? 64 : SCREEN_WIDTH + 100;
+      int leftX = randomBetween(-50, SCREEN_WIDTH + 50 - spanX / 2);
+      shape.x0 = leftX + randomBetween(0, spanX);
+      shape.x1 = leftX + randomBetween(0, spanX);
+      shape.x2 = leftX + randomBetween(0, spanX);
+      shape.y0 = randomBetween(-50, SCREEN_HEIGHT + 50);
+      shape.y1 = randomBetween(-50, SCREEN_HEIGHT + 50);
+      shape.y2 = randomBetween(-50, SCREEN_HEIGHT + 50);
+      if (drand48() < 0.05)
+        shape.y1 = shape.y2 = shape.y0;
+      break;
+    }
+  }
+}
+
+
+
+//
+// draw a shape with the library, or with Adafruit's function
+//
+static void drawShapeWithLibrary(const SHAPE &shape)
+{
+  switch(shape.kind)
+  {
+    case FILLED_CIRCLE:
+      ui.lcdDrawFilledCircle(shape.x, shape.y, shape.radius, shape.color);
+      break;
+    case FILLED_ROUNDED_RECTANGLE:
+      ui.lcdDrawFilledRoundedRectangle(shape.x, shape.y, shape.width, shape.height, shape.radius, shape.color);
+      break;
+    case FILLED_TRIANGLE:
+      ui.lcdDrawFilledTriangle(shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2, shape.color);
+      break;
+  }
+}
+
+static void drawShapeWithAdafruit(const SHAPE &shape)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  switch(shape.kind)
+  {
+    case FILLED_CIRCLE:
+      display->fillCircle(shape.x, shape.y, shape.radius, shape.color);
+      break;
+    case FILLED_ROUNDED_RECTANGLE:
+      display->fillRoundRect(shape.x, shape.y, shape.width, shape.height, shape.radius, shape.color);
+      break;
+    case FILLED_TRIANGLE:
+      display->fillTriangle(shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2, shape.color);
+      break;
+  }
+}
+
+
+
+//
+// copy the screen, and count the pixels that differ from a copy
+//
+static void copyScreen(uint16_t *pixels)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+      pixels[y * SCREEN_WIDTH + x] = display->hostGetPixel(x, y);
+  }
+}
+
+static int countDifferentPixels(const uint16_t *pixels)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  int count = 0;
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+    {
+      if (pixels[y * SCREEN_WIDTH + x] != display->hostGetPixel(x, y))
+        count++;
+    }
+  }
+  return(count);
+}
+
+
+
+//
+// print a shape that was drawn wrong
+//
+static void printShape(const SHAPE &shape, const char *how, int differentPixels)
+{
+  failures++;
+  if (failures > 20)
+    return;
+
+  switch(shape.kind)
+  {
+    case FILLED_CIRCLE:
+      printf("FAILED: filled circle (%d, %d) radius %d", shape.x, shape.y, shape.radius);
+      break;
+    case FILLED_ROUNDED_RECTANGLE:
+      printf("FAILED: filled rounded rectangle (%d, %d) %d x %d radius %d", 
+        shape.x, shape.y, shape.width, shape.height, shape.radius);
+      break;
+    case FILLED_TRIANGLE:
+      printf("FAILED: filled triangle (%d, %d) (%d, %d) (%d, %d)", 
+        shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2);
+      break;
+  }
+  printf(" drawn %s, %d pixels differ from Adafruit's\n", how, differentPixels);
+}
+
+
+
+//
+// draw a shape with Adafruit's function, then with the library directly and 
+// through the render queue, comparing each with Adafruit's pixels
+//
+static void checkShape(const SHAPE &shape)
+{
+  ui.lcdClearScreen(BACKGROUND_COLOR);
+  drawShapeWithAdafruit(shape);
+  copyScreen(screenPixels);
+
+  ui.lcdClearScreen(BACKGROUND_COLOR);
+  drawShapeWithLibrary(shape);
+  int differentPixels = countDifferentPixels(screenPixels);
+  if (differentPixels != 0)
+    printShape(shape, "directly", differentPixels);
+
+  ui.lcdClearScreen(BACKGROUND_COLOR);
+  ui.startRenderQueue(renderQueueBuffer, RENDER_QUEUE_SIZE);
+  drawShapeWithLibrary(shape);
+  ui.renderQueuedCommands();
+  ui.stopRenderQueue();
+  differentPixels = countDifferentPixels(screenPixels);
+  if (differentPixels != 0)
+    printShape(shape, "through the render queue", differentPixels);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    Main program
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  (void) argc;
+  (void) argv;
+  SHAPE shape;
+  srand48(1);
+
+  ui.begin(LCD_CS_PIN, LCD_DC_PIN, TOUCH_CS_PIN, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT, UI_Font_13_Bold);
+
+  for (int i = 0; i < SHAPES_OF_EACH_KIND; i++)
+  {
+    makeShape(shape, FILLED_CIRCLE);
+    checkShape(shape);
+    makeShape(shape, FILLED_ROUNDED_RECTANGLE);
+    checkShape(shape);
+    makeShape(shape, FILLED_TRIANGLE);
+    checkShape(shape);
+  }
+
+  if (failures != 0)
+  {
+    printf("%d shape(s) drawn wrong\n", failures);
+    return(1);
+  }
+  printf("all %d random filled shapes match Adafruit's pixels\n", SHAPES_OF_EACH_KIND * 3);
+  return(0);
+}
@@ -0,0 +1,211 @@
+//      ******************************************************************
+//      *                                                                *
+//      *               Tests of the number format functions             *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Compares uiFormatInt(), uiFormatFixed() and uiFormatFloat() with printf() on 
+// random numbers of every size, and on the edge cases: 0, the largest and 
+// smallest longs, NaN, infinity, and floats at the "ovf" limit.
+//
+// uiFormatFloat() rounds halves away from zero, printf() rounds a number that's
+// exactly half way to the even digit.  For those numbers, uiFormatFloat() must
+// match printf() of the next number further from zero.
+//
+// usage: FormatTest
+//
+// Build:  extras/host/build_sketch.sh extras/host/FormatTest /tmp/FormatTest
+//
+
+#include <Arduino.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+static const int RANDOM_NUMBER_COUNT = 200000;
+static const int TEXT_LENGTH = 64;
+
+static int failures = 0;
+
+
+//
+// compare the text from a format function with the text expected, printing it if
+// it differs
+//
+static void checkText(const char *function, const char *text, const char *expectedText, int length)
+{
+  if ((strcmp(text, expectedText) == 0) && (length == (int) strlen(text)))
+    return;
+
+  if (failures < 20)
+    printf("FAILED: %s gave \"%s\" (length %d), expected \"%s\"\n", function, text, length, expectedText);
+  failures++;
+}
+
+
+
+//
+// check if a float is exactly half way between two numbers with the given digits
+//
+static bool isHalfWay(double n, int digitsRightOfDecimal)
+{
+  char text[400];
+  snprintf(text, sizeof(text), "%.350f", fabs(n));
+  const char *digit = strchr(text, '.') + 1 + digitsRightOfDecimal;
+  if (*digit != '5')
+    return(false);
+  for (digit++; *digit != 0; digit++)
+  {
+    if (*digit != '0')
+      return(false);
+  }
+  return(true);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    The tests
+// ---------------------------------------------------------------------------------
+
+//
+// format an int and compare it with printf()
+//
+static void testInt(long n)
+{
+  char text[TEXT_LENGTH];
+  char expectedText[TEXT_LENGTH];
+
+  int length = uiFormatInt(text, n);
+  snprintf(expectedText, sizeof(expectedText), "%ld", n);
+  checkText("uiFormatInt()", text, expectedText, length);
+}
+
+
+
+//
+// format a fixed point number and compare it with printf() of its integer and
+// fraction parts
+//
+static void testFixed(long scaledValue, int digitsRightOfDecimal)
+{
+  char text[TEXT_LENGTH];
+  char expectedText[TEXT_LENGTH];
+
+  unsigned long magnitude = (scaledValue < 0) ? 0UL - (unsigned long) scaledValue : (unsigned long) scaledValue;
+  unsigned long scale = 1;
+  for (int i = 0; i < digitsRightOfDecimal; i++)
+    scale *= 10;
+
+  if (digitsRightOfDecimal == 0)
+    snprintf(expectedText, sizeof(expectedText), "%s%lu", (scaledValue < 0) ? "-" : "", magnitude);
+  else
+    snprintf(expectedText, sizeof(expectedText), "%s%lu.%0*lu", (scaledValue < 0) ? "-" : "", 
+      magnitude / scale, digitsRightOfDecimal, magnitude % scale);
+
+  int length = uiFormatFixed(text, scaledValue, digitsRightOfDecimal);
+  checkText("uiFormatFixed()", text, expectedText, length);
+}
+
+
+
+//
+// format a float and compare it with printf()
+//
+static void testFloat(double n, int digitsRightOfDecimal)
+{
+  char text[TEXT_LENGTH];
+  char expectedText[TEXT_LENGTH];
+
+  double expectedN = n;
+  if (isHalfWay(n, digitsRightOfDecimal))
+    expectedN = nextafter(n, (n < 0) ? -INFINITY : INFINITY);
+  snprintf(expectedText, sizeof(expectedText), "%.*f", digitsRightOfDecimal, expectedN);
+
+  int length = uiFormatFloat(text, n, digitsRightOfDecimal);
+  checkText("uiFormatFloat()", text, expectedText, length);
+}
+
+
+
+//
+// format a float that isn't compared with printf()
+//
+static void testFloatText(double n, int digitsRightOfDecimal, const char *expectedText)
+{
+  char text[TEXT_LENGTH];
+
+  int length = uiFormatFloat(text, n, digitsRightOfDecimal);
+  checkText("uiFormatFloat()", text, expectedText, length);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    Main program
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  (void) argc;
+  (void) argv;
+  srand48(1);
+
+  //
+  // the edge cases
+  //
+  testInt(0);
+  testInt(-1);
+  testInt(LONG_MAX);
+  testInt(LONG_MIN);
+  testFixed(0, 3);
+  testFixed(-5, 2);
+  testFixed(LONG_MIN, 9);
+  testFixed(LONG_MAX, UI_NUMBER_MAX_DIGITS_RIGHT_OF_DECIMAL);
+  testFloat(0.0, 0);
+  testFloat(0.5, 0);
+  testFloat(-2.5, 0);
+  testFloat(0.125, 2);
+  testFloat(0.9999999, 4);
+  testFloat(-9.9999999999, 9);
+  testFloat(4294967040.0, 2);
+  testFloat(-4294967040.0, 0);
+  testFloatText(4294967041.0, 2, "ovf");
+  testFloatText(-1e10, 2, "ovf");
+  testFloatText(NAN, 2, "nan");
+  testFloatText(INFINITY, 2, "inf");
+  testFloatText(-INFINITY, 2, "-inf");
+  testFloatText(1.25, 12, "1.250000000");
+
+  //
+  // random numbers from 10^-6 to the "ovf" limit, with every number of digits
+  //
+  for (int i = 0; i < RANDOM_NUMBER_COUNT; i++)
+  {
+    int digitsRightOfDecimal = i % (UI_NUMBER_MAX_DIGITS_RIGHT_OF_DECIMAL + 1);
+    double n = pow(10.0, drand48() * 15.6 - 6.0);
+    if (n > 4294967040.0)
+      n = drand48() * 4294967040.0;
+    if (i & 1)
+      n = -n;
+    testFloat(n, digitsRightOfDecimal);
+
+    long scaledValue = (long) (mrand48() >> (i % 32));
+    if (i & 2)
+      scaledValue = scaledValue * 65536L + (long) (drand48() * 65536.0);
+    testInt(scaledValue);
+    testFixed(scaledValue, digitsRightOfDecimal);
+  }
+
+  if (failures != 0)
+  {
+    printf("%d number(s) formatted wrong\n", failures);
+    return(1);
+  }
+  printf("%d random numbers and the edge cases formatted the same as printf()\n", RANDOM_NUMBER_COUNT);
+  return(0);
+}
@@ -0,0 +1,256 @@
+//      ******************************************************************
+//      *                                                                *
+//      *                 Host stand-in for ESP32's FreeRTOS             *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Tasks, vTaskDelay() and recursive mutexes, for building the library's ESP32 code
+// on the host.  Each task is a thread, but they take turns like tasks sharing one
+// core: only one runs at a time, and it hands the processor to the next one when
+// it calls yield() or vTaskDelay(), or waits for a mutex another task holds.  The 
+// main program is the first task.  Runs stay deterministic, and a task that spins
+// without yielding hangs the program, the same as it starves the other tasks on 
+// its core on the ESP32.
+//
+// With no tasks started, yield() returns right away, so programs that don't use 
+// the ESP32 code run the same as without this.
+//
+// To check that tasks drawing at the same time don't garble the display, a program
+// can have the tasks switched in the middle of drawing too, after every so many 
+// address windows and pixels (see hostSetTaskSwitchInterval()).
+//
+
+#include "Arduino.h"
+#include "HostSim.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <pthread.h>
+
+
+struct HOST_TASK
+{
+  TaskFunction_t taskFunction;
+  void *parameter;
+  pthread_t thread;
+};
+
+struct HOST_SEMAPHORE
+{
+  int ownerTask;                            // task holding the mutex, -1 if none
+  int takeCount;                            // takes not yet given back
+};
+
+const int HOST_MAX_TASKS = 8;
+
+static HOST_TASK tasks[HOST_MAX_TASKS];     // [0] is the main program
+static int taskCount = 1;
+static int runningTask = 0;
+static thread_local int thisTask = 0;
+
+static pthread_mutex_t schedulerMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t schedulerTurn = PTHREAD_COND_INITIALIZER;
+
+static int taskSwitchInterval = 0;
+static int displayWritesSinceSwitch = 0;
+
+
+//
+// wait until it's this task's turn, the scheduler mutex must be held
+//
+static void waitForTurn(void)
+{
+  while (runningTask != thisTask)
+    pthread_cond_wait(&schedulerTurn, &schedulerMutex);
+}
+
+
+
+//
+// hand the processor to the next task, returning when it's this task's turn again
+//
+static void switchTask(void)
+{
+  if (taskCount == 1)
+    return;
+
+  pthread_mutex_lock(&schedulerMutex);
+  runningTask = (runningTask + 1) % taskCount;
+  pthread_cond_broadcast(&schedulerTurn);
+  waitForTurn();
+  pthread_mutex_unlock(&schedulerMutex);
+}
+
+
+
+//
+// a task's thread, it waits for its first turn then runs the task function
+//
+static void *runTask(void *parameter)
+{
+  HOST_TASK *task = (HOST_TASK *) parameter;
+
+  pthread_mutex_lock(&schedulerMutex);
+  thisTask = (int) (task - tasks);
+  waitForTurn();
+  pthread_mutex_unlock(&schedulerMutex);
+
+  task->taskFunction(task->parameter);
+
+  //
+  // a FreeRTOS task must not return, one that does just gives up its turns
+  //
+  while(true)
+    switchTask();
+  return(NULL);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                       Tasks
+// ---------------------------------------------------------------------------------
+
+//
+// let the other tasks run
+//
+void yield(void)
+{
+  switchTask();
+}
+
+
+
+//
+// start a task, it first runs when the task starting it yields, the core and 
+// priority aren't used
+//
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t taskFunction, const char *name, uint32_t stackDepth, 
+  void *parameter, UBaseType_t priority, TaskHandle_t *createdTask, BaseType_t coreID)
+{
+  (void) name;
+  (void) stackDepth;
+  (void) priority;
+  (void) coreID;
+
+  if (taskCount >= HOST_MAX_TASKS)
+    return(pdFAIL);
+
+  HOST_TASK *task = &tasks[taskCount];
+  task->taskFunction = taskFunction;
+  task->parameter = parameter;
+
+  pthread_mutex_lock(&schedulerMutex);
+  taskCount++;
+  pthread_create(&task->thread, NULL, runTask, task);
+  pthread_detach(task->thread);
+  pthread_mutex_unlock(&schedulerMutex);
+
+  if (createdTask != NULL)
+    *createdTask = task;
+  return(pdPASS);
+}
+
+
+
+//
+// sleep for a number of 1ms ticks on the virtual clock, letting the other tasks run
+//
+void vTaskDelay(TickType_t ticks)
+{
+  hostAdvanceMicros((unsigned long) ticks * 1000UL * portTICK_PERIOD_MS);
+  switchTask();
+}
+
+
+//
+// switch tasks after every so many address windows and pixels sent to the display,
+// as if they were preempted
+//  Enter:  displayWrites = address windows and pixels between switches, 0 to only
+//            switch when a task yields
+//
+void hostSetTaskSwitchInterval(int displayWrites)
+{
+  taskSwitchInterval = displayWrites;
+  displayWritesSinceSwitch = 0;
+}
+
+
+
+//
+// count an address window or pixel sent to the display, switching tasks when it's
+// time to
+//
+void hostCountDisplayWrite(void)
+{
+  if (taskSwitchInterval <= 0)
+    return;
+
+  displayWritesSinceSwitch++;
+  if (displayWritesSinceSwitch >= taskSwitchInterval)
+  {
+    displayWritesSinceSwitch = 0;
+    switchTask();
+  }
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                 Recursive mutexes
+// ---------------------------------------------------------------------------------
+
+//
+// make a recursive mutex, the task holding it can take it again
+//
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+  HOST_SEMAPHORE *mutex = new HOST_SEMAPHORE;
+  mutex->ownerTask = -1;
+  mutex->takeCount = 0;
+  return(mutex);
+}
+
+
+
+//
+// take a recursive mutex, letting the other tasks run while another one holds it
+//  Enter:  ticksToWait = most ticks to wait, portMAX_DELAY to wait forever
+//  Exit:   pdTRUE returned if it was taken
+//
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticksToWait)
+{
+  TickType_t waited = 0;
+  while ((mutex->ownerTask != -1) && (mutex->ownerTask != thisTask))
+  {
+    if (ticksToWait == portMAX_DELAY)
+      switchTask();
+    else if (waited++ < ticksToWait)
+      vTaskDelay(1);
+    else
+      return(pdFALSE);
+  }
+
+  mutex->ownerTask = thisTask;
+  mutex->takeCount++;
+  return(pdTRUE);
+}
+
+
+
+//
+// give back a recursive mutex, it's free once each take has been given back
+//  Exit:   pdTRUE returned, pdFALSE if this task doesn't hold it
+//
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex)
+{
+  if (mutex->ownerTask != thisTask)
+    return(pdFALSE);
+
+  mutex->takeCount--;
+  if (mutex->takeCount == 0)
+    mutex->ownerTask = -1;
+  return(pdTRUE);
+}
@@ -0,0 +1,56 @@
+//      ******************************************************************
+//      *                                                                *
+//      *                    Host simulation controls                    *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Functions used by host programs (the sketch runner and the tools) to drive 
+// the stand-in hardware: the virtual clock, the scripted touch screen, and the
+// simulated display
+//
+
+#ifndef HostSim_h
+#define HostSim_h
+
+#include <Arduino.h>
+
+class Adafruit_ILI9341;
+
+//
+// virtual clock
+//
+void hostAdvanceMicros(unsigned long us);
+unsigned long long hostGetMicros(void);
+void hostSetTouchSampleMicros(unsigned long us);
+void hostSetRunLimitMillis(unsigned long ms, void (*onLimit)(void));
+
+//
+// scripted touch screen, coordinates are LCD pixels in the current orientation
+//
+void hostAddTouch(unsigned long startMillis, unsigned long durationMillis, int lcdX, int lcdY);
+void hostClearTouches(void);
+bool hostLoadTouchScript(const char *fileName);
+bool hostLoadTouchSamples(const char *fileName, unsigned long startMillis);
+void hostSetTouchSampleCallback(void (*onSample)(void));
+
+//
+// simulated display, the most recently constructed ILI9341 stand-in
+//
+Adafruit_ILI9341 *hostGetDisplay(void);
+void hostRegisterDisplay(Adafruit_ILI9341 *display);
+bool hostOpenTransactionLog(const char *fileName);
+bool hostOpenOverdrawReport(const char *prefix);
+void hostEndDisplayFrame(void);
+
+//
+// the ESP32's FreeRTOS tasks (see FreeRTOS.cpp): switch tasks after every so many 
+// address windows and pixels sent to the display, as if they were preempted in the 
+// middle of drawing, 0 to only switch when a task yields
+//
+void hostSetTaskSwitchInterval(int displayWrites);
+void hostCountDisplayWrite(void);
+
+#endif
@@ -0,0 +1,113 @@
+//      ******************************************************************
+//      *                                                                *
+//      *               Runs an Arduino sketch on the host               *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// usage: sketch [--run-ms N] [--touch "start duration x y"]...
+//               [--touch-file file] [--touch-recording start file]
+//               [--spi-log file] [--overdraw prefix] [--eeprom file]
+//               [--screenshot file.ppm]
+//
+// setup() is called once, then loop() until the virtual clock reaches the run
+// time (10 seconds by default).  The screen is then saved as a PPM image.
+//
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <Adafruit_ILI9341.h>
+#include "HostSim.h"
+#include <stdio.h>
+
+void setup(void);
+void loop(void);
+
+static const char *screenshotFile = NULL;
+
+
+//
+// called at the end of the run, saves the screenshot and exits
+//
+static void finish(void)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  hostEndDisplayFrame();
+  if ((screenshotFile != NULL) && (display != NULL))
+    display->hostSavePPM(screenshotFile);
+  fflush(stdout);
+  exit(0);
+}
+
+
+
+//
+// run the sketch
+//
+int main(int argc, char **argv)
+{
+  unsigned long runMillis = 10000;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "--run-ms") == 0) && (i + 1 < argc))
+      runMillis = strtoul(argv[++i], NULL, 10);
+    else if ((strcmp(argv[i], "--touch") == 0) && (i + 1 < argc))
+    {
+      unsigned long start, duration;
+      int x, y;
+      if (sscanf(argv[++i], "%lu %lu %d %d", &start, &duration, &x, &y) == 4)
+        hostAddTouch(start, duration, x, y);
+    }
+    else if ((strcmp(argv[i], "--touch-file") == 0) && (i + 1 < argc))
+    {
+      if (!hostLoadTouchScript(argv[++i]))
+      {
+        fprintf(stderr, "can't read touch script: %s\n", argv[i]);
+        return(1);
+      }
+    }
+    else if ((strcmp(argv[i], "--touch-recording") == 0) && (i + 2 < argc))
+    {
+      unsigned long start = strtoul(argv[++i], NULL, 10);
+      if (!hostLoadTouchSamples(argv[++i], start))
+      {
+        fprintf(stderr, "can't read touch recording: %s\n", argv[i]);
+        return(1);
+      }
+    }
+    else if ((strcmp(argv[i], "--spi-log") == 0) && (i + 1 < argc))
+    {
+      if (!hostOpenTransactionLog(argv[++i]))
+      {
+        fprintf(stderr, "can't write SPI log: %s\n", argv[i]);
+        return(1);
+      }
+    }
+    else if ((strcmp(argv[i], "--overdraw") == 0) && (i + 1 < argc))
+    {
+      if (!hostOpenOverdrawReport(argv[++i]))
+      {
+        fprintf(stderr, "can't write overdraw report: %s.txt\n", argv[i]);
+        return(1);
+      }
+    }
+    else if ((strcmp(argv[i], "--eeprom") == 0) && (i + 1 < argc))
+      EEPROM.hostSetFile(argv[++i]);
+    else if ((strcmp(argv[i], "--screenshot") == 0) && (i + 1 < argc))
+      screenshotFile = argv[++i];
+    else
+    {
+      fprintf(stderr, "usage: %s [--run-ms N] [--touch \"start duration x y\"] [--touch-file f] "
+        "[--touch-recording start f] [--spi-log f] [--overdraw prefix] [--eeprom f] [--screenshot f.ppm]\n", argv[0]);
+      return(1);
+    }
+  }
+
+  hostSetRunLimitMillis(runMillis, finish);
+  setup();
+  while (true)
+    loop();
+}
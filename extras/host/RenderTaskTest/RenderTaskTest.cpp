@@ -0,0 +1,259 @@
+//      ******************************************************************
+//      *                                                                *
+//      *                   Tests of the ESP32's render task             *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Built with -DARDUINO_ARCH_ESP32 (see build_flags), so the library's ESP32 code 
+// is compiled, with the host's FreeRTOS stand-in.  Its tasks take turns, so the 
+// render task only draws when the UI's task yields.
+//
+// Screens are drawn directly, then again with startRenderTask() and a queue much
+// smaller than what's drawn, so queuing waits for the render task over and over.
+// After waitForRenderQueue() the pixels must be the same as the ones drawn 
+// directly.  Touches must still be read while the render task is drawing, and 
+// after stopRenderQueue() drawing is direct again.  A wait that doesn't yield 
+// hangs, and the test fails when it runs too long.
+//
+// usage: RenderTaskTest
+//
+// Build:  EXTRA_FLAGS=-DARDUINO_ARCH_ESP32 extras/host/build_sketch.sh extras/host/RenderTaskTest /tmp/RenderTaskTest
+//
+
+#include <Arduino.h>
+#include <Adafruit_ILI9341.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <UI_Fonts.h>
+#include "HostSim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+
+
+static const int LCD_CS_PIN   = 1;
+static const int LCD_DC_PIN   = 4;
+static const int TOUCH_CS_PIN = 5;
+
+static const int SCREEN_WIDTH = 320;
+static const int SCREEN_HEIGHT = 240;
+static const int SCREEN_COUNT = 20;
+static const int RENDER_QUEUE_SIZE = 8;
+static const int MOST_SECONDS = 20;
+
+static TouchUserInterfaceForArduino ui;
+static RENDER_COMMAND renderQueueBuffer[RENDER_QUEUE_SIZE];
+static uint16_t directPixels[SCREEN_WIDTH * SCREEN_HEIGHT];
+static int failures = 0;
+
+
+//
+// check a condition, printing the line when it fails
+//
+#define CHECK(condition) checkCondition((condition), #condition, __LINE__)
+
+static void checkCondition(bool passedFlg, const char *condition, int line)
+{
+  if (passedFlg)
+    return;
+  printf("FAILED line %d: %s\n", line, condition);
+  failures++;
+}
+
+
+
+//
+// a task waiting without yielding never lets the others run, end the test
+//
+static void onTooLong(int signalNumber)
+{
+  (void) signalNumber;
+  static const char message[] = "FAILED: hung, a task is waiting without yielding\n";
+  if (write(STDOUT_FILENO, message, sizeof(message) - 1) < 0)
+    _exit(1);
+  _exit(1);
+}
+
+
+
+//
+// a random number from min to max
+//
+static int randomBetween(int min, int max)
+{
+  return(min + (int) (drand48() * (max - min + 1)));
+}
+
+static uint16_t randomColor(void)
+{
+  return((uint16_t) randomBetween(0, 0xffff));
+}
+
+
+
+//
+// draw a screen: a title bar, buttons, shapes and text, each screen is the same 
+// every time it's drawn with the same seed
+//
+static void drawScreen(int screenNumber)
+{
+  char text[40];
+  srand48(screenNumber);
+
+  ui.lcdClearScreen(randomColor());
+  snprintf(text, sizeof(text), "Screen %d", screenNumber);
+  ui.drawTitleBarWithBackButton(text);
+
+  for (int i = 0; i < 6; i++)
+  {
+    BUTTON_EXTENDED button = {"Button", randomBetween(40, 280), randomBetween(60, 210), 
+      randomBetween(40, 120), randomBetween(20, 40), randomColor(), randomColor(), 
+      randomColor(), randomColor(), UI_Font_12_Bold};
+    ui.drawButton(button);
+  }
+
+  for (int i = 0; i < 20; i++)
+  {
+    ui.lcdDrawFilledCircle(randomBetween(0, 319), randomBetween(0, 239), randomBetween(0, 40), randomColor());
+    ui.lcdDrawFilledRoundedRectangle(randomBetween(-20, 319), randomBetween(-20, 239), 
+      randomBetween(1, 100), randomBetween(1, 60), randomBetween(0, 10), randomColor());
+    ui.lcdDrawLine(randomBetween(0, 319), randomBetween(0, 239), randomBetween(0, 319), randomBetween(0, 239), randomColor());
+  }
+
+  ui.lcdSetFontColor(randomColor());
+  ui.lcdSetCursorXY(randomBetween(0, 200), randomBetween(40, 220));
+  ui.lcdPrint("Drawn by the render task");
+}
+
+
+
+//
+// copy the screen, and count the pixels that differ from the copy
+//
+static void copyScreen(uint16_t *pixels)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+      pixels[y * SCREEN_WIDTH + x] = display->hostGetPixel(x, y);
+  }
+}
+
+static int countDifferentPixels(const uint16_t *pixels)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+  int count = 0;
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+    {
+      if (pixels[y * SCREEN_WIDTH + x] != display->hostGetPixel(x, y))
+        count++;
+    }
+  }
+  return(count);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                     The tests
+// ---------------------------------------------------------------------------------
+
+//
+// draw each screen directly, then through the render task, and compare them
+//
+static void testScreens(void)
+{
+  for (int screenNumber = 0; screenNumber < SCREEN_COUNT; screenNumber++)
+  {
+    ui.stopRenderQueue();
+    drawScreen(screenNumber);
+    copyScreen(directPixels);
+
+    ui.startRenderTask(renderQueueBuffer, RENDER_QUEUE_SIZE, 0);
+    ui.lcdClearScreen(LCD_BLACK);
+    drawScreen(screenNumber);
+    ui.waitForRenderQueue();
+
+    int differentPixels = countDifferentPixels(directPixels);
+    if (differentPixels != 0)
+      printf("FAILED: screen %d drawn by the render task, %d pixels differ\n", screenNumber, differentPixels);
+    CHECK(differentPixels == 0);
+  }
+}
+
+
+
+//
+// read a touch while the render task is drawing
+//
+static void testTouchWhileRendering(void)
+{
+  ui.startRenderTask(renderQueueBuffer, RENDER_QUEUE_SIZE, 0);
+  drawScreen(0);
+
+  unsigned long startTime = millis();
+  hostAddTouch(startTime + 10, 100, 160, 120);
+  boolean pushedFlg = false;
+  while ((millis() - startTime < 500) && !pushedFlg)
+  {
+    drawScreen(1);
+    ui.getTouchEvents();
+    if (ui.touchEventType == TOUCH_PUSHED_EVENT)
+    {
+      pushedFlg = true;
+      CHECK(abs(ui.touchEventX - 160) <= 2);
+      CHECK(abs(ui.touchEventY - 120) <= 2);
+    }
+  }
+  CHECK(pushedFlg);
+  hostClearTouches();
+}
+
+
+
+//
+// after stopping the queue, drawing goes straight to the display
+//
+static void testStopRenderQueue(void)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+
+  ui.startRenderTask(renderQueueBuffer, RENDER_QUEUE_SIZE, 0);
+  drawScreen(2);
+  ui.stopRenderQueue();
+
+  ui.lcdDrawFilledRectangle(10, 10, 5, 5, 0x1234);
+  CHECK(display->hostGetPixel(12, 12) == 0x1234);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    Main program
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  (void) argc;
+  (void) argv;
+  signal(SIGALRM, onTooLong);
+  alarm(MOST_SECONDS);
+
+  ui.begin(LCD_CS_PIN, LCD_DC_PIN, TOUCH_CS_PIN, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT, UI_Font_13_Bold);
+
+  testScreens();
+  testTouchWhileRendering();
+  testStopRenderQueue();
+
+  if (failures != 0)
+  {
+    printf("%d check(s) failed\n", failures);
+    return(1);
+  }
+  printf("all render task checks passed\n");
+  return(0);
+}
@@ -0,0 +1,29 @@
+//      ******************************************************************
+//      *                                                                *
+//      *                    Host stand-in for SPI.h                     *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// The display and touch screen stand-ins don't use a bus, so SPI does nothing.
+//
+
+#ifndef SPI_h
+#define SPI_h
+
+#include <Arduino.h>
+
+class SPIClass
+{
+  public:
+    void begin(void) {}
+    void setTX(int pin) { (void) pin; }
+    void setRX(int pin) { (void) pin; }
+    void setSCK(int pin) { (void) pin; }
+};
+
+extern SPIClass SPI;
+
+#endif
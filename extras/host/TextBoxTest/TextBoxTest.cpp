@@ -0,0 +1,331 @@
+//      ******************************************************************
+//      *                                                                *
+//      *                     Tests of the Text Box                      *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Checks how a Text Box's text is broken into lines: at '\n', at spaces, in the 
+// middle of a word too long for the box, with the spaces at the ends of lines not
+// drawn, and narrower to leave room for the scroll bar when the lines don't fit.
+//
+// Then the box is scrolled by touching it, a page down each time the bottom half is
+// touched and a page up for the top half, stopping at the first and last pages.
+// The touches are recorded, and replaying them must scroll the box the same way.
+//
+// usage: TextBoxTest
+//
+// Build:  extras/host/build_sketch.sh extras/host/TextBoxTest /tmp/TextBoxTest
+//
+
+#include <Arduino.h>
+#include <Adafruit_ILI9341.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <UI_Fonts.h>
+#include "HostSim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+static const int LCD_CS_PIN   = 1;
+static const int LCD_DC_PIN   = 4;
+static const int TOUCH_CS_PIN = 5;
+
+static const int TEXT_BOX_MARGIN = 4;
+static const int TEXT_BOX_SCROLL_BAR_WIDTH = 6;
+
+static const int MAX_LINE_LENGTH = 100;
+static const int MAX_SCROLLS = 20;
+static const int MAX_SAMPLES = 100;
+
+static TouchUserInterfaceForArduino ui;
+static int failures = 0;
+
+
+//
+// the text boxes: one whose lines all fit, and one that scrolls
+//
+static const char shortText[] = "First line\n\nAfter a blank line, "
+  "Pneumonoultramicroscopicsilicovolcanoconiosis is too long.   \nEnd";
+
+static const char *shortTextLines[] = {
+  "First line", 
+  "", 
+  "After a blank line,", 
+  "Pneumonoultramicroscopicsili", 
+  "covolcanoconiosis is too", 
+  "long.", 
+  "End"
+};
+
+static const char longText[] = "This text has more lines than fit in the box, so "
+  "it's wrapped narrower to leave room for the scroll bar.\nIt's scrolled a page at "
+  "a time by touching it, the top half of the box scrolls up a page, and the bottom "
+  "half scrolls down a page.  Scrolling stops at the first and last pages, the last "
+  "page is always full.  Each touch is recorded, then the recording is replayed "
+  "and must scroll the box the same way.\nThe last line.";
+
+static uint16_t shortTextLineStarts[20];
+static uint16_t longTextLineStarts[40];
+
+
+//
+// what happened each time the Text Box was touched
+//
+typedef struct
+{
+  int count;
+  boolean scrolledFlg[MAX_SCROLLS];
+  int topLine[MAX_SCROLLS];
+} SCROLL_LIST;
+
+
+//
+// check a condition, printing it if it fails
+//
+#define CHECK(condition) checkCondition((condition), #condition, __LINE__)
+
+static void checkCondition(bool passedFlg, const char *condition, int line)
+{
+  if (passedFlg)
+    return;
+  printf("FAILED line %d: %s\n", line, condition);
+  failures++;
+}
+
+
+
+//
+// get a line of a Text Box as it's drawn, without the spaces and newline at its end
+//  Enter:  textBox -> the Text Box, drawn so its lines have been found
+//          line = index of the line
+//          buffer -> storage for the line, MAX_LINE_LENGTH bytes
+//          untrimmedLengthPntr -> storage for the line's length with the spaces
+//
+static void getLine(TEXT_BOX &textBox, int line, char *buffer, int *untrimmedLengthPntr)
+{
+  int startIdx = textBox.lineStarts[line];
+  int endIdx = textBox.lineStarts[line + 1];
+  if ((endIdx > startIdx) && (textBox.text[endIdx - 1] == '\n'))
+    endIdx--;
+  *untrimmedLengthPntr = endIdx - startIdx;
+
+  while ((endIdx > startIdx) && (textBox.text[endIdx - 1] == ' '))
+    endIdx--;
+
+  int length = min(endIdx - startIdx, MAX_LINE_LENGTH - 1);
+  memcpy(buffer, textBox.text + startIdx, length);
+  buffer[length] = 0;
+}
+
+
+
+//
+// get the number of lines that fit in a Text Box with the font that's set
+//
+static int visibleLines(TEXT_BOX &textBox)
+{
+  return((textBox.height - TEXT_BOX_MARGIN*2) / ui.lcdGetFontHeightWithDecentersAndLineSpacing());
+}
+
+
+
+//
+// add a touch on the top or bottom half of a Text Box to the touch script
+//  Enter:  textBox -> the Text Box
+//          touchTime = when to touch it, on the virtual clock
+//          bottomFlg = true to touch the bottom half, false for the top
+//
+static void touchTextBox(TEXT_BOX &textBox, unsigned long touchTime, boolean bottomFlg)
+{
+  int y = textBox.centerY + (bottomFlg ? textBox.height/4 : -textBox.height/4);
+  hostAddTouch(touchTime, 100, textBox.centerX, y);
+}
+
+
+
+//
+// call getTouchEvents() and checkForTextBoxTouched(), adding what each touch did
+// to a list
+//  Enter:  textBox -> the Text Box
+//          scrolls -> the list to add to
+//          replayFlg = true to stop when the replay ends, false to stop at endTime
+//          endTime = when to stop, on the virtual clock
+//
+static void getScrolls(TEXT_BOX &textBox, SCROLL_LIST &scrolls, boolean replayFlg, unsigned long endTime)
+{
+  while (replayFlg ? ui.isTouchReplayRunning() : ((long) (millis() - endTime) < 0))
+  {
+    ui.getTouchEvents();
+    if (ui.touchEventType != TOUCH_PUSHED_EVENT)
+      continue;
+
+    boolean scrolledFlg = ui.checkForTextBoxTouched(textBox);
+    if (scrolls.count < MAX_SCROLLS)
+    {
+      scrolls.scrolledFlg[scrolls.count] = scrolledFlg;
+      scrolls.topLine[scrolls.count] = textBox.topLine;
+    }
+    scrolls.count++;
+  }
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    The tests
+// ---------------------------------------------------------------------------------
+
+//
+// newlines, a blank line, a word broken in the middle, and spaces at the end of 
+// a line that aren't drawn
+//
+static void testBreakingLines(void)
+{
+  TEXT_BOX textBox = {shortText, 82, 135, 150, 180, shortTextLineStarts, 20, 0, 0, NULL, NULL, 0};
+  char line[MAX_LINE_LENGTH];
+  int untrimmedLength;
+  const int expectedLineCount = sizeof(shortTextLines) / sizeof(shortTextLines[0]);
+
+  ui.drawTextBox(textBox);
+  CHECK(textBox.lineCount == expectedLineCount);
+  CHECK(textBox.lineCount <= visibleLines(textBox));
+
+  for (int i = 0; (i < textBox.lineCount) && (i < expectedLineCount); i++)
+  {
+    getLine(textBox, i, line, &untrimmedLength);
+    if (strcmp(line, shortTextLines[i]) != 0)
+    {
+      printf("FAILED: line %d of the short text is \"%s\", expected \"%s\"\n", i, line, shortTextLines[i]);
+      failures++;
+    }
+    CHECK(ui.lcdStringWidthInPixels(line) <= textBox.width - TEXT_BOX_MARGIN*2);
+  }
+
+  //
+  // the long word is broken where it stops fitting, and the line ending in spaces
+  // keeps them in the text but they aren't drawn
+  //
+  getLine(textBox, 3, line, &untrimmedLength);
+  CHECK(shortText[textBox.lineStarts[4] - 1] != ' ');
+  getLine(textBox, 5, line, &untrimmedLength);
+  CHECK(untrimmedLength == (int) strlen("long.   "));
+
+  //
+  // there's no scroll bar, the background is at the right edge
+  //
+  int boxRightX = textBox.centerX + textBox.width/2 - 2;
+  CHECK(hostGetDisplay()->hostGetPixel(boxRightX, textBox.centerY) == LCD_BLACK);
+}
+
+
+
+//
+// text that doesn't fit is broken narrower for the scroll bar, then it's scrolled
+// by touching, and the recorded touches scroll it the same way
+//
+static void testScrolling(void)
+{
+  TEXT_BOX textBox = {longText, 160, 140, 180, 70, longTextLineStarts, 40, 0, 0, NULL, NULL, 0};
+  char line[MAX_LINE_LENGTH];
+  int untrimmedLength;
+  TOUCH_SAMPLE samples[MAX_SAMPLES];
+  SCROLL_LIST scrolls = {};
+  SCROLL_LIST replayedScrolls = {};
+
+  ui.clearDisplaySpace();
+  ui.drawTextBox(textBox);
+
+  int lines = visibleLines(textBox);
+  int pageLines = lines - 1;
+  int lastTopLine = textBox.lineCount - lines;
+  CHECK(textBox.lineCount > lines + 2 * pageLines);
+  CHECK(lastTopLine % pageLines != 0);              // the last page down is cut short
+
+  for (int i = 0; i < textBox.lineCount; i++)
+  {
+    getLine(textBox, i, line, &untrimmedLength);
+    CHECK(ui.lcdStringWidthInPixels(line) <= textBox.width - TEXT_BOX_MARGIN*2 - TEXT_BOX_SCROLL_BAR_WIDTH);
+    CHECK(line[0] != ' ');
+  }
+
+  int boxRightX = textBox.centerX + textBox.width/2 - 1;
+  CHECK(hostGetDisplay()->hostGetPixel(boxRightX, textBox.centerY) != LCD_BLACK);
+
+  //
+  // touch the top half on the first page, the bottom half until past the last 
+  // page, then the top half back to the first
+  //
+  static const boolean touchBottomFlgs[] = {false, true, true, true, true, true, false, false, false, false, false};
+  const int touchCount = sizeof(touchBottomFlgs) / sizeof(touchBottomFlgs[0]);
+  unsigned long startTime = millis();
+
+  ui.startTouchRecording(samples, MAX_SAMPLES);
+  for (int i = 0; i < touchCount; i++)
+    touchTextBox(textBox, startTime + 200 + i * 300, touchBottomFlgs[i]);
+  getScrolls(textBox, scrolls, false, startTime + 200 + touchCount * 300);
+  int sampleCount = ui.stopTouchRecording();
+  hostClearTouches();
+
+  CHECK(scrolls.count == touchCount);
+  int expectedTopLine = 0;
+  for (int i = 0; (i < scrolls.count) && (i < touchCount); i++)
+  {
+    int topLine = expectedTopLine + (touchBottomFlgs[i] ? pageLines : -pageLines);
+    topLine = max(min(topLine, lastTopLine), 0);
+    boolean scrolledFlg = (topLine != expectedTopLine);
+    expectedTopLine = topLine;
+
+    if ((scrolls.scrolledFlg[i] != scrolledFlg) || (scrolls.topLine[i] != expectedTopLine))
+    {
+      printf("FAILED: touch %d, top line %d %s, expected %d %s\n", i, 
+        scrolls.topLine[i], scrolls.scrolledFlg[i] ? "scrolled" : "not scrolled",
+        expectedTopLine, scrolledFlg ? "scrolled" : "not scrolled");
+      failures++;
+    }
+  }
+  CHECK(scrolls.topLine[5] == lastTopLine);
+  CHECK(textBox.topLine == 0);
+
+  //
+  // replay the recording
+  //
+  ui.startTouchReplay(samples, sampleCount);
+  getScrolls(textBox, replayedScrolls, true, 0);
+
+  CHECK(replayedScrolls.count == scrolls.count);
+  for (int i = 0; (i < replayedScrolls.count) && (i < scrolls.count) && (i < MAX_SCROLLS); i++)
+  {
+    CHECK(replayedScrolls.scrolledFlg[i] == scrolls.scrolledFlg[i]);
+    CHECK(replayedScrolls.topLine[i] == scrolls.topLine[i]);
+  }
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    Main program
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  (void) argc;
+  (void) argv;
+
+  ui.begin(LCD_CS_PIN, LCD_DC_PIN, TOUCH_CS_PIN, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT, UI_Font_13_Bold);
+  ui.drawTitleBar("Text Box");
+  ui.clearDisplaySpace();
+  ui.lcdSetFont(UI_Font_10);
+  ui.lcdSetFontColor(LCD_WHITE);
+
+  testBreakingLines();
+  testScrolling();
+
+  if (failures != 0)
+  {
+    printf("%d check(s) failed\n", failures);
+    return(1);
+  }
+  printf("all text box checks passed\n");
+  return(0);
+}
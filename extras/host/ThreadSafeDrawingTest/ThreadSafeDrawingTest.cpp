@@ -0,0 +1,234 @@
+//      ******************************************************************
+//      *                                                                *
+//      *              Tests of drawing from more than one task          *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Built with -DARDUINO_ARCH_ESP32 (see build_flags), so enableThreadSafeDrawing() 
+// uses the FreeRTOS recursive mutex, with the host's FreeRTOS stand-in.  
+//
+// The UI's task draws shapes and text on the left half of the screen, and reads
+// the touch screen, while a second task draws and prints with its own DRAW_CONTEXT
+// on the right half.  The tasks are switched every few pixels, as if they were 
+// preempted in the middle of drawing, so a task that talks to the display without
+// holding the lock garbles the other's drawing.  The screen must end up the same
+// as when each half is drawn by itself.
+//
+// usage: ThreadSafeDrawingTest
+//
+// Build:  EXTRA_FLAGS=-DARDUINO_ARCH_ESP32 extras/host/build_sketch.sh extras/host/ThreadSafeDrawingTest /tmp/ThreadSafeDrawingTest
+//
+
+#include <Arduino.h>
+#include <Adafruit_ILI9341.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <UI_Fonts.h>
+#include "HostSim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+
+
+static const int LCD_CS_PIN   = 1;
+static const int LCD_DC_PIN   = 4;
+static const int TOUCH_CS_PIN = 5;
+
+static const int SCREEN_WIDTH = 320;
+static const int SCREEN_HEIGHT = 240;
+static const int HALF_WIDTH = SCREEN_WIDTH / 2;
+static const int DRAWS_PER_HALF = 300;
+static const int TASK_SWITCH_INTERVAL = 7;
+static const int MOST_SECONDS = 20;
+
+static TouchUserInterfaceForArduino ui;
+static uint16_t separatePixels[SCREEN_WIDTH * SCREEN_HEIGHT];
+static volatile boolean sensorTaskDoneFlg = false;
+static int failures = 0;
+
+
+//
+// check a condition, printing the line when it fails
+//
+#define CHECK(condition) checkCondition((condition), #condition, __LINE__)
+
+static void checkCondition(bool passedFlg, const char *condition, int line)
+{
+  if (passedFlg)
+    return;
+  printf("FAILED line %d: %s\n", line, condition);
+  failures++;
+}
+
+
+
+//
+// a task waiting for the lock without yielding never lets the others run, end 
+// the test
+//
+static void onTooLong(int signalNumber)
+{
+  (void) signalNumber;
+  static const char message[] = "FAILED: hung, a task is waiting without yielding\n";
+  if (write(STDOUT_FILENO, message, sizeof(message) - 1) < 0)
+    _exit(1);
+  _exit(1);
+}
+
+
+
+//
+// a random number from min to max, each task has its own random numbers
+//
+static int randomBetween(unsigned short *randomState, int min, int max)
+{
+  return(min + (int) (erand48(randomState) * (max - min + 1)));
+}
+
+
+
+//
+// draw shapes and text on one half of the screen, printing with a DRAW_CONTEXT
+// so the UI's cursor, font and color aren't used
+//  Enter:  leftX = left edge of the half
+//          seed = seed for the random shapes
+//
+static void drawHalf(int leftX, unsigned short seed)
+{
+  static const char *texts[] = {"23.5 C", "Sensor", "Hello World", "42"};
+  static const byte *fonts[] = {UI_Font_9, UI_Font_12_Bold, UI_Font_16_Bold};
+  unsigned short randomState[3] = {seed, 0x1234, 0x5678};
+
+  for (int i = 0; i < DRAWS_PER_HALF; i++)
+  {
+    uint16_t color = (uint16_t) randomBetween(randomState, 0, 0xffff);
+    switch(randomBetween(randomState, 0, 2))
+    {
+      case 0:
+      {
+        int width = randomBetween(randomState, 1, 60);
+        int height = randomBetween(randomState, 1, 60);
+        ui.lcdDrawFilledRectangle(leftX + randomBetween(randomState, 0, HALF_WIDTH - width), 
+          randomBetween(randomState, 0, SCREEN_HEIGHT - height), width, height, color);
+        break;
+      }
+
+      case 1:
+      {
+        int radius = randomBetween(randomState, 0, 30);
+        ui.lcdDrawFilledCircle(leftX + randomBetween(randomState, radius, HALF_WIDTH - 1 - radius), 
+          randomBetween(randomState, radius, SCREEN_HEIGHT - 1 - radius), radius, color);
+        break;
+      }
+
+      case 2:
+      {
+        const char *text = texts[randomBetween(randomState, 0, 3)];
+        DRAW_CONTEXT context = {fonts[randomBetween(randomState, 0, 2)], color, 0, 0};
+        int width = ui.lcdStringWidthInPixels(context, text);
+        context.cursorX = leftX + randomBetween(randomState, 0, HALF_WIDTH - width);
+        context.cursorY = randomBetween(randomState, 0, SCREEN_HEIGHT - 20);
+        ui.lcdPrint(context, text);
+        break;
+      }
+    }
+  }
+}
+
+
+
+//
+// the second task, it draws the right half of the screen then waits
+//
+static void sensorTask(void *parameter)
+{
+  (void) parameter;
+  drawHalf(HALF_WIDTH, 2);
+  sensorTaskDoneFlg = true;
+
+  while(true)
+    vTaskDelay(pdMS_TO_TICKS(1));
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                     The tests
+// ---------------------------------------------------------------------------------
+
+//
+// draw each half by itself, then both at the same time from two tasks, with the UI's
+// task reading the touch screen, and compare them
+//
+static void testTwoTasks(void)
+{
+  Adafruit_ILI9341 *display = hostGetDisplay();
+
+  ui.lcdClearScreen(LCD_BLACK);
+  drawHalf(0, 1);
+  drawHalf(HALF_WIDTH, 2);
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+      separatePixels[y * SCREEN_WIDTH + x] = display->hostGetPixel(x, y);
+  }
+
+  ui.lcdClearScreen(LCD_BLACK);
+  ui.enableThreadSafeDrawing();
+  hostSetTaskSwitchInterval(TASK_SWITCH_INTERVAL);
+  CHECK(xTaskCreatePinnedToCore(sensorTask, "sensorTask", 4096, NULL, 1, NULL, 0) == pdPASS);
+
+  hostAddTouch(millis() + 5, 50, 80, 120);
+  drawHalf(0, 1);
+  boolean pushedFlg = false;
+  while (!sensorTaskDoneFlg || !pushedFlg)
+  {
+    ui.getTouchEvents();
+    if (ui.touchEventType == TOUCH_PUSHED_EVENT)
+      pushedFlg = true;
+    yield();
+  }
+  hostSetTaskSwitchInterval(0);
+  hostClearTouches();
+
+  int differentPixels = 0;
+  for (int y = 0; y < SCREEN_HEIGHT; y++)
+  {
+    for (int x = 0; x < SCREEN_WIDTH; x++)
+    {
+      if (display->hostGetPixel(x, y) != separatePixels[y * SCREEN_WIDTH + x])
+        differentPixels++;
+    }
+  }
+  if (differentPixels != 0)
+    printf("FAILED: drawing from two tasks, %d pixels differ from drawing each half by itself\n", differentPixels);
+  CHECK(differentPixels == 0);
+  CHECK(pushedFlg);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    Main program
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  (void) argc;
+  (void) argv;
+  signal(SIGALRM, onTooLong);
+  alarm(MOST_SECONDS);
+
+  ui.begin(LCD_CS_PIN, LCD_DC_PIN, TOUCH_CS_PIN, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT, UI_Font_13_Bold);
+
+  testTwoTasks();
+
+  if (failures != 0)
+  {
+    printf("%d check(s) failed\n", failures);
+    return(1);
+  }
+  printf("all thread safe drawing checks passed\n");
+  return(0);
+}
@@ -0,0 +1,198 @@
+//      ******************************************************************
+//      *                                                                *
+//      *             Tests of recording and replaying touches           *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Records a tap, then a second press that is still held when the recording is
+// stopped, the way a recording is usually cut off.  The recording is replayed and
+// must give the same events as when it was recorded: PUSHED, RELEASED, PUSHED.
+// Once the replay has ended, nothing is touching the screen, so no more events
+// may follow, and a new tap on the screen must give PUSHED then RELEASED.
+//
+// usage: TouchReplayTest
+//
+// Build:  extras/host/build_sketch.sh extras/host/TouchReplayTest /tmp/TouchReplayTest
+//
+
+#include <Arduino.h>
+#include <HostSim.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <UI_Fonts.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+static const int LCD_CS_PIN   = 1;
+static const int LCD_DC_PIN   = 4;
+static const int TOUCH_CS_PIN = 5;
+
+static const int MAX_EVENTS = 20;
+static const int MAX_SAMPLES = 100;
+static const int CALLS_AFTER_REPLAY = 2000;
+
+static int failures = 0;
+
+
+//
+// the events given by getTouchEvents()
+//
+typedef struct
+{
+  int type;
+  int x;
+  int y;
+} TEST_EVENT;
+
+typedef struct
+{
+  TEST_EVENT events[MAX_EVENTS];
+  int count;
+} TEST_EVENT_LIST;
+
+
+//
+// check a condition, printing it if it fails
+//
+#define CHECK(condition) checkCondition((condition), #condition, __LINE__)
+
+static void checkCondition(bool passedFlg, const char *condition, int line)
+{
+  if (passedFlg)
+    return;
+  printf("FAILED line %d: %s\n", line, condition);
+  failures++;
+}
+
+
+
+//
+// call getTouchEvents() once, adding the event to a list if there was one
+//  Exit:   true returned if there was an event
+//
+static bool getEvent(TouchUserInterfaceForArduino &ui, TEST_EVENT_LIST &list)
+{
+  ui.getTouchEvents();
+  if (ui.touchEventType == TOUCH_NO_EVENT)
+    return(false);
+
+  if (list.count < MAX_EVENTS)
+  {
+    TEST_EVENT &event = list.events[list.count];
+    event.type = ui.touchEventType;
+    event.x = ui.touchEventX;
+    event.y = ui.touchEventY;
+  }
+  list.count++;
+  return(true);
+}
+
+
+
+//
+// call getTouchEvents() until the virtual clock reaches a time
+//
+static void getEventsUntil(TouchUserInterfaceForArduino &ui, unsigned long time, TEST_EVENT_LIST &list)
+{
+  while ((long) (millis() - time) < 0)
+    getEvent(ui, list);
+}
+
+
+
+//
+// check the types of the events in a list
+//
+static bool eventTypesAre(const TEST_EVENT_LIST &list, int count, const int *types)
+{
+  if (list.count != count)
+    return(false);
+  for (int i = 0; i < count; i++)
+  {
+    if (list.events[i].type != types[i])
+      return(false);
+  }
+  return(true);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    Main program
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  (void) argc;
+  (void) argv;
+  TouchUserInterfaceForArduino ui;
+  TOUCH_SAMPLE samples[MAX_SAMPLES];
+  TEST_EVENT_LIST recorded = {};
+  TEST_EVENT_LIST replayed = {};
+  TEST_EVENT_LIST afterReplay = {};
+  TEST_EVENT_LIST newTap = {};
+  static const int pushedReleasedPushed[] = {TOUCH_PUSHED_EVENT, TOUCH_RELEASED_EVENT, TOUCH_PUSHED_EVENT};
+  static const int pushedReleased[] = {TOUCH_PUSHED_EVENT, TOUCH_RELEASED_EVENT};
+
+  ui.begin(LCD_CS_PIN, LCD_DC_PIN, TOUCH_CS_PIN, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT, UI_Font_13_Bold);
+
+  //
+  // record a tap, and a press that is still held when the recording stops
+  //
+  unsigned long startTime = millis();
+  hostAddTouch(startTime + 200, 200, 100, 80);
+  hostAddTouch(startTime + 600, 500, 220, 150);
+
+  ui.startTouchRecording(samples, MAX_SAMPLES);
+  getEventsUntil(ui, startTime + 1000, recorded);
+  int sampleCount = ui.stopTouchRecording();
+
+  CHECK(eventTypesAre(recorded, 3, pushedReleasedPushed));
+
+  //
+  // let go of the screen, then replay the recording
+  //
+  TEST_EVENT_LIST ignored = {};
+  getEventsUntil(ui, startTime + 1500, ignored);
+  hostClearTouches();
+
+  ui.startTouchReplay(samples, sampleCount);
+  CHECK(ui.isTouchReplayRunning());
+  while (ui.isTouchReplayRunning())
+    getEvent(ui, replayed);
+
+  CHECK(eventTypesAre(replayed, 3, pushedReleasedPushed));
+  for (int i = 0; (i < replayed.count) && (i < recorded.count); i++)
+  {
+    CHECK(replayed.events[i].x == recorded.events[i].x);
+    CHECK(replayed.events[i].y == recorded.events[i].y);
+  }
+
+  //
+  // the press held at the end of the recording is dropped, nothing follows it
+  //
+  for (int i = 0; i < CALLS_AFTER_REPLAY; i++)
+    getEvent(ui, afterReplay);
+  CHECK(afterReplay.count == 0);
+  if (afterReplay.count != 0)
+    printf("  event %d at (%d, %d) after the replay ended\n",
+      afterReplay.events[0].type, afterReplay.events[0].x, afterReplay.events[0].y);
+
+  //
+  // the touch screen works again
+  //
+  unsigned long tapTime = millis() + 100;
+  hostAddTouch(tapTime, 200, 100, 80);
+  getEventsUntil(ui, tapTime + 500, newTap);
+  CHECK(eventTypesAre(newTap, 2, pushedReleased));
+
+  if (failures != 0)
+  {
+    printf("%d check(s) failed\n", failures);
+    return(1);
+  }
+  printf("all touch replay checks passed\n");
+  return(0);
+}
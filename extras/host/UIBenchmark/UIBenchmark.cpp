@@ -0,0 +1,512 @@
+//      ******************************************************************
+//      *                                                                *
+//      *           Draw cost benchmarks for the user interface          *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Draws each of the library's widgets on the host's ILI9341 stand-in and reports
+// the SPI traffic the real display driver would have sent: transactions, address
+// windows, bytes, pixels, and the time those bytes take on the wire.
+//
+// usage: UIBenchmark [--spi-mhz N] [--save file] [--check file] [--tolerance percent]
+//
+//   --spi-mhz N        SPI clock used to compute the wire time (default 40)
+//   --save file        write the counts to a baseline file
+//   --check file       compare the counts with a baseline file, the program
+//                      exits with 1 if any count went up (a regression)
+//   --tolerance P      allow counts to grow by P percent before failing (default 0)
+//
+// The counts don't depend on timing, so a run gives the same numbers every time.
+//
+// Build:  extras/host/build_sketch.sh extras/host/UIBenchmark /tmp/UIBenchmark
+//
+
+#include <Arduino.h>
+#include <Adafruit_ILI9341.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <UI_Fonts.h>
+#include "HostSim.h"
+#include <stdio.h>
+#include <setjmp.h>
+#include <vector>
+
+
+//
+// the results of one benchmark
+//
+struct BENCHMARK_RESULT
+{
+  char name[48];
+  HOST_SPI_COUNTS counts;
+};
+
+static std::vector<BENCHMARK_RESULT> results;
+
+static TouchUserInterfaceForArduino ui;
+static Adafruit_ILI9341 *display;
+
+static const int LCD_CS_PIN   = 1;
+static const int LCD_DC_PIN   = 4;
+static const int TOUCH_CS_PIN = 5;
+
+static jmp_buf waitingForTouchJump;
+
+
+//
+// the fonts benchmarked by lcdPrint
+//
+static const struct { const char *name; const byte *font; } fonts[] =
+{
+  {"9",       UI_Font_9},
+  {"10",      UI_Font_10},
+  {"10_Bold", UI_Font_10_Bold},
+  {"11",      UI_Font_11},
+  {"11_Bold", UI_Font_11_Bold},
+  {"12_Bold", UI_Font_12_Bold},
+  {"13",      UI_Font_13},
+  {"13_Bold", UI_Font_13_Bold},
+  {"14",      UI_Font_14},
+  {"14_Bold", UI_Font_14_Bold},
+  {"15",      UI_Font_15},
+  {"15_Bold", UI_Font_15_Bold},
+  {"16_Bold", UI_Font_16_Bold}
+};
+
+
+//
+// a menu big enough for the largest benchmark, plus its header and end marker
+//
+static const int MAX_MENU_ITEMS = 16;
+static MENU_ITEM benchmarkMenu[MAX_MENU_ITEMS + 2];
+static char benchmarkMenuText[MAX_MENU_ITEMS][16];
+
+static const int IMAGE_SIZE = 48;
+static uint16_t benchmarkImage[IMAGE_SIZE * IMAGE_SIZE];
+
+
+// ---------------------------------------------------------------------------------
+//                                Taking measurements
+// ---------------------------------------------------------------------------------
+
+//
+// start measuring, clearing the counts
+//
+static void startMeasurement(void)
+{
+  display->hostResetCounts();
+}
+
+
+
+//
+// stop measuring, saving the counts since startMeasurement()
+//  Enter:  name -> name of the benchmark (no spaces)
+//
+static void endMeasurement(const char *name)
+{
+  BENCHMARK_RESULT result;
+  snprintf(result.name, sizeof(result.name), "%s", name);
+  result.counts = display->hostGetCounts();
+  results.push_back(result);
+}
+
+
+
+//
+// total bytes sent over SPI
+//
+static unsigned long totalBytes(const HOST_SPI_COUNTS &counts)
+{
+  return(counts.commandBytes + counts.dataBytes);
+}
+
+
+
+//
+// called each time the touch screen is sampled, the UI has finished drawing and
+// is waiting for a touch, so jump back to the benchmark
+//
+static void uiIsWaitingForTouch(void)
+{
+  hostSetTouchSampleCallback(NULL);
+  longjmp(waitingForTouchJump, 1);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                   The benchmarks
+// ---------------------------------------------------------------------------------
+
+//
+// menus with 1 to 4 columns and 4 to 16 buttons, measured from the title bar
+// through the last button
+//
+static void benchmarkMenus(void)
+{
+  char name[48];
+
+  for (int i = 0; i < MAX_MENU_ITEMS; i++)
+    snprintf(benchmarkMenuText[i], sizeof(benchmarkMenuText[i]), "Item %d", i + 1);
+
+  for (int columns = 1; columns <= 4; columns++)
+  {
+    for (int items = 4; items <= MAX_MENU_ITEMS; items += 4)
+    {
+      benchmarkMenu[0].MenuItemType = MENU_ITEM_TYPE_MAIN_MENU_HEADER;
+      benchmarkMenu[0].MenuItemText = "Benchmark Menu";
+      benchmarkMenu[0].MenuItemFunction = (void (*)()) (intptr_t) columns;
+      benchmarkMenu[0].MenuItemSubMenu = benchmarkMenu;
+
+      for (int i = 0; i < items; i++)
+      {
+        benchmarkMenu[i + 1].MenuItemType = MENU_ITEM_TYPE_COMMAND;
+        benchmarkMenu[i + 1].MenuItemText = benchmarkMenuText[i];
+        benchmarkMenu[i + 1].MenuItemFunction = NULL;
+        benchmarkMenu[i + 1].MenuItemSubMenu = NULL;
+      }
+
+      benchmarkMenu[items + 1].MenuItemType = MENU_ITEM_TYPE_END_OF_MENU;
+      benchmarkMenu[items + 1].MenuItemText = "";
+      benchmarkMenu[items + 1].MenuItemFunction = NULL;
+      benchmarkMenu[items + 1].MenuItemSubMenu = NULL;
+
+      snprintf(name, sizeof(name), "menu_%dcol_%ditems", columns, items);
+      startMeasurement();
+      ui.selectAndDrawMenu(benchmarkMenu, true);
+      endMeasurement(name);
+    }
+  }
+
+  //
+  // the last menu again, clipped to the bottom half of the screen, then clipped out
+  //
+  startMeasurement();
+  ui.pushClip(0, 120, 320, 120);
+  ui.selectAndDrawMenu(benchmarkMenu, true);
+  ui.popClip();
+  endMeasurement("menu_4col_16items_clip_half");
+
+  startMeasurement();
+  ui.pushClip(0, 0, 0, 0);
+  ui.selectAndDrawMenu(benchmarkMenu, true);
+  ui.popClip();
+  endMeasurement("menu_4col_16items_clip_all");
+}
+
+
+
+//
+// buttons, title bars and images
+//
+static void benchmarkWidgets(void)
+{
+  BUTTON button = {"Button", 160, 120, 140, 36};
+  BUTTON_EXTENDED buttonExt = {"Extended", 160, 120, 140, 36, LCD_DARKBLUE, LCD_LIGHTBLUE,
+    LCD_WHITE, LCD_WHITE, UI_Font_14_Bold};
+  IMAGE_BUTTON imageButton = {benchmarkImage, benchmarkImage, 160, 120, IMAGE_SIZE, IMAGE_SIZE};
+
+  for (int i = 0; i < IMAGE_SIZE * IMAGE_SIZE; i++)
+    benchmarkImage[i] = (uint16_t) (i * 37);
+
+  ui.clearDisplaySpace();
+
+  startMeasurement();
+  ui.drawTitleBar("Benchmark");
+  endMeasurement("drawTitleBar");
+
+  startMeasurement();
+  ui.drawTitleBarWithBackButton("Benchmark");
+  endMeasurement("drawTitleBarWithBackButton");
+
+  startMeasurement();
+  ui.clearDisplaySpace();
+  endMeasurement("clearDisplaySpace");
+
+  startMeasurement();
+  ui.drawButton(button);
+  endMeasurement("drawButton");
+
+  startMeasurement();
+  ui.drawButton(buttonExt);
+  endMeasurement("drawButton_extended");
+
+  startMeasurement();
+  ui.drawImageButton(imageButton);
+  endMeasurement("drawImageButton_48x48");
+
+  startMeasurement();
+  ui.lcdDrawImage(10, 40, IMAGE_SIZE, IMAGE_SIZE, benchmarkImage);
+  endMeasurement("lcdDrawImage_48x48");
+}
+
+
+
+//
+// the filled shapes: the slider, the title bar's Back button and its arrow, a 
+// submenu's arrow, and bigger shapes
+//
+static void benchmarkShapes(void)
+{
+  SLIDER slider = {"Slider", 50, 0, 100, 1, 160, 120, 200, 0};
+
+  ui.clearDisplaySpace();
+
+  startMeasurement();
+  ui.drawSlider(slider);
+  endMeasurement("drawSlider");
+
+  startMeasurement();
+  ui.lcdDrawFilledCircle(160, 120, 10, LCD_BLUE);
+  endMeasurement("lcdDrawFilledCircle_r10");
+
+  startMeasurement();
+  ui.lcdDrawFilledCircle(160, 120, 50, LCD_BLUE);
+  endMeasurement("lcdDrawFilledCircle_r50");
+
+  startMeasurement();
+  ui.lcdDrawFilledRoundedRectangle(4, 4, 70, 26, 6, LCD_BLUE);
+  endMeasurement("lcdDrawFilledRoundedRect_back");
+
+  startMeasurement();
+  ui.lcdDrawFilledRoundedRectangle(60, 60, 200, 120, 20, LCD_BLUE);
+  endMeasurement("lcdDrawFilledRoundedRect_big");
+
+  startMeasurement();
+  ui.lcdDrawFilledTriangle(100, 100, 108, 96, 108, 104, LCD_WHITE);
+  endMeasurement("lcdDrawFilledTriangle_arrow");
+
+  startMeasurement();
+  ui.lcdDrawFilledTriangle(40, 200, 280, 200, 160, 180, LCD_WHITE);
+  endMeasurement("lcdDrawFilledTriangle_wide");
+
+  startMeasurement();
+  ui.lcdDrawFilledTriangle(100, 40, 100, 200, 140, 120, LCD_WHITE);
+  endMeasurement("lcdDrawFilledTriangle_tall");
+}
+
+
+
+//
+// a line of text in each font
+//
+static void benchmarkText(void)
+{
+  char name[48];
+
+  for (unsigned int i = 0; i < sizeof(fonts) / sizeof(fonts[0]); i++)
+  {
+    ui.clearDisplaySpace();
+    ui.lcdSetFont(fonts[i].font);
+    ui.lcdSetCursorXY(10, 60);
+
+    snprintf(name, sizeof(name), "lcdPrint_Font_%s", fonts[i].name);
+    startMeasurement();
+    ui.lcdPrint("The quick brown fox 0123456789");
+    endMeasurement(name);
+  }
+}
+
+
+
+//
+// opening the numeric keypad, measured until it waits for the first touch
+//
+static void benchmarkNumericKeyPad(void)
+{
+  int value = 50;
+
+  startMeasurement();
+  if (setjmp(waitingForTouchJump) == 0)
+  {
+    hostSetTouchSampleCallback(uiIsWaitingForTouch);
+    ui.numericKeyPad("Enter a value", value, 0, 100);
+  }
+  endMeasurement("numericKeyPad_open");
+}
+
+
+// ---------------------------------------------------------------------------------
+//                               Reporting the results
+// ---------------------------------------------------------------------------------
+
+//
+// print the results
+//  Enter:  spiMHz = SPI clock used to compute the wire time
+//
+static void printResults(double spiMHz)
+{
+  printf("%-30s %8s %8s %9s %9s %11s\n", "benchmark", "trans", "windows", "bytes", "pixels", "wire us");
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const HOST_SPI_COUNTS &c = results[i].counts;
+    printf("%-30s %8lu %8lu %9lu %9lu %11.1f\n", results[i].name, c.transactions,
+      c.addressWindows, totalBytes(c), c.pixels, totalBytes(c) * 8.0 / spiMHz);
+  }
+  printf("(wire time at %.1f MHz SPI clock)\n", spiMHz);
+}
+
+
+
+//
+// save the results as a baseline, one benchmark per line
+//  Enter:  fileName -> baseline file to write
+//  Exit:   true returned on success
+//
+static bool saveBaseline(const char *fileName)
+{
+  FILE *f = fopen(fileName, "w");
+  if (f == NULL)
+    return(false);
+
+  fprintf(f, "# benchmark transactions addressWindows commandBytes dataBytes pixels\n");
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const HOST_SPI_COUNTS &c = results[i].counts;
+    fprintf(f, "%s %lu %lu %lu %lu %lu\n", results[i].name, c.transactions, c.addressWindows,
+      c.commandBytes, c.dataBytes, c.pixels);
+  }
+  fclose(f);
+  return(true);
+}
+
+
+
+//
+// check if a count grew beyond the tolerance
+//
+static bool isRegression(unsigned long count, unsigned long baseline, double tolerance)
+{
+  return(count > baseline * (1.0 + tolerance / 100.0));
+}
+
+
+
+//
+// compare the results with a baseline
+//  Enter:  fileName -> baseline file to read
+//          tolerance = percent a count may grow before it's a regression
+//  Exit:   number of regressions returned, -1 if the file can't be read
+//
+static int checkBaseline(const char *fileName, double tolerance)
+{
+  FILE *f = fopen(fileName, "r");
+  if (f == NULL)
+    return(-1);
+
+  std::vector<BENCHMARK_RESULT> baseline;
+  char line[200];
+  while (fgets(line, sizeof(line), f) != NULL)
+  {
+    BENCHMARK_RESULT b;
+    HOST_SPI_COUNTS &c = b.counts;
+    if (line[0] == '#')
+      continue;
+    if (sscanf(line, "%47s %lu %lu %lu %lu %lu", b.name, &c.transactions, &c.addressWindows,
+      &c.commandBytes, &c.dataBytes, &c.pixels) == 6)
+      baseline.push_back(b);
+  }
+  fclose(f);
+
+  int regressions = 0;
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const HOST_SPI_COUNTS &c = results[i].counts;
+    const BENCHMARK_RESULT *b = NULL;
+    for (size_t j = 0; j < baseline.size(); j++)
+    {
+      if (strcmp(baseline[j].name, results[i].name) == 0)
+        b = &baseline[j];
+    }
+
+    if (b == NULL)
+    {
+      printf("new:         %s is not in the baseline\n", results[i].name);
+      continue;
+    }
+
+    if (isRegression(c.transactions, b->counts.transactions, tolerance) ||
+        isRegression(c.addressWindows, b->counts.addressWindows, tolerance) ||
+        isRegression(totalBytes(c), totalBytes(b->counts), tolerance))
+    {
+      printf("REGRESSION:  %s  transactions %lu -> %lu, windows %lu -> %lu, bytes %lu -> %lu\n",
+        results[i].name, b->counts.transactions, c.transactions, b->counts.addressWindows,
+        c.addressWindows, totalBytes(b->counts), totalBytes(c));
+      regressions++;
+    }
+    else if (totalBytes(c) < totalBytes(b->counts))
+      printf("improved:    %s  bytes %lu -> %lu\n", results[i].name, totalBytes(b->counts), totalBytes(c));
+  }
+
+  return(regressions);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                      Main
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  double spiMHz = 40.0;
+  double tolerance = 0.0;
+  const char *saveFile = NULL;
+  const char *checkFile = NULL;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "--spi-mhz") == 0) && (i + 1 < argc))
+      spiMHz = atof(argv[++i]);
+    else if ((strcmp(argv[i], "--save") == 0) && (i + 1 < argc))
+      saveFile = argv[++i];
+    else if ((strcmp(argv[i], "--check") == 0) && (i + 1 < argc))
+      checkFile = argv[++i];
+    else if ((strcmp(argv[i], "--tolerance") == 0) && (i + 1 < argc))
+      tolerance = atof(argv[++i]);
+    else
+    {
+      fprintf(stderr, "usage: %s [--spi-mhz N] [--save file] [--check file] [--tolerance percent]\n", argv[0]);
+      return(2);
+    }
+  }
+
+  if (spiMHz <= 0.0)
+    spiMHz = 40.0;
+
+  ui.begin(LCD_CS_PIN, LCD_DC_PIN, TOUCH_CS_PIN, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT, UI_Font_13_Bold);
+  display = hostGetDisplay();
+
+  benchmarkMenus();
+  benchmarkWidgets();
+  benchmarkShapes();
+  benchmarkText();
+  benchmarkNumericKeyPad();
+
+  printResults(spiMHz);
+
+  if ((saveFile != NULL) && !saveBaseline(saveFile))
+  {
+    fprintf(stderr, "can't write %s\n", saveFile);
+    return(2);
+  }
+
+  if (checkFile != NULL)
+  {
+    int regressions = checkBaseline(checkFile, tolerance);
+    if (regressions < 0)
+    {
+      fprintf(stderr, "can't read %s\n", checkFile);
+      return(2);
+    }
+    if (regressions > 0)
+    {
+      printf("%d benchmark(s) regressed\n", regressions);
+      return(1);
+    }
+    printf("no regressions\n");
+  }
+
+  return(0);
+}
@@ -0,0 +1,333 @@
+//      ******************************************************************
+//      *                                                                *
+//      *          Renders every widget type to a set of images          *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Draws each of the library's widgets on its own screen and saves the screen as
+// a PPM image.  golden_images.sh compares these images, and screens from the
+// examples, with reference images to show that rendering changes are pixel exact.
+//
+// usage: UIGallery <output folder>
+//
+// Build:  extras/host/build_sketch.sh extras/host/UIGallery /tmp/UIGallery
+//
+
+#include <Arduino.h>
+#include <Adafruit_ILI9341.h>
+#include <TouchUserInterfaceForArduino.h>
+#include <UI_Fonts.h>
+#include "HostSim.h"
+#include <stdio.h>
+#include <setjmp.h>
+
+
+static TouchUserInterfaceForArduino ui;
+static const char *outputFolder;
+static int imagesSaved = 0;
+static bool saveFailedFlg = false;
+
+static const int LCD_CS_PIN   = 1;
+static const int LCD_DC_PIN   = 4;
+static const int TOUCH_CS_PIN = 5;
+
+static jmp_buf waitingForTouchJump;
+
+static const int IMAGE_SIZE = 48;
+static uint16_t galleryImage[IMAGE_SIZE * IMAGE_SIZE];
+static uint16_t galleryImageSelected[IMAGE_SIZE * IMAGE_SIZE];
+
+
+//
+// menus used by the gallery
+//
+static void toggleCallback(void);
+extern MENU_ITEM oneColumnMenu[];
+extern MENU_ITEM threeColumnMenu[];
+
+MENU_ITEM oneColumnMenu[] = {
+  {MENU_ITEM_TYPE_MAIN_MENU_HEADER,   "One Column Menu",       MENU_COLUMNS_1,   oneColumnMenu},
+  {MENU_ITEM_TYPE_COMMAND,            "First command",         NULL,             NULL},
+  {MENU_ITEM_TYPE_SUB_MENU,           "A sub menu",            NULL,             threeColumnMenu},
+  {MENU_ITEM_TYPE_TOGGLE,             "A toggle",              toggleCallback,   NULL},
+  {MENU_ITEM_TYPE_END_OF_MENU,        "",                      NULL,             NULL}
+};
+
+MENU_ITEM threeColumnMenu[] = {
+  {MENU_ITEM_TYPE_SUB_MENU_HEADER,    "Three Column Sub Menu", MENU_COLUMNS_3,   oneColumnMenu},
+  {MENU_ITEM_TYPE_COMMAND,            "One",                   NULL,             NULL},
+  {MENU_ITEM_TYPE_COMMAND,            "Two",                   NULL,             NULL},
+  {MENU_ITEM_TYPE_COMMAND,            "Three",                 NULL,             NULL},
+  {MENU_ITEM_TYPE_COMMAND,            "Four has a long label", NULL,             NULL},
+  {MENU_ITEM_TYPE_COMMAND,            "Five",                  NULL,             NULL},
+  {MENU_ITEM_TYPE_END_OF_MENU,        "",                      NULL,             NULL}
+};
+
+
+//
+// the fonts drawn on the text screen
+//
+static const byte *fonts[] =
+{
+  UI_Font_9, UI_Font_10, UI_Font_10_Bold, UI_Font_11, UI_Font_11_Bold, UI_Font_12_Bold,
+  UI_Font_13, UI_Font_13_Bold, UI_Font_14, UI_Font_14_Bold, UI_Font_15, UI_Font_15_Bold,
+  UI_Font_16_Bold
+};
+
+
+//
+// toggle button callback, the toggle is always "On"
+//
+static void toggleCallback(void)
+{
+  ui.toggleText = "On";
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                   Saving screens
+// ---------------------------------------------------------------------------------
+
+//
+// save the screen as an image in the output folder
+//  Enter:  name -> name of the image, without the .ppm
+//
+static void saveScreen(const char *name)
+{
+  char fileName[512];
+
+  snprintf(fileName, sizeof(fileName), "%s/%s.ppm", outputFolder, name);
+  if (hostGetDisplay()->hostSavePPM(fileName))
+    imagesSaved++;
+  else
+  {
+    fprintf(stderr, "can't write %s\n", fileName);
+    saveFailedFlg = true;
+  }
+}
+
+
+
+//
+// called when the touch screen is sampled, the UI has finished drawing and is
+// waiting for a touch, so jump back to the gallery
+//
+static void uiIsWaitingForTouch(void)
+{
+  hostSetTouchSampleCallback(NULL);
+  longjmp(waitingForTouchJump, 1);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                    The screens
+// ---------------------------------------------------------------------------------
+
+//
+// menus, with each kind of button and header
+//
+static void drawMenus(void)
+{
+  ui.selectAndDrawMenu(oneColumnMenu, true);
+  saveScreen("menu_1col");
+
+  ui.selectAndDrawMenu(threeColumnMenu, true);
+  saveScreen("menu_3col_submenu");
+
+  ui.setColorPaletteGray();
+  ui.selectAndDrawMenu(oneColumnMenu, true);
+  saveScreen("menu_gray_palette");
+  ui.setColorPaletteBlue();
+}
+
+
+
+//
+// title bars, buttons and image buttons
+//
+static void drawButtons(void)
+{
+  BUTTON button = {"Button", 80, 70, 120, 36};
+  BUTTON wrappedButton = {"A button with a long label", 240, 70, 120, 50};
+  BUTTON_EXTENDED buttonExt = {"Extended", 80, 130, 120, 36, LCD_DARKGREEN, LCD_GREEN,
+    LCD_WHITE, LCD_YELLOW, UI_Font_14_Bold};
+  IMAGE_BUTTON imageButton = {galleryImage, galleryImageSelected, 240, 150, IMAGE_SIZE, IMAGE_SIZE};
+
+  for (int y = 0; y < IMAGE_SIZE; y++)
+  {
+    for (int x = 0; x < IMAGE_SIZE; x++)
+    {
+      galleryImage[y * IMAGE_SIZE + x] = ui.lcdMakeColor(x * 5, y * 5, 128);
+      galleryImageSelected[y * IMAGE_SIZE + x] = ui.lcdMakeColor(255 - x * 5, y * 5, 64);
+    }
+  }
+
+  ui.drawTitleBarWithMenuButton("Title Bar With Menu Button");
+  ui.clearDisplaySpace();
+  ui.drawButton(button);
+  ui.drawButton(wrappedButton);
+  ui.drawButton(buttonExt);
+  ui.drawImageButton(imageButton);
+  saveScreen("buttons");
+
+  ui.drawTitleBarWithBackButton("Title Bar With Back Button");
+  ui.clearDisplaySpace(LCD_DARKGREY);
+  saveScreen("title_bar_back_button");
+}
+
+
+
+//
+// number boxes, selection boxes and sliders
+//
+static void drawValueWidgets(void)
+{
+  NUMBER_BOX numberBox = {"Integer", 25, 0, 100, 5, 80, 80, 130, 34};
+  NUMBER_BOX_FLOAT numberBoxFloat = {"Float", 2.5, 0.0, 10.0, 0.1, 1, 240, 80, 130, 34};
+  SELECTION_BOX selectionBox = {"Choice", 1, "Low", "Medium", "High", "", 160, 150, 260, 34};
+  SLIDER slider = {"Slider", 30, 0, 100, 1, 160, 210, 260, 0};
+
+  ui.drawTitleBar("Value Widgets");
+  ui.clearDisplaySpace();
+  ui.drawNumberBox(numberBox);
+  ui.drawNumberBox(numberBoxFloat);
+  ui.drawSelectionBox(selectionBox);
+  ui.drawSlider(slider);
+  saveScreen("value_widgets");
+}
+
+
+
+//
+// text in every font, and justified printing
+//
+static void drawText(void)
+{
+  ui.drawTitleBar("Fonts");
+  ui.clearDisplaySpace();
+
+  int y = 38;
+  for (unsigned int i = 0; i < sizeof(fonts) / sizeof(fonts[0]); i++)
+  {
+    ui.lcdSetFont(fonts[i]);
+    ui.lcdSetCursorXY(4, y);
+    ui.lcdPrint("Quick brown fox 0123 +-.");
+    y += ui.lcdGetFontHeightWithDecenders() + 1;
+  }
+  saveScreen("fonts");
+
+  ui.drawTitleBar("Printing");
+  ui.clearDisplaySpace();
+  ui.lcdSetFont(UI_Font_13_Bold);
+  ui.lcdSetFontColor(LCD_YELLOW);
+  ui.lcdSetCursorXY(160, 50);
+  ui.lcdPrintCentered("Centered");
+  ui.lcdSetCursorXY(310, 80);
+  ui.lcdPrintRightJustified(-12345);
+  ui.lcdSetCursorXY(10, 110);
+  ui.lcdPrint(3.14159, 3);
+  ui.lcdSetFontColor(LCD_WHITE);
+  saveScreen("printing");
+}
+
+
+
+//
+// lines, shapes and images
+//
+static void drawShapes(void)
+{
+  ui.drawTitleBar("Shapes");
+  ui.clearDisplaySpace();
+  ui.lcdDrawLine(10, 40, 150, 120, LCD_WHITE);
+  ui.lcdDrawRectangle(170, 40, 60, 40, LCD_RED);
+  ui.lcdDrawFilledRectangle(240, 40, 60, 40, LCD_GREEN);
+  ui.lcdDrawRoundedRectangle(10, 140, 70, 50, 10, LCD_CYAN);
+  ui.lcdDrawFilledRoundedRectangle(90, 140, 70, 50, 8, LCD_MAGENTA);
+  ui.lcdDrawCircle(200, 160, 25, LCD_YELLOW);
+  ui.lcdDrawFilledCircle(270, 160, 25, LCD_ORANGE);
+  ui.lcdDrawTriangle(20, 230, 60, 200, 100, 230, LCD_LIGHTBLUE);
+  ui.lcdDrawFilledTriangle(120, 230, 160, 200, 200, 235, LCD_OLIVE);
+  ui.lcdDrawImage(250, 190, IMAGE_SIZE, IMAGE_SIZE, galleryImage);
+  saveScreen("shapes");
+}
+
+
+
+//
+// text boxes: one whose lines all fit, with a newline, a blank line, a word too
+// long for the box that's broken in the middle, and trailing spaces, and one with
+// a scroll bar that's scrolled to its last page
+//
+static uint16_t shortTextLineStarts[20];
+static uint16_t longTextLineStarts[40];
+
+static void drawTextBoxes(void)
+{
+  static const char shortText[] = "First line\n\nAfter a blank line, "
+    "Pneumonoultramicroscopicsilicovolcanoconiosis is too long.   \nEnd";
+  static const char longText[] = "This text has more lines than fit in the box, so "
+    "it's wrapped narrower to leave room for the scroll bar.\nIt's scrolled to the "
+    "last page, so the first lines aren't shown, and the thumb is at the bottom of "
+    "the bar.  Touching the top half of the box scrolls up a page, touching the "
+    "bottom half scrolls down a page.\nThe last line.";
+  TEXT_BOX shortTextBox = {shortText, 82, 135, 150, 180, shortTextLineStarts, 20, 0, 0, NULL, NULL, 0};
+  TEXT_BOX longTextBox = {longText, 240, 135, 150, 120, longTextLineStarts, 40, 0, 0, NULL, NULL, 0};
+
+  ui.drawTitleBar("Text Boxes");
+  ui.clearDisplaySpace();
+  ui.lcdSetFont(UI_Font_10);
+  ui.lcdSetFontColor(LCD_WHITE);
+  ui.drawTextBox(shortTextBox);
+  ui.drawTextBox(longTextBox);
+  ui.scrollTextBox(longTextBox, 40);
+  saveScreen("text_boxes");
+}
+
+
+
+//
+// the numeric keypad, saved once it is waiting for the first touch
+//
+static void drawNumericKeyPad(void)
+{
+  float value = 12.5;
+
+  if (setjmp(waitingForTouchJump) == 0)
+  {
+    hostSetTouchSampleCallback(uiIsWaitingForTouch);
+    ui.numericKeyPad("Numeric Key Pad", value, -100.0, 100.0);
+  }
+  saveScreen("numeric_keypad");
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                      Main
+// ---------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: %s <output folder>\n", argv[0]);
+    return(2);
+  }
+  outputFolder = argv[1];
+
+  ui.begin(LCD_CS_PIN, LCD_DC_PIN, TOUCH_CS_PIN, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT, UI_Font_13_Bold);
+
+  drawMenus();
+  drawButtons();
+  drawValueWidgets();
+  drawText();
+  drawShapes();
+  drawTextBoxes();
+  drawNumericKeyPad();
+
+  printf("%d images saved in %s\n", imagesSaved, outputFolder);
+  return(saveFailedFlg ? 1 : 0);
+}
@@ -0,0 +1,255 @@
+//      ******************************************************************
+//      *                                                                *
+//      *            Host stand-in for XPT2046_Touchscreen.h             *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+#include "XPT2046_Touchscreen.h"
+#include "HostSim.h"
+#include <stdio.h>
+#include <vector>
+
+struct HOST_TOUCH
+{
+  unsigned long startMillis;
+  unsigned long durationMillis;
+  int lcdX;
+  int lcdY;
+};
+
+static std::vector<HOST_TOUCH> touchScript;
+
+struct HOST_RAW_SAMPLE
+{
+  unsigned long time;
+  bool touchedFlg;
+  int16_t xRaw;
+  int16_t yRaw;
+};
+
+static std::vector<HOST_RAW_SAMPLE> rawSamples;
+static unsigned long rawSamplesStartMillis;
+static unsigned long touchSampleMicros = 200;
+static void (*touchSampleCallback)(void) = NULL;
+
+
+//
+// default calibration constants indexed by LCD orientation, these match
+// setDefaultTouchScreenCalibrationConstants() in the library
+//
+static const struct { int offsetX; float scalerX; int offsetY; float scalerY; } calibration[4] =
+{
+  {16, 14.90, 17, 11.07},
+  {17, 11.07, 20, 14.90},
+  {20, 14.90, 35, 11.07},
+  {35, 11.06, 19, 14.84}
+};
+
+
+//
+// add a press to the touch script
+//  Enter:  startMillis = time of the press on the virtual clock, in ms
+//          durationMillis = how long the screen is held, in ms
+//          lcdX, lcdY = LCD coordinates of the press
+//
+void hostAddTouch(unsigned long startMillis, unsigned long durationMillis, int lcdX, int lcdY)
+{
+  HOST_TOUCH t = {startMillis, durationMillis, lcdX, lcdY};
+  touchScript.push_back(t);
+}
+
+
+
+//
+// remove all presses from the touch script
+//
+void hostClearTouches(void)
+{
+  touchScript.clear();
+}
+
+
+
+//
+// set how far the virtual clock advances each time the touch screen is sampled
+//
+void hostSetTouchSampleMicros(unsigned long us)
+{
+  touchSampleMicros = us;
+}
+
+
+
+//
+// set a function called each time the touch screen is sampled, the tools use
+// this to learn when the UI has finished drawing and is waiting for a touch
+//  Enter:  onSample -> function to call, NULL for none
+//
+void hostSetTouchSampleCallback(void (*onSample)(void))
+{
+  touchSampleCallback = onSample;
+}
+
+
+
+//
+// load a touch script, one press per line: "startMillis durationMillis x y",
+// lines starting with # are comments
+//
+bool hostLoadTouchScript(const char *fileName)
+{
+  FILE *f = fopen(fileName, "r");
+  if (f == NULL)
+    return(false);
+
+  char line[200];
+  while (fgets(line, sizeof(line), f) != NULL)
+  {
+    unsigned long start, duration;
+    int x, y;
+    if (line[0] == '#')
+      continue;
+    if (sscanf(line, "%lu %lu %d %d", &start, &duration, &x, &y) == 4)
+      hostAddTouch(start, duration, x, y);
+  }
+  fclose(f);
+  return(true);
+}
+
+
+
+//
+// load a recording printed by the library's printTouchRecording(), the raw 
+// samples are played back through the touch screen from startMillis on
+//  Enter:  fileName -> the recording, one "{time, true/false, xRaw, yRaw}," per line
+//          startMillis = time on the virtual clock to start the playback, in ms
+//
+bool hostLoadTouchSamples(const char *fileName, unsigned long startMillis)
+{
+  FILE *f = fopen(fileName, "r");
+  if (f == NULL)
+    return(false);
+
+  rawSamples.clear();
+  rawSamplesStartMillis = startMillis;
+
+  char line[200];
+  while (fgets(line, sizeof(line), f) != NULL)
+  {
+    unsigned long time;
+    char touched[8];
+    int x, y;
+    if (sscanf(line, " {%lu, %7[a-z], %d, %d}", &time, touched, &x, &y) == 4)
+    {
+      HOST_RAW_SAMPLE sample = {time, strcmp(touched, "true") == 0, (int16_t) x, (int16_t) y};
+      rawSamples.push_back(sample);
+    }
+  }
+  fclose(f);
+  return(true);
+}
+
+
+
+//
+// get the recorded raw sample at this time, NULL if none or not touched
+//
+static const HOST_RAW_SAMPLE *currentRawSample(void)
+{
+  unsigned long now = (unsigned long) (hostGetMicros() / 1000ULL);
+  const HOST_RAW_SAMPLE *current = NULL;
+
+  if (rawSamples.empty() || (now < rawSamplesStartMillis))
+    return(NULL);
+
+  for (size_t i = 0; i < rawSamples.size(); i++)
+  {
+    if (rawSamplesStartMillis + rawSamples[i].time > now)
+      break;
+    current = &rawSamples[i];
+  }
+
+  if ((current == NULL) || !current->touchedFlg)
+    return(NULL);
+  return(current);
+}
+
+
+
+//
+// get the press in the touch script happening now, NULL if none
+//
+static const HOST_TOUCH *currentTouch(void)
+{
+  unsigned long now = (unsigned long) (hostGetMicros() / 1000ULL);
+  for (size_t i = 0; i < touchScript.size(); i++)
+  {
+    if ((now >= touchScript[i].startMillis) && 
+        (now < touchScript[i].startMillis + touchScript[i].durationMillis))
+      return(&touchScript[i]);
+  }
+  return(NULL);
+}
+
+
+
+//
+// constructor, the pins are ignored
+//
+XPT2046_Touchscreen::XPT2046_Touchscreen(uint8_t cspin, uint8_t tirq)
+{
+  (void) cspin; (void) tirq;
+  rotation = 1;
+}
+
+
+
+//
+// sampling the touch screen takes time, so each sample advances the clock
+//
+bool XPT2046_Touchscreen::touched(void)
+{
+  hostAdvanceMicros(touchSampleMicros);
+  hostEndDisplayFrame();
+  if (touchSampleCallback != NULL)
+    touchSampleCallback();
+  return((currentTouch() != NULL) || (currentRawSample() != NULL));
+}
+
+
+
+//
+// get the raw touch screen values of the press happening now
+//
+TS_Point XPT2046_Touchscreen::getPoint(void)
+{
+  const HOST_RAW_SAMPLE *sample = currentRawSample();
+  if (sample != NULL)
+    return(TS_Point(sample->xRaw, sample->yRaw, 1000));
+
+  const HOST_TOUCH *t = currentTouch();
+  if (t == NULL)
+    return(TS_Point(0, 0, 0));
+
+  int orientation = (rotation + 2) % 4;
+  int16_t x = (int16_t) ((t->lcdX + calibration[orientation].offsetX) * calibration[orientation].scalerX + 
+    calibration[orientation].scalerX / 2);
+  int16_t y = (int16_t) ((t->lcdY + calibration[orientation].offsetY) * calibration[orientation].scalerY + 
+    calibration[orientation].scalerY / 2);
+  return(TS_Point(x, y, 1000));
+}
+
+
+
+//
+// get the raw touch values
+//
+void XPT2046_Touchscreen::readData(uint16_t *x, uint16_t *y, uint8_t *z)
+{
+  TS_Point p = getPoint();
+  *x = p.x;
+  *y = p.y;
+  *z = p.z > 255 ? 255 : p.z;
+}
@@ -0,0 +1,49 @@
+//      ******************************************************************
+//      *                                                                *
+//      *            Host stand-in for XPT2046_Touchscreen.h             *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Touches come from a script of timed presses given in LCD coordinates.  They
+// are converted back to raw touch screen values using the library's default
+// calibration constants for the current orientation.
+//
+
+#ifndef _XPT2046_Touchscreen_h_
+#define _XPT2046_Touchscreen_h_
+
+#include <Arduino.h>
+#include <SPI.h>
+
+class TS_Point
+{
+  public:
+    TS_Point(void) : x(0), y(0), z(0) {}
+    TS_Point(int16_t x, int16_t y, int16_t z) : x(x), y(y), z(z) {}
+    bool operator==(TS_Point p) { return((p.x == x) && (p.y == y) && (p.z == z)); }
+    bool operator!=(TS_Point p) { return((p.x != x) || (p.y != y) || (p.z != z)); }
+    int16_t x, y, z;
+};
+
+class XPT2046_Touchscreen
+{
+  public:
+    XPT2046_Touchscreen(uint8_t cspin, uint8_t tirq = 255);
+    bool begin(void) { return(true); }
+    bool begin(SPIClass &wspi) { (void) wspi; return(true); }
+    TS_Point getPoint(void);
+    bool tirqTouched(void) { return(touched()); }
+    bool touched(void);
+    void readData(uint16_t *x, uint16_t *y, uint8_t *z);
+    bool bufferEmpty(void) { return(true); }
+    uint8_t bufferSize(void) { return(1); }
+    void setRotation(uint8_t n) { rotation = n % 4; }
+
+  private:
+    uint8_t rotation;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#!/bin/sh
+#
+# Build an Arduino sketch, the TouchUserInterfaceForArduino library, and the 
+# host stand-ins into a program that runs on a Linux workstation
+#
+#   usage: extras/host/build_sketch.sh <sketch folder> [output program]
+#
+#   ie:    extras/host/build_sketch.sh examples/Example01_SimpleMenu /tmp/Example01
+#          /tmp/Example01 --run-ms 3000 --touch "1000 150 160 200" --screenshot /tmp/e1.ppm
+#
+# A folder without a .ino file is built as a host program: its .cpp files are 
+# compiled with the library and must supply main() (ie extras/host/UIBenchmark).
+#
+set -e
+
+if [ $# -lt 1 ]; then
+  echo "usage: $0 <sketch folder> [output program]" >&2
+  exit 1
+fi
+
+HOST_DIR=$(cd "$(dirname "$0")" && pwd)
+LIBRARY_DIR=$(cd "$HOST_DIR/../../src" && pwd)
+SKETCH_DIR=$(cd "$1" && pwd)
+SKETCH_NAME=$(basename "$SKETCH_DIR")
+OUTPUT=${2:-./$SKETCH_NAME}
+
+BUILD_DIR=$(mktemp -d)
+trap 'rm -rf "$BUILD_DIR"' EXIT
+
+CC=${CC:-gcc}
+CXX=${CXX:-g++}
+FLAGS="-g -O1 -Wall -Wno-unused-variable -DPROGMEM= -I$HOST_DIR -I$LIBRARY_DIR -I$SKETCH_DIR $EXTRA_FLAGS"
+
+SKETCH_MAIN=yes
+if [ -e "$SKETCH_DIR/$SKETCH_NAME.ino" ]; then
+  python3 "$HOST_DIR/ino2cpp.py" "$SKETCH_DIR/$SKETCH_NAME.ino" "$BUILD_DIR/$SKETCH_NAME.ino.cpp"
+else
+  SKETCH_MAIN=
+fi
+
+for SOURCE in "$LIBRARY_DIR"/*.c "$SKETCH_DIR"/*.c; do
+  [ -e "$SOURCE" ] || continue
+  $CC $FLAGS -c "$SOURCE" -o "$BUILD_DIR/$(basename "$SOURCE").o"
+done
+
+for SOURCE in "$HOST_DIR"/*.cpp "$LIBRARY_DIR"/*.cpp "$SKETCH_DIR"/*.cpp "$BUILD_DIR/$SKETCH_NAME.ino.cpp"; do
+  [ -e "$SOURCE" ] || continue
+  if [ -z "$SKETCH_MAIN" ] && [ "$(basename "$SOURCE")" = "HostSketchMain.cpp" ]; then
+    continue
+  fi
+  $CXX -std=gnu++11 $FLAGS -c "$SOURCE" -o "$BUILD_DIR/$(basename "$SOURCE").o"
+done
+
+$CXX -rdynamic -pthread -o "$OUTPUT" "$BUILD_DIR"/*.o
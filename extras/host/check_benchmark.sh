@@ -0,0 +1,33 @@
+#!/bin/sh
+#
+# Build UIBenchmark and compare its draw costs with the baseline committed in
+# extras/host/UIBenchmark/baseline.txt
+#
+#   usage: extras/host/check_benchmark.sh [--save]
+#
+# Exits with 1 if any benchmark's transactions, address windows or bytes went up.
+# After a change that makes drawing cheaper, or adds a benchmark, run it with
+# --save to update the baseline, and commit the baseline with the change.
+#
+set -e
+
+if [ $# -gt 1 ] || { [ $# -eq 1 ] && [ "$1" != "--save" ]; }; then
+  echo "usage: $0 [--save]" >&2
+  exit 2
+fi
+
+HOST_DIR=$(cd "$(dirname "$0")" && pwd)
+BASELINE="$HOST_DIR/UIBenchmark/baseline.txt"
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+"$HOST_DIR/build_sketch.sh" "$HOST_DIR/UIBenchmark" "$WORK_DIR/UIBenchmark"
+
+if [ "$1" = "--save" ]; then
+  "$WORK_DIR/UIBenchmark" --save "$BASELINE" > /dev/null
+  echo "baseline saved in $BASELINE"
+  exit 0
+fi
+
+"$WORK_DIR/UIBenchmark" --check "$BASELINE"
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+#
+# Compare two images pixel for pixel, each can be a binary PPM (P6) or a PNG
+#
+#   usage: compare_ppm.py <reference.ppm|.png> <image.ppm|.png> [diff.ppm]
+#
+# Exits with 0 if the images are identical, 1 if they differ, 2 if either can't
+# be read.  When they differ and a diff file is given, a diff image is written:
+# matching pixels are dimmed gray copies of the reference, differing pixels are
+# bright red.
+#
+# The PNG functions only handle what write_png() writes, and what other tools 
+# write for 8 bit RGB images: no palette, alpha or interlacing.
+#
+import struct
+import sys
+import zlib
+
+
+PNG_SIGNATURE = b'\x89PNG\r\n\x1a\n'
+
+
+def read_ppm(file_name):
+    with open(file_name, 'rb') as f:
+        data = f.read()
+
+    # the header is "P6 <width> <height> <maxval>" followed by one whitespace byte
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            while data[pos:pos + 1] not in (b'\n', b''):
+                pos += 1
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    if fields[0] != b'P6':
+        raise ValueError('%s is not a binary PPM' % file_name)
+
+    width, height = int(fields[1]), int(fields[2])
+    pixels = data[pos + 1:pos + 1 + width * height * 3]
+    if len(pixels) != width * height * 3:
+        raise ValueError('%s is truncated' % file_name)
+    return width, height, pixels
+
+
+def write_ppm(file_name, width, height, pixels):
+    with open(file_name, 'wb') as f:
+        f.write(b'P6\n%d %d\n255\n' % (width, height))
+        f.write(pixels)
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    if pb <= pc:
+        return b
+    return c
+
+
+def read_png(file_name):
+    with open(file_name, 'rb') as f:
+        data = f.read()
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError('%s is not a PNG' % file_name)
+
+    pos = 8
+    header = None
+    compressed = b''
+    while pos < len(data):
+        length, chunk_type = struct.unpack('>I4s', data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if chunk_type == b'IHDR':
+            header = struct.unpack('>IIBBBBB', chunk)
+        elif chunk_type == b'IDAT':
+            compressed += chunk
+        elif chunk_type == b'IEND':
+            break
+
+    if header is None or header[2:] != (8, 2, 0, 0, 0):
+        raise ValueError('%s is not an 8 bit RGB PNG without interlacing' % file_name)
+
+    #
+    # undo the filter on each row
+    #
+    width, height = header[0], header[1]
+    stride = width * 3
+    raw = zlib.decompress(compressed)
+    pixels = bytearray(stride * height)
+    previous = bytearray(stride)
+    for y in range(height):
+        filter_type = raw[y * (stride + 1)]
+        row = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            left = row[i - 3] if i >= 3 else 0
+            up = previous[i]
+            up_left = previous[i - 3] if i >= 3 else 0
+            if filter_type == 1:
+                row[i] = (row[i] + left) & 0xff
+            elif filter_type == 2:
+                row[i] = (row[i] + up) & 0xff
+            elif filter_type == 3:
+                row[i] = (row[i] + ((left + up) >> 1)) & 0xff
+            elif filter_type == 4:
+                row[i] = (row[i] + paeth(left, up, up_left)) & 0xff
+        pixels[y * stride:(y + 1) * stride] = row
+        previous = row
+    return width, height, bytes(pixels)
+
+
+def write_png(file_name, width, height, pixels):
+    def chunk(chunk_type, data):
+        return (struct.pack('>I', len(data)) + chunk_type + data +
+                struct.pack('>I', zlib.crc32(chunk_type + data) & 0xffffffff))
+
+    #
+    # each row is stored with no filter, the screens are mostly flat colors that 
+    # compress well without one
+    #
+    stride = width * 3
+    raw = b''.join(b'\x00' + pixels[y * stride:(y + 1) * stride] for y in range(height))
+    with open(file_name, 'wb') as f:
+        f.write(PNG_SIGNATURE)
+        f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b'IDAT', zlib.compress(raw, 9)))
+        f.write(chunk(b'IEND', b''))
+
+
+def read_image(file_name):
+    with open(file_name, 'rb') as f:
+        signature = f.read(8)
+    if signature == PNG_SIGNATURE:
+        return read_png(file_name)
+    return read_ppm(file_name)
+
+
+def main():
+    if len(sys.argv) not in (3, 4):
+        print('usage: compare_ppm.py <reference.ppm|.png> <image.ppm|.png> [diff.ppm]', file=sys.stderr)
+        return 2
+
+    try:
+        ref_width, ref_height, ref = read_image(sys.argv[1])
+        width, height, image = read_image(sys.argv[2])
+    except (OSError, ValueError, struct.error, zlib.error) as e:
+        print(e, file=sys.stderr)
+        return 2
+
+    if (ref_width, ref_height) != (width, height):
+        print('size differs: %dx%d, expected %dx%d' % (width, height, ref_width, ref_height))
+        return 1
+
+    if ref == image:
+        return 0
+
+    diff = bytearray(len(ref))
+    different = 0
+    min_x, min_y, max_x, max_y = width, height, -1, -1
+    for i in range(0, len(ref), 3):
+        if ref[i:i + 3] == image[i:i + 3]:
+            gray = (ref[i] + ref[i + 1] + ref[i + 2]) // 9
+            diff[i:i + 3] = bytes((gray, gray, gray))
+        else:
+            diff[i:i + 3] = b'\xff\x00\x00'
+            different += 1
+            x, y = (i // 3) % width, (i // 3) // width
+            min_x, min_y = min(min_x, x), min(min_y, y)
+            max_x, max_y = max(max_x, x), max(max_y, y)
+
+    print('%d pixels differ, within x %d..%d, y %d..%d' % (different, min_x, max_x, min_y, max_y))
+    if len(sys.argv) == 4:
+        write_ppm(sys.argv[3], width, height, bytes(diff))
+    return 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
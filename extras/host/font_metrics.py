@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+#
+# Generate src/UI_FontMetrics.h from the font tables in src/UI_Fonts.c, giving the
+# width of each character as constexpr tables so UI_TEXT() can measure labels when
+# the sketch is compiled
+#
+#   usage: font_metrics.py [UI_Fonts.c] [UI_FontMetrics.h]
+#
+#   ie:    extras/host/font_metrics.py
+#
+# Run this after changing or adding a font.  For each font UI_Font_xx, the header
+# gets UI_Font_xx_Widths[]: the pixels added after each character, then the width
+# of each character from 0x20 to 0x7f.
+#
+import os
+import re
+import sys
+
+
+FONT_TABLE_PAD_AFTER_CHAR_IDX = 1
+FONT_TABLE_CHAR_LOOKUP_IDX = 5
+CHARACTER_COUNT = 96
+
+HEADER_START = """//      ******************************************************************
+//      *                                                                *
+//      *          Character widths of the UI fonts, for UI_TEXT()       *
+//      *                                                                *
+//      *               Copyright (c) S. Reifel & Co,  2023              *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Generated by extras/host/font_metrics.py from UI_Fonts.c, don't edit.  For each
+// font: the pixels added after each character, then the widths of the characters
+// 0x20 to 0x7f.  These are only read when compiling.
+//
+
+#ifndef UI_FontMetrics_h
+#define UI_FontMetrics_h
+
+"""
+
+HEADER_END = """
+#endif
+"""
+
+
+def read_fonts(file_name):
+    with open(file_name, newline='') as f:
+        source = f.read().replace('\r\n', '\n')
+
+    fonts = []
+    for match in re.finditer(r'const\s+(?:PROGMEM\s+)?byte\s+(UI_Font_\w+)\[\]\s*=\s*\{(.*?)\};', source, re.S):
+        name = match.group(1)
+        if any(font[0] == name for font in fonts):
+            continue
+        body = match.group(2).split('{')[-1]
+        body = re.sub(r'//[^\n]*|#[^\n]*', '', body)
+        table = [int(value, 0) for value in re.findall(r'0x[0-9A-Fa-f]+|\d+', body)]
+        fonts.append((name, table))
+    return fonts
+
+
+def character_widths(table):
+    widths = [table[FONT_TABLE_PAD_AFTER_CHAR_IDX]]
+    for c in range(CHARACTER_COUNT):
+        lookupIdx = FONT_TABLE_CHAR_LOOKUP_IDX + c * 2
+        pixelsIdx = table[lookupIdx] + (table[lookupIdx + 1] << 8)
+        widths.append(table[pixelsIdx])
+    return widths
+
+
+def main():
+    srcDir = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'src')
+    fontsFile = sys.argv[1] if len(sys.argv) > 1 else os.path.join(srcDir, 'UI_Fonts.c')
+    headerFile = sys.argv[2] if len(sys.argv) > 2 else os.path.join(srcDir, 'UI_FontMetrics.h')
+
+    fonts = read_fonts(fontsFile)
+    if not fonts:
+        print('no font tables found in %s' % fontsFile, file=sys.stderr)
+        return 1
+
+    lines = [HEADER_START]
+    for name, table in fonts:
+        widths = character_widths(table)
+        lines.append('constexpr byte %s_Widths[] = {\n' % name)
+        lines.append('\t%d,\n' % widths[0])
+        for row in range(0, CHARACTER_COUNT, 16):
+            lines.append('\t' + ' '.join('%d,' % w for w in widths[1 + row:17 + row]) + '\n')
+        lines.append('};\n\n')
+    lines.append(HEADER_END)
+
+    with open(headerFile, 'w', newline='') as f:
+        f.write(''.join(lines).replace('\n', '\r\n'))
+    print('%d fonts written to %s' % (len(fonts), headerFile))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
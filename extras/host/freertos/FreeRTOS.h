@@ -0,0 +1,34 @@
+//      ******************************************************************
+//      *                                                                *
+//      *               Host stand-in for ESP32's FreeRTOS.h             *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// The parts of FreeRTOS used by the library's ESP32 code, so it can be built with
+// -DARDUINO_ARCH_ESP32 and run on the host.  The ESP32's Arduino.h includes these
+// headers, and so does the host's.  Tasks are threads that take turns, only one 
+// runs at a time (see FreeRTOS.cpp).
+//
+
+#ifndef FreeRTOS_h
+#define FreeRTOS_h
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+
+#define portMAX_DELAY ((TickType_t) 0xffffffff)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t) (ms) / portTICK_PERIOD_MS)
+
+#endif
@@ -0,0 +1,20 @@
+//      ******************************************************************
+//      *                                                                *
+//      *               Host stand-in for ESP32's semphr.h               *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+#ifndef semphr_h
+#define semphr_h
+
+#include "FreeRTOS.h"
+
+typedef struct HOST_SEMAPHORE *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticksToWait);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex);
+
+#endif
@@ -0,0 +1,21 @@
+//      ******************************************************************
+//      *                                                                *
+//      *                Host stand-in for ESP32's task.h                *
+//      *                                                                *
+//      *              Copyright (c) S. Reifel & Co,  2023               *
+//      *                                                                *
+//      ******************************************************************
+
+#ifndef task_h
+#define task_h
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *parameter);
+typedef struct HOST_TASK *TaskHandle_t;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t taskFunction, const char *name, uint32_t stackDepth, 
+  void *parameter, UBaseType_t priority, TaskHandle_t *createdTask, BaseType_t coreID);
+void vTaskDelay(TickType_t ticks);
+
+#endif
@@ -0,0 +1,107 @@
+#!/bin/sh
+#
+# Render every widget type and screens from each example, then save them as 
+# reference images or compare them with the references
+#
+#   usage: extras/host/golden_images.sh save [reference folder]
+#          extras/host/golden_images.sh check [reference folder] [diff folder]
+#
+# The references committed with the library are in extras/host/GoldenImages, 
+# they're used when no reference folder is given.  check exits with 1 if any 
+# image differs from its reference, and puts the new image and a diff image for
+# each one into the diff folder (the differing pixels are red).  After a change 
+# that's meant to draw differently, save the new references and commit them with
+# the change.  References are saved as PNG, but PPM references are read too.
+#
+set -e
+
+if [ $# -lt 1 ] || { [ "$1" != "save" ] && [ "$1" != "check" ]; }; then
+  echo "usage: $0 save [reference folder]" >&2
+  echo "       $0 check [reference folder] [diff folder]" >&2
+  exit 2
+fi
+
+HOST_DIR=$(cd "$(dirname "$0")" && pwd)
+MODE=$1
+REFERENCE_DIR=${2:-$HOST_DIR/GoldenImages}
+DIFF_DIR=${3:-${TMPDIR:-/tmp}/golden_image_diffs}
+EXAMPLES_DIR=$(cd "$HOST_DIR/../../examples" && pwd)
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+mkdir -p "$WORK_DIR/images"
+
+#
+# the widgets
+#
+"$HOST_DIR/build_sketch.sh" "$HOST_DIR/UIGallery" "$WORK_DIR/UIGallery"
+"$WORK_DIR/UIGallery" "$WORK_DIR/images" > /dev/null
+
+#
+# the example screens: image name, example, and the touch (start duration x y) 
+# that brings up the screen, the screen is saved 3 seconds into the run
+#
+while read -r NAME EXAMPLE TOUCH; do
+  [ -n "$NAME" ] || continue
+  if [ ! -x "$WORK_DIR/$EXAMPLE" ]; then
+    "$HOST_DIR/build_sketch.sh" "$EXAMPLES_DIR/$EXAMPLE" "$WORK_DIR/$EXAMPLE"
+  fi
+  if [ -n "$TOUCH" ]; then
+    "$WORK_DIR/$EXAMPLE" --run-ms 3000 --touch "$TOUCH" --screenshot "$WORK_DIR/images/$NAME.ppm" > /dev/null
+  else
+    "$WORK_DIR/$EXAMPLE" --run-ms 3000 --screenshot "$WORK_DIR/images/$NAME.ppm" > /dev/null
+  fi
+done <<SCREENS
+Example01_menu          Example01_SimpleMenu
+Example01_shapes        Example01_SimpleMenu              1000 150 160 200
+Example02_menu          Example02_SetDisplayOrientation
+Example03_menu          Example03_MenusWithColumns
+Example04_menu          Example04_SettingTheMenuColor
+Example05_menu          Example05_ScreensWithInformation
+Example06_menu          Example06_GetNumbersAndValues
+Example06_number_box    Example06_GetNumbersAndValues     1000 150 80 65
+Example06_key_pad       Example06_GetNumbersAndValues     1000 150 80 110
+Example06_slider        Example06_GetNumbersAndValues     1000 150 80 160
+Example06_choice        Example06_GetNumbersAndValues     1000 150 235 160
+Example07_menu          Example07_MenuWithSubMenus
+Example08_menu          Example08_StopWatch
+Example09_menu          Example09_ImageButtons
+SCREENS
+
+#
+# save the references
+#
+if [ "$MODE" = "save" ]; then
+  mkdir -p "$REFERENCE_DIR"
+  python3 "$HOST_DIR/ppm_to_png.py" "$WORK_DIR"/images/*.ppm "$REFERENCE_DIR"
+  echo "$(ls "$WORK_DIR"/images | wc -l) reference images saved in $REFERENCE_DIR"
+  exit 0
+fi
+
+#
+# compare with the references
+#
+FAILED=0
+for IMAGE in "$WORK_DIR"/images/*.ppm; do
+  NAME=$(basename "$IMAGE" .ppm)
+  REFERENCE="$REFERENCE_DIR/$NAME.png"
+  [ -e "$REFERENCE" ] || REFERENCE="$REFERENCE_DIR/$NAME.ppm"
+  if [ ! -e "$REFERENCE" ]; then
+    echo "new:       $NAME has no reference image"
+    continue
+  fi
+  mkdir -p "$DIFF_DIR"
+  if RESULT=$(python3 "$HOST_DIR/compare_ppm.py" "$REFERENCE" "$IMAGE" "$DIFF_DIR/$NAME.diff.ppm"); then
+    rm -f "$DIFF_DIR/$NAME.diff.ppm"
+  else
+    echo "DIFFERS:   $NAME  $RESULT"
+    cp "$IMAGE" "$DIFF_DIR/$NAME.ppm"
+    FAILED=$((FAILED + 1))
+  fi
+done
+
+if [ $FAILED -ne 0 ]; then
+  echo "$FAILED image(s) differ, see $DIFF_DIR"
+  exit 1
+fi
+echo "all images match the references"
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+#
+# Turn an Arduino sketch (.ino) into a C++ file the way the Arduino IDE does:
+# include Arduino.h and add prototypes for the sketch's functions, so it can
+# be compiled for the host
+#
+#   usage: ino2cpp.py sketch.ino output.cpp
+#
+import re
+import sys
+
+
+def strip_comments(text):
+    text = re.sub(r'/\*.*?\*/', lambda m: '\n' * m.group(0).count('\n'), text, flags=re.S)
+    return re.sub(r'//[^\n]*', '', text)
+
+
+def find_prototypes(text):
+    code = strip_comments(text)
+    prototypes = []
+    depth = 0
+    statement = ''
+    for ch in code:
+        if ch == '{':
+            if depth == 0:
+                match = re.match(r'^\s*([A-Za-z_][\w\s\*&:<>,]*?[\s\*&]+)([A-Za-z_]\w*)\s*\(([^;]*)\)\s*$',
+                                 statement, flags=re.S)
+                if match and match.group(1).split()[0] not in ('struct', 'class', 'enum', 'union', 'namespace'):
+                    prototypes.append('%s%s(%s);' % (' '.join(match.group(1).split()) + ' ',
+                                                     match.group(2), ' '.join(match.group(3).split())))
+            depth += 1
+            statement = ''
+        elif ch == '}':
+            depth -= 1
+            statement = ''
+        elif ch == ';' and depth == 0:
+            statement = ''
+        elif depth == 0:
+            statement += ch
+    return prototypes
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write('usage: ino2cpp.py sketch.ino output.cpp\n')
+        return 1
+
+    with open(sys.argv[1]) as f:
+        text = f.read()
+
+    lines = text.split('\n')
+    last_include = 0
+    for i, line in enumerate(lines):
+        if line.strip().startswith('#include'):
+            last_include = i + 1
+
+    prototypes = find_prototypes(text)
+    output = ['#include <Arduino.h>', '#line 1 "%s"' % sys.argv[1]]
+    output += lines[:last_include]
+    output += prototypes
+    output.append('#line %d "%s"' % (last_include + 1, sys.argv[1]))
+    output += lines[last_include:]
+
+    with open(sys.argv[2], 'w') as f:
+        f.write('\n'.join(output))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
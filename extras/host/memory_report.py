@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+#
+# Report the static RAM and flash used by each feature of the library (fonts, the
+# configuration cache, tracing...), the drivers and the sketch's images, from the
+# symbols in a linked program
+#
+#   usage: memory_report.py <program or .elf> [--nm tool] [--symbols]
+#
+#   ie:    extras/host/memory_report.py /tmp/Example09
+#          extras/host/memory_report.py Example09.ino.elf --nm arm-none-eabi-nm
+#
+# For a device build, use the .elf the Arduino IDE leaves in its build folder
+# ("Sketch > Export Compiled Binary", or the path shown with verbose output) and
+# the nm from the board's toolchain (arm-none-eabi-nm for the RP2040,
+# xtensa-esp32-elf-nm for the ESP32).  A device build only links the fonts and
+# images a sketch uses; the host build links every font.
+#
+# nm's symbol types give where each symbol lives:
+#     b B      zeroed data              RAM
+#     d D      initialized data         RAM, and flash for the initial values
+#     r R      constants                flash
+#     t T w W  code                     flash
+#
+import re
+import subprocess
+import sys
+from collections import OrderedDict
+
+
+#
+# feature: pattern matching the names of its symbols, the first match is used
+#
+FEATURES = OrderedDict([
+    ('fonts',                      r'^UI_Font_'),
+    ('configuration cache',        r'^configuration'),
+    ('profiler',                   r'^profile'),
+    ('performance overlay',        r'PerformanceOverlay|LcdBusyTimer'),
+    ('trace',                      r'^(trace|addTraceEvent)'),
+    ('stack measurement',          r'^(stack|paintStack|updateStackHighWater)'),
+    ('touch recording and replay', r'^touch(Recording|Replay)'),
+    ('thread safe drawing',        r'^(busLock|busUnlock|busMutex|lockBusMutex|unlockBusMutex)'),
+    ('render queue',               r'^(renderQueue|renderTask|queueRenderCommand|spiBus|lockSPIBus|unlockSPIBus)'),
+    ('clipping',                   r'ClippedDisplay'),
+    ('UI library',                 r'^TouchUserInterfaceForArduino::|^(lcd|ts)$'),
+    ('drivers',                    r'^(Adafruit_|XPT2046|SPI|EEPROM|host)'),
+])
+
+#
+# data that isn't part of a feature and is at least this big is counted as the
+# sketch's images and tables
+#
+IMAGE_MINIMUM_SIZE = 256
+
+RAM_TYPES = 'bBdDsS'
+FLASH_TYPES = 'dDrRtTwWvV'
+
+
+def read_symbols(program, nm):
+    output = subprocess.run([nm, '-S', '--size-sort', '-C', program], check=True,
+                            stdout=subprocess.PIPE, universal_newlines=True).stdout
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) == 4:
+            symbols.append((fields[3], fields[2], int(fields[1], 16)))
+    return symbols
+
+
+def feature_of(name, symbolType, size):
+    for feature, pattern in FEATURES.items():
+        if re.search(pattern, name):
+            return feature
+    if symbolType in 'bBdDrR' and size >= IMAGE_MINIMUM_SIZE:
+        return 'images and tables'
+    return 'other'
+
+
+def main():
+    args = sys.argv[1:]
+    nm = 'nm'
+    showSymbols = False
+    program = None
+    while args:
+        arg = args.pop(0)
+        if arg == '--nm' and args:
+            nm = args.pop(0)
+        elif arg == '--symbols':
+            showSymbols = True
+        elif program is None and not arg.startswith('--'):
+            program = arg
+        else:
+            program = None
+            break
+    if program is None:
+        print('usage: memory_report.py <program or .elf> [--nm tool] [--symbols]', file=sys.stderr)
+        return 2
+
+    features = OrderedDict((f, [0, 0, []]) for f in list(FEATURES) + ['images and tables', 'other'])
+    for name, symbolType, size in read_symbols(program, nm):
+        feature = features[feature_of(name, symbolType, size)]
+        if symbolType in RAM_TYPES:
+            feature[0] += size
+        if symbolType in FLASH_TYPES:
+            feature[1] += size
+        feature[2].append((size, symbolType, name))
+
+    print('%-28s %10s %10s' % ('feature', 'RAM', 'flash'))
+    for name, (ram, flash, symbols) in features.items():
+        if not symbols:
+            continue
+        print('%-28s %10d %10d' % (name, ram, flash))
+        if showSymbols:
+            for size, symbolType, symbol in sorted(symbols, reverse=True):
+                print('    %8d %s %s' % (size, symbolType, symbol))
+    print('%-28s %10d %10d' % ('total', sum(f[0] for f in features.values()),
+                               sum(f[1] for f in features.values())))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
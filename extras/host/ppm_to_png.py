@@ -0,0 +1,37 @@
+#!/usr/bin/env python3
+#
+# Convert binary PPM (P6) images, like the screenshots of the host build, to PNG
+#
+#   usage: ppm_to_png.py <image.ppm> [image.ppm...] <output folder>
+#
+#   ie:    extras/host/ppm_to_png.py /tmp/Example01.ppm /tmp/images
+#
+# Each image is written to the output folder with the same name ending in .png.
+# golden_images.sh uses this to save the reference images.
+#
+import os
+import sys
+
+sys.dont_write_bytecode = True
+from compare_ppm import read_ppm, write_png
+
+
+def main():
+    if len(sys.argv) < 3:
+        print('usage: ppm_to_png.py <image.ppm> [image.ppm...] <output folder>', file=sys.stderr)
+        return 2
+
+    output_dir = sys.argv[-1]
+    for file_name in sys.argv[1:-1]:
+        try:
+            width, height, pixels = read_ppm(file_name)
+        except (OSError, ValueError) as e:
+            print(e, file=sys.stderr)
+            return 1
+        name = os.path.splitext(os.path.basename(file_name))[0]
+        write_png(os.path.join(output_dir, name + '.png'), width, height, pixels)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,46 @@
+#!/bin/sh
+#
+# Build and run the host test programs, the folders in extras/host whose names
+# end in "Test"
+#
+#   usage: extras/host/run_tests.sh
+#
+# Each test program prints what it checked and exits with 0 if it passed.  This
+# script exits with 1 if any of them failed or didn't build.  A test folder with a
+# build_flags file is built with the compiler flags in it added, ie: 
+# -DARDUINO_ARCH_ESP32 to build the library's ESP32 code.
+#
+set -e
+
+HOST_DIR=$(cd "$(dirname "$0")" && pwd)
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+FAILED=0
+for TEST_DIR in "$HOST_DIR"/*Test; do
+  [ -d "$TEST_DIR" ] || continue
+  NAME=$(basename "$TEST_DIR")
+  TEST_FLAGS=
+  if [ -e "$TEST_DIR/build_flags" ]; then
+    TEST_FLAGS=$(cat "$TEST_DIR/build_flags")
+  fi
+  if ! EXTRA_FLAGS="$EXTRA_FLAGS $TEST_FLAGS" "$HOST_DIR/build_sketch.sh" "$TEST_DIR" "$WORK_DIR/$NAME"; then
+    echo "FAILED:    $NAME didn't build"
+    FAILED=$((FAILED + 1))
+    continue
+  fi
+  if RESULT=$("$WORK_DIR/$NAME" 2>&1); then
+    echo "passed:    $NAME  $(echo "$RESULT" | tail -n 1)"
+  else
+    echo "$RESULT"
+    echo "FAILED:    $NAME"
+    FAILED=$((FAILED + 1))
+  fi
+done
+
+if [ $FAILED -ne 0 ]; then
+  echo "$FAILED test(s) failed"
+  exit 1
+fi
+echo "all tests passed"
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+#
+# Estimate what drawing costs on a real ILI9341 panel, from the SPI transaction
+# log written by a host sketch run with --spi-log
+#
+#   usage: spi_cost_model.py <log file> [--target name]... [--top N]
+#
+#   ie:    /tmp/Example01 --run-ms 3000 --spi-log /tmp/e1.log
+#          extras/host/spi_cost_model.py /tmp/e1.log --top 10
+#
+# The log has one line per transaction (CS low to CS high):
+#     T <callChain> <commandBytes> <dataBytes> <addressWindows> <pixels>
+# where callChain is the library functions that led to the transaction, starting
+# with the one the sketch called (ie: "drawButton>lcdPrintCentered>lcdPrint>
+# lcdPrintCharacter"), and one line at the end of each frame (when the UI 
+# finishes drawing and reads the touch screen):
+#     F <virtual time in ms>
+#
+# Each transaction costs:
+#     (commandBytes + dataBytes) * 8 / SPI clock           the bytes on the wire
+#   + transactionOverhead                                  CS low/high, SPI begin/end
+#   + commandBytes * commandOverhead                       waiting for the bus to 
+#                                                          drain, then toggling DC
+# The overheads are typical of the Adafruit drivers on each processor; edit the 
+# TARGETS table to match other boards or driver versions.
+#
+import sys
+from collections import OrderedDict
+
+
+#
+# name: (SPI clock in MHz, transaction overhead in us, command overhead in us)
+#
+TARGETS = OrderedDict([
+    ('esp32',  (40.0, 1.5, 0.4)),
+    ('rp2040', (62.5, 0.8, 0.2)),
+])
+
+
+class Cost:
+    def __init__(self):
+        self.transactions = 0
+        self.commandBytes = 0
+        self.dataBytes = 0
+        self.windows = 0
+        self.pixels = 0
+
+    def add(self, commandBytes, dataBytes, windows, pixels):
+        self.transactions += 1
+        self.commandBytes += commandBytes
+        self.dataBytes += dataBytes
+        self.windows += windows
+        self.pixels += pixels
+
+    def micros(self, target):
+        clock, transactionOverhead, commandOverhead = TARGETS[target]
+        wire = (self.commandBytes + self.dataBytes) * 8.0 / clock
+        return wire + self.transactions * transactionOverhead + self.commandBytes * commandOverhead
+
+
+def read_log(file_name):
+    frames = []
+    callers = OrderedDict()
+    functions = OrderedDict()
+    primitives = OrderedDict()
+    frame = Cost()
+    for line in open(file_name):
+        fields = line.split()
+        if not fields or fields[0].startswith('#'):
+            continue
+        if fields[0] == 'T' and len(fields) == 6:
+            chain = fields[1].split('>')
+            values = [int(v) for v in fields[2:]]
+            frame.add(*values)
+            callers.setdefault(chain[0], Cost()).add(*values)
+            primitives.setdefault(chain[-1], Cost()).add(*values)
+            for name in set(chain):
+                functions.setdefault(name, Cost()).add(*values)
+        elif fields[0] == 'F' and len(fields) == 2:
+            frame.endMillis = int(fields[1])
+            frames.append(frame)
+            frame = Cost()
+    if frame.transactions:
+        frame.endMillis = None
+        frames.append(frame)
+    return frames, callers, functions, primitives
+
+
+def print_breakdown(title, costs, targets, top, total):
+    print()
+    print('%-34s %7s %9s %8s' % (title, 'trans', 'bytes', 'windows') +
+          ''.join(' %10s' % (t + ' us') for t in targets) + '  share')
+    ranked = sorted(costs.items(), key=lambda item: -item[1].micros(targets[0]))
+    for name, c in ranked[:top]:
+        print('%-34s %7d %9d %8d' % (name[:34], c.transactions, c.commandBytes + c.dataBytes, c.windows) +
+              ''.join(' %10.0f' % c.micros(t) for t in targets) +
+              '  %4.1f%%' % (100.0 * c.micros(targets[0]) / total))
+
+
+def main():
+    args = sys.argv[1:]
+    targets = []
+    top = 15
+    log = None
+    while args:
+        arg = args.pop(0)
+        if arg == '--target' and args:
+            targets.append(args.pop(0))
+        elif arg == '--top' and args:
+            top = int(args.pop(0))
+        elif log is None and not arg.startswith('--'):
+            log = arg
+        else:
+            log = None
+            break
+    if log is None or any(t not in TARGETS for t in targets):
+        print('usage: spi_cost_model.py <log file> [--target %s]... [--top N]' % '|'.join(TARGETS),
+              file=sys.stderr)
+        return 2
+    targets = targets or list(TARGETS)
+
+    frames, callers, functions, primitives = read_log(log)
+    total = sum(f.micros(targets[0]) for f in frames) or 1.0
+
+    for t in targets:
+        clock, transactionOverhead, commandOverhead = TARGETS[t]
+        print('%s: %.1f MHz SPI, %.1f us per transaction, %.1f us per command' %
+              (t, clock, transactionOverhead, commandOverhead))
+
+    print()
+    print('%-6s %8s %7s %9s %8s %8s' % ('frame', 'at ms', 'trans', 'bytes', 'windows', 'pixels') +
+          ''.join(' %10s' % (t + ' ms') for t in targets))
+    for i, f in enumerate(frames):
+        at = '%d' % f.endMillis if f.endMillis is not None else '-'
+        print('%-6d %8s %7d %9d %8d %8d' % (i, at, f.transactions, f.commandBytes + f.dataBytes,
+              f.windows, f.pixels) + ''.join(' %10.2f' % (f.micros(t) / 1000.0) for t in targets))
+
+    print_breakdown('by call from the sketch', callers, targets, top, total)
+    print_breakdown('by library function, inclusive', functions, targets, top, total)
+    print_breakdown('by drawing primitive', primitives, targets, top, total)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+#
+# Convert a trace printed by printTrace() to JSON for Chrome's about:tracing (or
+# ui.perfetto.dev), showing the UI's operations on a timeline
+#
+#   usage: trace_to_chrome.py <serial log> [output.json]
+#
+#   ie:    trace_to_chrome.py /tmp/serial.txt /tmp/trace.json
+#
+# The serial log can hold other output, the trace is read from between the lines:
+#     TRACE START <number of events recorded>
+#     <micros> B <operation>          an operation began
+#     <micros> E <operation>          it ended
+#     TRACE END
+# If the log has several traces, the last one is used.  The times come from
+# micros() so they wrap every 71 minutes, this is undone.  When the ring buffer
+# has overflowed the oldest events are gone, so ends without a beginning are
+# dropped, and operations still running at the end are ended at the last event.
+#
+import json
+import sys
+
+
+def read_trace(file_name):
+    events = None
+    trace = None
+    with open(file_name, errors='replace') as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith('TRACE START'):
+                trace = []
+            elif line == 'TRACE END':
+                if trace is not None:
+                    events = trace
+                trace = None
+            elif trace is not None:
+                fields = line.split()
+                if len(fields) == 3 and fields[1] in ('B', 'E') and fields[0].isdigit():
+                    trace.append((int(fields[0]), fields[1], fields[2]))
+    return events
+
+
+def to_chrome(events):
+    chrome = []
+    open_names = []
+    offset = 0
+    last = None
+    for time, phase, name in events:
+        if last is not None and time + offset < last - (1 << 31):
+            offset += 1 << 32
+        time += offset
+        last = time
+
+        if phase == 'B':
+            open_names.append(name)
+            chrome.append({'name': name, 'ph': 'B', 'ts': time, 'pid': 1, 'tid': 1})
+            continue
+
+        #
+        # end this operation, and any begun inside it that weren't ended
+        #
+        if name not in open_names:
+            continue
+        while open_names:
+            open_name = open_names.pop()
+            chrome.append({'name': open_name, 'ph': 'E', 'ts': time, 'pid': 1, 'tid': 1})
+            if open_name == name:
+                break
+
+    while open_names:
+        chrome.append({'name': open_names.pop(), 'ph': 'E', 'ts': last, 'pid': 1, 'tid': 1})
+    return chrome
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print('usage: trace_to_chrome.py <serial log> [output.json]', file=sys.stderr)
+        return 2
+
+    events = read_trace(sys.argv[1])
+    if events is None:
+        print('no complete trace (TRACE START ... TRACE END) in %s' % sys.argv[1], file=sys.stderr)
+        return 1
+
+    output = json.dumps({'traceEvents': to_chrome(events), 'displayTimeUnit': 'ms'}, indent=0)
+    if len(sys.argv) == 3:
+        with open(sys.argv[2], 'w') as f:
+            f.write(output)
+        print('%d events written to %s' % (len(events), sys.argv[2]))
+    else:
+        print(output)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
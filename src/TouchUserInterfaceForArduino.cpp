@@ -213,12 +213,6 @@
 #include "TouchUserInterfaceForArduino.h"
 
 
-//
-// pointers to the LCD and Touch objects
-//
-Adafruit_ILI9341 *lcd;
-XPT2046_Touchscreen *ts;
-
 //
 // the size of features for drawing the user interface
 //
@@ -237,6 +231,400 @@ const int FONT_TABLE_UNUSED_IDX           = 4;
 const int FONT_TABLE_CHAR_LOOKUP_IDX      = 5;
 
 
+//
+// the RAM copy of the configuration values saved in EEPROM, and the state of 
+// writing changes back to the EEPROM (see EEPROM functions below)
+//
+const int CONFIGURATION_SIZE = 1024;
+const int CONFIG_HEADER_SIZE = 5;
+const int CONFIGURATION_SLOT_HEADER_SIZE = 6;
+const int CONFIGURATION_SLOT_HEADERS_ADDRESS = 2 * CONFIGURATION_SIZE;
+const int CONFIGURATION_EEPROM_SIZE = 2 * CONFIGURATION_SIZE + 2 * CONFIGURATION_SLOT_HEADER_SIZE;
+
+byte configurationShadow[CONFIGURATION_SIZE];
+boolean configurationShadowLoadedFlg = false;
+boolean configurationDirtyFlg = false;
+int configurationUsedLength;
+int configurationActiveSlot;
+uint16_t configurationGeneration;
+int configurationCommitAddress;
+int configurationCommitHeaderIdx;
+byte configurationCommitHeader[CONFIGURATION_SLOT_HEADER_SIZE];
+
+unsigned long configurationCommitDelay = 1000;
+unsigned long configurationIdleStartTime = 0;
+unsigned long configurationCommitMicros;
+CONFIGURATION_COMMIT_STATS configurationCommitStats = {0, 0, 0, 0, 0};
+
+
+//
+// the draw-call profiler's counters (see Profiler functions below), PROFILE_FUNCTION()
+// at the top of a function counts it, PROFILE_PIXELS() counts pixels drawn.  Both 
+// are empty unless TOUCH_UI_PROFILER is defined.
+//
+#ifdef TOUCH_UI_PROFILER
+  PROFILE_COUNTER profileCounters[PROFILE_COUNTER_COUNT];
+  unsigned long profileResetTime = 0;
+  unsigned long profilePixelCount = 0;
+
+  class ProfileScope
+  {
+    public:
+      ProfileScope(int counterIdx)
+      {
+        idx = counterIdx;
+        startPixelCount = profilePixelCount;
+        startTime = micros();
+      }
+
+      ~ProfileScope()
+      {
+        profileCounters[idx].calls++;
+        profileCounters[idx].pixels += profilePixelCount - startPixelCount;
+        profileCounters[idx].micros += micros() - startTime;
+      }
+
+    private:
+      int idx;
+      unsigned long startPixelCount;
+      unsigned long startTime;
+  };
+
+  #define PROFILE_FUNCTION(counterIdx) ProfileScope profileScope(counterIdx)
+  #define PROFILE_PIXELS(pixelCount) (profilePixelCount += (unsigned long) (pixelCount))
+#else
+  #define PROFILE_FUNCTION(counterIdx)
+  #define PROFILE_PIXELS(pixelCount)
+#endif
+
+
+//
+// LCD_BUSY_TIMER() at the top of an LCD function adds the time spent in it to the 
+// LCD's busy time of the UI drawing, while that UI's performance overlay is shown 
+// (see Performance overlay functions below)
+//
+class LcdBusyTimer
+{
+  public:
+    LcdBusyTimer(boolean timingFlg, unsigned long &busyMicros)
+    {
+      busyMicrosPntr = timingFlg ? &busyMicros : NULL;
+      if (busyMicrosPntr != NULL)
+        startTime = micros();
+    }
+
+    ~LcdBusyTimer()
+    {
+      if (busyMicrosPntr != NULL)
+        *busyMicrosPntr += micros() - startTime;
+    }
+
+  private:
+    unsigned long *busyMicrosPntr;
+    unsigned long startTime;
+};
+
+#define LCD_BUSY_TIMER() LcdBusyTimer lcdBusyTimer(lcdBusyTimingFlg, lcdBusyMicros)
+
+
+//
+// the trace's ring buffer (see Tracing functions below), TRACE_SCOPE() adds a begin 
+// event, then an end event when the scope is left
+//
+TRACE_EVENT *traceEvents = NULL;
+int traceBufferSize;
+int traceNextIdx;
+long traceEventCount;
+boolean traceRunningFlg = false;
+
+static void addTraceEvent(byte traceId, byte eventType)
+{
+  if (!traceRunningFlg)
+    return;
+
+  traceEvents[traceNextIdx].time = micros();
+  traceEvents[traceNextIdx].traceId = traceId;
+  traceEvents[traceNextIdx].eventType = eventType;
+  traceNextIdx++;
+  if (traceNextIdx >= traceBufferSize)
+    traceNextIdx = 0;
+  traceEventCount++;
+}
+
+//
+// the stack measurement (see Stack measuring functions below), the trace's scopes
+// also record how deep the stack is when each operation starts, and how deep it 
+// goes while the operation runs
+//
+const byte STACK_PAINT_PATTERN = 0xa5;
+
+byte *stackReference;
+volatile byte *stackPaintBottom;
+volatile byte *stackHighWaterMark;
+boolean stackMeasuringFlg = false;
+int stackEntryDepths[TRACE_ID_COUNT];
+int stackHighWaterDepths[TRACE_ID_COUNT];
+
+static void updateStackHighWater(void)
+{
+  volatile byte *p = stackPaintBottom;
+  while ((p < stackHighWaterMark) && (*p == STACK_PAINT_PATTERN))
+    p++;
+  stackHighWaterMark = p;
+}
+
+class TraceScope
+{
+  public:
+    TraceScope(byte traceId)
+    {
+      id = traceId;
+      addTraceEvent(id, TRACE_EVENT_BEGIN);
+
+      if (stackMeasuringFlg)
+      {
+        int entryDepth = stackReference - (byte *) this;
+        if (entryDepth > stackEntryDepths[id])
+          stackEntryDepths[id] = entryDepth;
+        updateStackHighWater();
+        startHighWaterMark = stackHighWaterMark;
+      }
+    }
+
+    ~TraceScope()
+    {
+      addTraceEvent(id, TRACE_EVENT_END);
+
+      if (stackMeasuringFlg)
+      {
+        updateStackHighWater();
+        if (stackHighWaterMark < startHighWaterMark)
+          stackHighWaterDepths[id] = stackReference - (byte *) stackHighWaterMark;
+      }
+    }
+
+  private:
+    byte id;
+    volatile byte *startHighWaterMark;
+};
+
+#define TRACE_SCOPE(traceId) TraceScope traceScope(traceId)
+
+
+//
+// the render queue (see Render queue functions below), while it's running the LCD 
+// functions add commands to it rather than drawing, and the render loop on the 
+// other core draws them.  The render loop and the touch screen share the SPI bus,
+// each takes it with lockSPIBus() while using it.
+//
+const byte RENDER_CLEAR_SCREEN                  = 0;
+const byte RENDER_DRAW_PIXEL                    = 1;
+const byte RENDER_DRAW_LINE                     = 2;
+const byte RENDER_DRAW_HORIZONTAL_LINE          = 3;
+const byte RENDER_DRAW_VERTICAL_LINE            = 4;
+const byte RENDER_DRAW_RECTANGLE                = 5;
+const byte RENDER_DRAW_ROUNDED_RECTANGLE        = 6;
+const byte RENDER_DRAW_TRIANGLE                 = 7;
+const byte RENDER_DRAW_CIRCLE                   = 8;
+const byte RENDER_DRAW_FILLED_RECTANGLE         = 9;
+const byte RENDER_DRAW_FILLED_ROUNDED_RECTANGLE = 10;
+const byte RENDER_DRAW_FILLED_TRIANGLE          = 11;
+const byte RENDER_DRAW_FILLED_CIRCLE            = 12;
+const byte RENDER_DRAW_IMAGE                    = 13;
+const byte RENDER_DRAW_CHARACTER                = 14;
+const byte RENDER_SET_CLIP                      = 15;
+
+const int SPI_BUS_APP = 0;
+const int SPI_BUS_RENDER = 1;
+
+volatile boolean spiBusWantedFlgs[2] = {false, false};
+volatile int spiBusTurn;
+
+void TouchUserInterfaceForArduino::queueRenderCommand(byte opcode, uint16_t color, const void *pntr, 
+  int arg0, int arg1, int arg2, int arg3, int arg4, int arg5)
+{
+  int nextHead = renderQueueHead + 1;
+  if (nextHead >= renderQueueSize)
+    nextHead = 0;
+
+  //
+  // when the queue is full, wait for the render loop to draw a command, yielding 
+  // so other tasks (or the render task, if it shares this core) can run
+  //
+  while (nextHead == renderQueueTail)
+    yield();
+
+  RENDER_COMMAND *command = &renderQueue[renderQueueHead];
+  command->opcode = opcode;
+  command->args[0] = arg0;
+  command->args[1] = arg1;
+  command->args[2] = arg2;
+  command->args[3] = arg3;
+  command->args[4] = arg4;
+  command->args[5] = arg5;
+  command->color = color;
+  command->pntr = pntr;
+
+  __sync_synchronize();
+  renderQueueHead = nextHead;
+}
+
+//
+// the two cores take turns with the SPI bus using Peterson's algorithm, it needs 
+// no atomic instructions (the RP2040's cores don't have them)
+//
+static void lockSPIBus(int side)
+{
+  int otherSide = 1 - side;
+
+  spiBusWantedFlgs[side] = true;
+  spiBusTurn = otherSide;
+  __sync_synchronize();
+  while (spiBusWantedFlgs[otherSide] && (spiBusTurn == otherSide))
+    yield();
+  __sync_synchronize();
+}
+
+static void unlockSPIBus(int side)
+{
+  __sync_synchronize();
+  spiBusWantedFlgs[side] = false;
+}
+
+
+//
+// the bus lock (see Thread safe drawing functions below), LCD_BUS_LOCK() holds the 
+// app's lock from there to the end of the scope, while it talks to the LCD
+//
+void (*busLockFunction)(void) = NULL;
+void (*busUnlockFunction)(void) = NULL;
+
+class BusLock
+{
+  public:
+    BusLock()
+    {
+      unlockFunction = busUnlockFunction;
+      if (unlockFunction != NULL)
+        busLockFunction();
+    }
+
+    ~BusLock()
+    {
+      if (unlockFunction != NULL)
+        unlockFunction();
+    }
+
+  private:
+    void (*unlockFunction)(void);
+};
+
+#define LCD_BUS_LOCK() BusLock busLock
+
+
+//
+// the display driver, clipped to the UI's clip rectangle (see Clipping functions
+// below).  All of Adafruit's drawing ends in these pixel, line and rectangle 
+// writes, so trimming them here clips every shape, character and image before 
+// its address window is sent.
+//
+class ClippedDisplay : public Adafruit_ILI9341
+{
+  public:
+    ClippedDisplay(const CLIP_RECT *clip, int8_t cs, int8_t dc) : 
+      Adafruit_ILI9341(cs, dc), clip(clip) {}
+    ClippedDisplay(const CLIP_RECT *clip, SPIClass *spiClass, int8_t dc, int8_t cs) : 
+      Adafruit_ILI9341(spiClass, dc, cs), clip(clip) {}
+
+    using Adafruit_ILI9341::writePixel;
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color)
+    {
+      if (isInClip(x, y))
+        Adafruit_ILI9341::drawPixel(x, y, color);
+    }
+
+    void writePixel(int16_t x, int16_t y, uint16_t color)
+    {
+      if (isInClip(x, y))
+        Adafruit_ILI9341::writePixel(x, y, color);
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+      if (clipRectangle(x, y, w, h))
+        Adafruit_ILI9341::fillRect(x, y, w, h, color);
+    }
+
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+      if (clipRectangle(x, y, w, h))
+        Adafruit_ILI9341::writeFillRect(x, y, w, h, color);
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+    {
+      int16_t h = 1;
+      if (clipRectangle(x, y, w, h))
+        Adafruit_ILI9341::drawFastHLine(x, y, w, color);
+    }
+
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+    {
+      int16_t h = 1;
+      if (clipRectangle(x, y, w, h))
+        Adafruit_ILI9341::writeFastHLine(x, y, w, color);
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+    {
+      int16_t w = 1;
+      if (clipRectangle(x, y, w, h))
+        Adafruit_ILI9341::drawFastVLine(x, y, h, color);
+    }
+
+    void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+    {
+      int16_t w = 1;
+      if (clipRectangle(x, y, w, h))
+        Adafruit_ILI9341::writeFastVLine(x, y, h, color);
+    }
+
+  private:
+    boolean isInClip(int x, int y)
+    {
+      return((x >= clip->leftX) && (x <= clip->rightX) && (y >= clip->topY) && (y <= clip->bottomY));
+    }
+
+    //
+    // trim a rectangle to the clip, a negative width or height extends left or up
+    //  Exit:   true returned if any of it is left
+    //
+    boolean clipRectangle(int16_t &x, int16_t &y, int16_t &w, int16_t &h)
+    {
+      int leftX = (w < 0) ? x + w + 1 : x;
+      int topY = (h < 0) ? y + h + 1 : y;
+      int rightX = leftX + abs(w) - 1;
+      int bottomY = topY + abs(h) - 1;
+
+      if (leftX < clip->leftX) leftX = clip->leftX;
+      if (topY < clip->topY) topY = clip->topY;
+      if (rightX > clip->rightX) rightX = clip->rightX;
+      if (bottomY > clip->bottomY) bottomY = clip->bottomY;
+      if ((rightX < leftX) || (bottomY < topY))
+        return(false);
+
+      x = leftX;
+      y = topY;
+      w = rightX - leftX + 1;
+      h = bottomY - topY + 1;
+      return(true);
+    }
+
+    const CLIP_RECT *clip;
+};
+
+
 // ---------------------------------------------------------------------------------
 //                       Setup functions for the User Interface
 // ---------------------------------------------------------------------------------
@@ -246,6 +634,35 @@ const int FONT_TABLE_CHAR_LOOKUP_IDX      = 5;
 //
 TouchUserInterfaceForArduino::TouchUserInterfaceForArduino(void)
 {
+  //
+  // each instance drives its own display and touch screen, with its own touch 
+  // state, recording and render queue
+  //
+  lcd = NULL;
+  ts = NULL;
+  touchScreenSPI = NULL;
+  touchEventStartTime = 0;
+  recordedTouchX = 0;
+  recordedTouchY = 0;
+  touchRecordingSamples = NULL;
+  touchRecordingFlg = false;
+  touchRecordingCount = 0;
+  touchReplaySamples = NULL;
+  renderQueue = NULL;
+  performanceOverlayFont = NULL;
+  lcdBusyTimingFlg = false;
+  menuLayoutTable = NULL;
+
+  clipStack[0].leftX = -32768;
+  clipStack[0].topY = -32768;
+  clipStack[0].rightX = 32767;
+  clipStack[0].bottomY = 32767;
+  clipStackDepth = 0;
+  drawClip = clipStack[0];
+
+  for (int i = 0; i < BUTTON_LAYOUT_CACHE_SIZE; i++)
+    buttonLayouts[i].font = NULL;
+  buttonLayoutUseCount = 0;
 }
 
 
@@ -264,9 +681,48 @@ void TouchUserInterfaceForArduino::begin(int lcdCSPin, int LcdDCPin, int TouchSc
   //
   // create the LCD and touchscreen objects
   //
-  lcd = new Adafruit_ILI9341(lcdCSPin, LcdDCPin);
+  lcd = new ClippedDisplay(&drawClip, lcdCSPin, LcdDCPin);
+  ts = new XPT2046_Touchscreen(TouchScreenCSPin);
+  touchScreenSPI = NULL;
+  
+  beginUI(lcdOrientation, font);
+}
+
+
+
+//
+// initialize the UI, with the display and touchscreen on the given SPI bus, ie: to
+// drive a second display on its own bus
+//  Enter:  spi = the SPI bus, ie: SPI1
+//          lcdCSPin = pin number for the LCD's CS pin
+//          LcdDCPin = pin number for the LCD's DC pin
+//          TouchScreenCSPin = pin number for the touchscreen's CS pin
+//          lcdOrientation = LCD_ORIENTATION_PORTRAIT_4PIN_TOP, LCD_ORIENTATION_LANDSCAPE_4PIN_LEFT
+//                           LCD_ORIENTATION_PORTRAIT_4PIN_BOTTOM, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT
+//          font -> the font typeface to load, ei: Arial_10
+//
+void TouchUserInterfaceForArduino::begin(SPIClass &spi, int lcdCSPin, int LcdDCPin, int TouchScreenCSPin, int lcdOrientation, const byte *font)
+{
+  //
+  // create the LCD and touchscreen objects
+  //
+  lcd = new ClippedDisplay(&drawClip, &spi, LcdDCPin, lcdCSPin);
   ts = new XPT2046_Touchscreen(TouchScreenCSPin);
+  touchScreenSPI = &spi;
   
+  beginUI(lcdOrientation, font);
+}
+
+
+
+//
+// initialize the display and touchscreen hardware, then the UI
+//  Enter:  lcdOrientation = LCD_ORIENTATION_PORTRAIT_4PIN_TOP, LCD_ORIENTATION_LANDSCAPE_4PIN_LEFT
+//                           LCD_ORIENTATION_PORTRAIT_4PIN_BOTTOM, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT
+//          font -> the font typeface to load, ei: Arial_10
+//
+void TouchUserInterfaceForArduino::beginUI(int lcdOrientation, const byte *font)
+{
   //
   // initialize the LCD and touch screen hardware
   //
@@ -289,6 +745,11 @@ void TouchUserInterfaceForArduino::begin(int lcdCSPin, int LcdDCPin, int TouchSc
   // disable the callback function executed while in a menu
   //
   inMenuCallbackFunction = NULL;
+
+  //
+  // load the RAM copy of the configuration values saved in EEPROM
+  //
+  loadConfigurationShadow();
 }
 
 
@@ -474,6 +935,7 @@ void TouchUserInterfaceForArduino::displayAndExecuteMenu(MENU_ITEM *menu)
       //
       // there is a call back function, so execute it
       //
+      TRACE_SCOPE(TRACE_MENU_CALLBACK);
       (inMenuCallbackFunction)();
     }
   }
@@ -525,7 +987,10 @@ void TouchUserInterfaceForArduino::executeMenuItem(int menuIdx)
       //
       // execute the menu item's function
       //
-      (currentMenuTable[menuIdx].MenuItemFunction)();
+      {
+        TRACE_SCOPE(TRACE_MENU_COMMAND);
+        (currentMenuTable[menuIdx].MenuItemFunction)();
+      }
       
       //
       // display the menu again
@@ -540,7 +1005,10 @@ void TouchUserInterfaceForArduino::executeMenuItem(int menuIdx)
     case MENU_ITEM_TYPE_TOGGLE:
     {
       toggleSelectNextStateFlg = true;
-      (currentMenuTable[menuIdx].MenuItemFunction)();
+      {
+        TRACE_SCOPE(TRACE_MENU_CALLBACK);
+        (currentMenuTable[menuIdx].MenuItemFunction)();
+      }
       drawMenuItem(menuIdx, false);
     }
   }
@@ -556,9 +1024,10 @@ void TouchUserInterfaceForArduino::executeMenuItem(int menuIdx)
 void TouchUserInterfaceForArduino::selectAndDrawMenu(MENU_ITEM *menu, boolean drawMenuFlg)
 {   
   //
-  // remember the currently selected menu
+  // remember the currently selected menu, its buttons are laid out when first used
   //
   currentMenuTable = menu;
+  menuLayoutTable = NULL;
 
   //
   // check if drawing the menu, if not return
@@ -595,6 +1064,8 @@ void TouchUserInterfaceForArduino::selectAndDrawMenu(MENU_ITEM *menu, boolean dr
 //
 void TouchUserInterfaceForArduino::drawMenu(void)
 { 
+  PROFILE_FUNCTION(PROFILE_DRAW_MENU);
+  TRACE_SCOPE(TRACE_DRAW_MENU);
   int menuIdx = 1;
  
   //
@@ -645,19 +1116,9 @@ void TouchUserInterfaceForArduino::drawMenuItem(int menuIdx, boolean buttonSelec
     case MENU_ITEM_TYPE_SUB_MENU:
     {
       //
-      // draw the button
-      //
-      drawButton(menuItemText, buttonSelectedFlg, buttonX, buttonY, buttonWidth, buttonHeight);
-
-      //
-      // draw a triangle showing the button connects to a submenu
+      // draw the button with a triangle showing it connects to a submenu
       //
-      int arrowX = buttonX + buttonWidth - 18;
-      int arrowCenterY = buttonY + buttonHeight / 2;
-      lcdDrawFilledTriangle(arrowX,               arrowCenterY - arrowWidth/2,
-                            arrowX + arrowWidth,  arrowCenterY,
-                            arrowX,               arrowCenterY + arrowWidth/2,
-                            menuButtonTextColor);
+      drawButton(menuItemText, buttonSelectedFlg, buttonX, buttonY, buttonWidth, buttonHeight, true);
       break;
     }
 
@@ -679,7 +1140,10 @@ void TouchUserInterfaceForArduino::drawMenuItem(int menuIdx, boolean buttonSelec
       // execute the callback fuction to get the toggle button's text
       //
       toggleSelectNextStateFlg = false;
-      (currentMenuTable[menuIdx].MenuItemFunction)();
+      {
+        TRACE_SCOPE(TRACE_MENU_CALLBACK);
+        (currentMenuTable[menuIdx].MenuItemFunction)();
+      }
 
 
       //
@@ -744,8 +1208,37 @@ void TouchUserInterfaceForArduino::getMenuButtonSizeAndLocation(int menuIdx, int
   int *buttonWidth, int *buttonHeight)
 {
   int menuButtonNumber = menuIdx - 1;
-  int buttonCountOnThisRow;
-  
+  MENU_BUTTON_RECT buttonRect;
+
+  //
+  // lay out the menu's buttons if it hasn't been done since the menu was selected, 
+  // or the orientation changed
+  //
+  if ((menuLayoutTable != currentMenuTable) || (menuLayoutDisplaySpaceWidth != displaySpaceWidth))
+    layoutMenu();
+
+  if (menuButtonNumber < MENU_LAYOUT_MAX_BUTTONS)
+    buttonRect = menuLayout[menuButtonNumber];
+  else
+    buttonRect = uiMenuButtonRect(menuButtonNumber, menuLayoutButtonCount, menuLayoutColumns, 
+      displaySpaceLeftX, displaySpaceTopY, displaySpaceWidth, displaySpaceHeight);
+
+  *buttonX = buttonRect.x;
+  *buttonY = buttonRect.y;
+  *buttonWidth = buttonRect.width;
+  *buttonHeight = buttonRect.height;
+}
+
+
+
+//
+// find the XY coords and size of each button on the current menu, so drawing the 
+// menu and finding the button touched needn't count the buttons and divide up the
+// display space for each one
+//  Enter:  currentMenuTable -> the menu to lay out
+//
+void TouchUserInterfaceForArduino::layoutMenu(void)
+{
   //
   // count the total number of buttons
   //
@@ -761,47 +1254,23 @@ void TouchUserInterfaceForArduino::getMenuButtonSizeAndLocation(int menuIdx, int
   }
 
   //
-  // determine the number of rows and columns of buttons
+  // determine the number of columns of buttons
   //
-  int columnsOfButtons = (int) currentMenuTable[0].MenuItemFunction;
+  int columnsOfButtons = (int) (intptr_t) currentMenuTable[0].MenuItemFunction;
   if ((columnsOfButtons < 1) || (columnsOfButtons > 4))
     columnsOfButtons = 1;
-    
-  int rowsOfButtons = (buttonCount + columnsOfButtons - 1) / columnsOfButtons;
-
-  //
-  // determine the width of the buttons
-  //
-  int paddingOnTheSidesOfButtons = 10;
-  int paddingBetweenButtons = 10;
-  *buttonWidth = (displaySpaceWidth - (paddingOnTheSidesOfButtons*2) - (paddingBetweenButtons*(columnsOfButtons-1))) / columnsOfButtons;
-  paddingOnTheSidesOfButtons = (displaySpaceWidth - (*buttonWidth * columnsOfButtons) - (paddingBetweenButtons*(columnsOfButtons-1))) / 2;
-
-  //
-  // determine the height of the buttons
-  //
-  int paddingOnTopAndBottomOfButtons = 10;
-  *buttonHeight = (displaySpaceHeight - (paddingOnTopAndBottomOfButtons*2) - (paddingBetweenButtons*(rowsOfButtons-1))) / rowsOfButtons;
-  paddingOnTopAndBottomOfButtons = (displaySpaceHeight - (*buttonHeight * rowsOfButtons) - (paddingBetweenButtons*(rowsOfButtons-1))) / 2;
 
   //
-  // determine the row and column of this button
+  // find the location and size of each button
   //
-  int buttonRow = menuButtonNumber / columnsOfButtons;
-  int buttonColumn = menuButtonNumber - (buttonRow * columnsOfButtons);
+  for (int buttonNumber = 0; (buttonNumber < buttonCount) && (buttonNumber < MENU_LAYOUT_MAX_BUTTONS); buttonNumber++)
+    menuLayout[buttonNumber] = uiMenuButtonRect(buttonNumber, buttonCount, columnsOfButtons, 
+      displaySpaceLeftX, displaySpaceTopY, displaySpaceWidth, displaySpaceHeight);
 
-  //
-  // determine the XY coords of the button's upper left corner
-  //
-  if ((buttonRow != rowsOfButtons - 1) || (buttonCount % columnsOfButtons == 0))
-    buttonCountOnThisRow = columnsOfButtons;
-  else
-    buttonCountOnThisRow = buttonCount % columnsOfButtons;
-
-  int leftMostButtonX = displaySpaceLeftX + (displaySpaceWidth - (*buttonWidth * buttonCountOnThisRow) - (paddingBetweenButtons*(buttonCountOnThisRow-1))) / 2;
-  
-  *buttonX = leftMostButtonX + (*buttonWidth + paddingBetweenButtons) * buttonColumn;
-  *buttonY = displaySpaceTopY + paddingOnTopAndBottomOfButtons + (*buttonHeight + paddingBetweenButtons) * buttonRow;
+  menuLayoutTable = currentMenuTable;
+  menuLayoutDisplaySpaceWidth = displaySpaceWidth;
+  menuLayoutButtonCount = buttonCount;
+  menuLayoutColumns = columnsOfButtons;
 }
 
 
@@ -868,11 +1337,54 @@ void TouchUserInterfaceForArduino::drawTitleBarWithMenuButton(const char *titleB
 }
 
 
+//
+// draw the title bar (without the back or hamburger button), with a label made by 
+// UI_TEXT() so the text needn't be measured
+//
+void TouchUserInterfaceForArduino::drawTitleBar(const UI_LABEL &titleBarLabel)
+{
+  drawTitleBar(titleBarLabel.text, &titleBarLabel, TITLE_BAR_BUTTON_TYPE_NONE);
+}
+
+
+//
+// draw the title bar with the back button, with a label made by UI_TEXT()
+//
+void TouchUserInterfaceForArduino::drawTitleBarWithBackButton(const UI_LABEL &titleBarLabel)
+{
+  drawTitleBar(titleBarLabel.text, &titleBarLabel, TITLE_BAR_BUTTON_TYPE_BACK);
+}
+
+
+//
+// draw the title bar with the Menu button, with a label made by UI_TEXT()
+//
+void TouchUserInterfaceForArduino::drawTitleBarWithMenuButton(const UI_LABEL &titleBarLabel)
+{
+  drawTitleBar(titleBarLabel.text, &titleBarLabel, TITLE_BAR_BUTTON_TYPE_MENU);
+}
+
+
 //
 // draw the title bar above the Display Space
 //
 void TouchUserInterfaceForArduino::drawTitleBar(const char *titleBarText, int buttonType)
 {
+  drawTitleBar(titleBarText, NULL, buttonType);
+}
+
+
+//
+// draw the title bar above the Display Space
+//  Enter:  titleBarText -> the title
+//          titleBarLabel -> the title measured by UI_TEXT(), or NULL to measure it here
+//          buttonType = TITLE_BAR_BUTTON_TYPE_NONE, _BACK or _MENU
+//
+void TouchUserInterfaceForArduino::drawTitleBar(const char *titleBarText, const UI_LABEL *titleBarLabel, int buttonType)
+{
+  PROFILE_FUNCTION(PROFILE_DRAW_TITLE_BAR);
+  TRACE_SCOPE(TRACE_DRAW_TITLE_BAR);
+
   //
   // remember if the title bar includes a button
   //
@@ -887,7 +1399,12 @@ void TouchUserInterfaceForArduino::drawTitleBar(const char *titleBarText, int bu
   // draw the text on the title bar, first figure out how it will fit best
   //
   lcdSetFont(titleBarFont);
-  int titleBarTextX = (lcdWidth / 2) - (lcdStringWidthInPixels(titleBarText) / 2);
+  int titleBarTextWidth;
+  if ((titleBarLabel != NULL) && (titleBarLabel->font == titleBarFont))
+    titleBarTextWidth = titleBarLabel->width;
+  else
+    titleBarTextWidth = lcdStringWidthInPixels(titleBarText);
+  int titleBarTextX = (lcdWidth / 2) - (titleBarTextWidth / 2);
   if (titleBarTextX < 2) titleBarTextX = 2;
 
   //
@@ -940,6 +1457,12 @@ void TouchUserInterfaceForArduino::drawTitleBar(const char *titleBarText, int bu
   //
   if (buttonType == TITLE_BAR_BUTTON_TYPE_MENU)
     drawTitleBarMenuButton(false);
+
+  //
+  // the performance overlay was drawn over, show it again
+  //
+  if (performanceOverlayFont != NULL)
+    drawPerformanceOverlay(true);
 }
 
 
@@ -960,32 +1483,57 @@ void TouchUserInterfaceForArduino::drawTitleBarBackButton(boolean buttonSelected
   getBackButtonSizeAndLocation(&backButtonX, &backButtonY, &backButtonWidth, &backButtonHeight);
   int backButtonRadius = backButtonHeight / 2;
 
-  //
-  // draw the button as a rounded rect
-  //
   uint16_t buttonColor;
   if (buttonSelectedFlg)
     buttonColor = titleBarBackButtonSelectedColor;
   else
     buttonColor = titleBarBackButtonColor;
-  
-  lcdDrawFilledRoundedRectangle(backButtonX, backButtonY, backButtonWidth, backButtonHeight, 
-    backButtonRadius, buttonColor);
 
   //
-  // place the text "Back" on the button
+  // find where the text "Back" and the triangle showing the button goes back to 
+  // the previous menu are placed
   //
   lcdSetFont(titleBarFont);
   lcdSetFontColor(titleBarTextColor);
-  lcdSetCursorXY(backButtonX + backButtonRadius + arrowWidth*2 - 2, backButtonY + backButtonHeight/2 - lcdGetFontHeightWithoutDecenders()/2 - 1);
-  lcdPrint("Back");
+  int textX = backButtonX + backButtonRadius + arrowWidth*2 - 2;
+  int textY = backButtonY + backButtonHeight/2 - lcdGetFontHeightWithoutDecenders()/2 - 1;
+  int arrowX = backButtonX + backButtonRadius - 2;
+  int arrowCenterY = backButtonY + backButtonRadius - 1;
 
   //
-  // draw a triangle showing button goes back to previous menu
+  // draw the whole button at once with the compositor when it can be
+  //
+  BUTTON_COMPOSITE composite = {};
+  composite.x = backButtonX;
+  composite.y = backButtonY;
+  composite.width = backButtonWidth;
+  composite.height = backButtonHeight;
+  composite.faceColor = buttonColor;
+  composite.radius = backButtonRadius;
+  composite.backgroundColor = titleBarColor;
+  composite.font = titleBarFont;
+  composite.textColor = titleBarTextColor;
+  composite.text[0] = "Back";
+  composite.textX[0] = textX;
+  composite.textY[0] = textY;
+  composite.symbolColor = menuButtonTextColor;
+  composite.arrowFlg = true;
+  composite.arrowX[0] = arrowX;               composite.arrowY[0] = arrowCenterY;
+  composite.arrowX[1] = arrowX + arrowWidth;  composite.arrowY[1] = arrowCenterY - arrowWidth/2;
+  composite.arrowX[2] = arrowX + arrowWidth;  composite.arrowY[2] = arrowCenterY + arrowWidth/2;
+  if (drawCompositeButton(composite))
+    return;
+
   //
-  int arrowX = backButtonX + backButtonRadius - 2;
-  int arrowCenterY = backButtonY + backButtonRadius - 1;
-  lcdDrawFilledTriangle(arrowX,              arrowCenterY,
+  // otherwise draw the button as a rounded rect, then its text and triangle
+  //
+  lcdDrawFilledRoundedRectangle(backButtonX, backButtonY, backButtonWidth, backButtonHeight, 
+    backButtonRadius, buttonColor);
+
+  lcdSetCursorXY(textX, textY);
+  lcdPrint("Back");
+
+  lcdDrawFilledTriangle(arrowX,              arrowCenterY,
                         arrowX + arrowWidth, arrowCenterY - arrowWidth/2,
                         arrowX + arrowWidth, arrowCenterY + arrowWidth/2,
                         menuButtonTextColor);
@@ -1010,25 +1558,46 @@ void TouchUserInterfaceForArduino::drawTitleBarMenuButton(boolean buttonSelected
   int menuButtonRadius = menuButtonHeight / 4;
 
 
-  //
-  // draw the button as a rounded rect
-  //
   uint16_t buttonColor;
   if (buttonSelectedFlg)
     buttonColor = titleBarBackButtonSelectedColor;
   else
     buttonColor = titleBarBackButtonColor;
-  
-  lcdDrawFilledRoundedRectangle(menuButtonX, menuButtonY, menuButtonWidth, menuButtonHeight, 
-    menuButtonRadius, buttonColor);
 
   //
-  // draw a triangle showing button goes back to previous menu
+  // find where the three lines on the button go
   //
   int menuLinesWidth = menuButtonWidth / 2;
   int menuLinesLeftX = menuButtonX + menuButtonWidth/2 - menuLinesWidth/2;
   int menuLinesMiddleY =  menuButtonY + menuButtonHeight/2 - 1;
-  
+
+  //
+  // draw the whole button at once with the compositor when it can be
+  //
+  BUTTON_COMPOSITE composite = {};
+  composite.x = menuButtonX;
+  composite.y = menuButtonY;
+  composite.width = menuButtonWidth;
+  composite.height = menuButtonHeight;
+  composite.faceColor = buttonColor;
+  composite.radius = menuButtonRadius;
+  composite.backgroundColor = titleBarColor;
+  composite.symbolColor = menuButtonTextColor;
+  composite.barCount = 3;
+  composite.barX = menuLinesLeftX;
+  composite.barY = menuLinesMiddleY - 6;
+  composite.barWidth = menuLinesWidth;
+  composite.barHeight = 2;
+  composite.barSpacing = 6;
+  if (drawCompositeButton(composite))
+    return;
+
+  //
+  // otherwise draw the button as a rounded rect, then its lines
+  //
+  lcdDrawFilledRoundedRectangle(menuButtonX, menuButtonY, menuButtonWidth, menuButtonHeight, 
+    menuButtonRadius, buttonColor);
+
   lcdDrawFilledRectangle(menuLinesLeftX, menuLinesMiddleY, menuLinesWidth, 2, menuButtonTextColor);
   lcdDrawFilledRectangle(menuLinesLeftX, menuLinesMiddleY - 6, menuLinesWidth, 2, menuButtonTextColor);
   lcdDrawFilledRectangle(menuLinesLeftX, menuLinesMiddleY + 6, menuLinesWidth, 2, menuButtonTextColor);
@@ -1044,6 +1613,7 @@ void TouchUserInterfaceForArduino::drawTitleBarMenuButton(boolean buttonSelected
 //
 boolean TouchUserInterfaceForArduino::checkForBackButtonClicked(void)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_TITLE_BAR_BUTTON);
   int X1;
   int Y1;
   int buttonWidth;
@@ -1102,6 +1672,7 @@ boolean TouchUserInterfaceForArduino::checkForBackButtonClicked(void)
 //
 boolean TouchUserInterfaceForArduino::checkForMenuButtonClicked(void)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_TITLE_BAR_BUTTON);
   int X1;
   int Y1;
   int buttonWidth;
@@ -1203,6 +1774,9 @@ void TouchUserInterfaceForArduino::clearDisplaySpace(void)
 //
 void TouchUserInterfaceForArduino::clearDisplaySpace(uint16_t backgroundColor)
 {  
+  PROFILE_FUNCTION(PROFILE_CLEAR_DISPLAY_SPACE);
+  TRACE_SCOPE(TRACE_CLEAR_DISPLAY_SPACE);
+
   //
   // draw the frame
   //
@@ -1236,6 +1810,24 @@ void TouchUserInterfaceForArduino::drawButton(BUTTON &uiButton)
     menuButtonFrameColor, menuButtonTextColor, menuButtonFont);
 }
 
+//
+// draw a rectangular button using the colors and font defined for the menu, with a 
+// label made by UI_TEXT() so the text needn't be measured
+//  Enter:  uiButton -> the specifications for the button to draw, its labelText is
+//            what's drawn when the button is touched
+//          label -> the button's text measured by UI_TEXT()
+//
+void TouchUserInterfaceForArduino::drawButton(BUTTON &uiButton, const UI_LABEL &label)
+{
+  int buttonX = uiButton.centerX - uiButton.width/2;
+  if (buttonX < 0) buttonX = 0;
+  int buttonY = uiButton.centerY - uiButton.height/2;
+  if (buttonY < 0) buttonY = 0;
+  
+  drawButton(label.text, buttonX, buttonY, uiButton.width, uiButton.height, menuButtonColor, 
+    menuButtonFrameColor, menuButtonTextColor, menuButtonFont, &label);
+}
+
 //
 // draw a rectangular button using the colors and font defined for the menu
 //  Enter:  uiButton -> the specifications for the button to draw
@@ -1274,6 +1866,25 @@ void TouchUserInterfaceForArduino::drawButton(BUTTON_EXTENDED &uiButtonExt)
     uiButtonExt.buttonColor, uiButtonExt.buttonFrameColor, uiButtonExt.buttonTextColor, uiButtonExt.buttonFont);
 }
 
+//
+// draw a rectangular button with extended options for setting color and font, with
+// a label made by UI_TEXT() so the text needn't be measured
+//  Enter:  uiButton -> the specifications for the button to draw, its labelText is
+//            what's drawn when the button is touched
+//          label -> the button's text measured by UI_TEXT() in the button's font
+//
+void TouchUserInterfaceForArduino::drawButton(BUTTON_EXTENDED &uiButtonExt, const UI_LABEL &label)
+{
+  int buttonX = uiButtonExt.centerX - uiButtonExt.width/2;
+  if (buttonX < 0) buttonX = 0;
+  int buttonY = uiButtonExt.centerY - uiButtonExt.height/2;
+  if (buttonY < 0) buttonY = 0;
+  
+  drawButton(label.text, buttonX, buttonY, uiButtonExt.width, uiButtonExt.height, 
+    uiButtonExt.buttonColor, uiButtonExt.buttonFrameColor, uiButtonExt.buttonTextColor, uiButtonExt.buttonFont, 
+    &label);
+}
+
 //
 // draw a rectangular button with extended options for setting color and font
 //  Enter:  uiButton -> the specifications for the button to draw
@@ -1303,9 +1914,10 @@ void TouchUserInterfaceForArduino::drawButton(BUTTON_EXTENDED &uiButtonExt, bool
 //          showButtonTouchedFlg = true to draw button showing it's being touched, false to draw normal
 //          buttonX, buttonY = screen coords for the button's upper left corner
 //          buttonWidth, buttonHeight = size of the button
+//          submenuArrowFlg = true to draw a triangle showing the button connects to a submenu
 //
 void TouchUserInterfaceForArduino::drawButton(const char *labelText, boolean showButtonTouchedFlg, 
-  int buttonX, int buttonY, int buttonWidth, int buttonHeight)
+  int buttonX, int buttonY, int buttonWidth, int buttonHeight, boolean submenuArrowFlg)
 {
   uint16_t buttonColor;
 
@@ -1315,7 +1927,7 @@ void TouchUserInterfaceForArduino::drawButton(const char *labelText, boolean sho
     buttonColor = menuButtonColor;
 
   drawButton(labelText, buttonX, buttonY, buttonWidth, buttonHeight, buttonColor, 
-    menuButtonFrameColor, menuButtonTextColor, menuButtonFont);
+    menuButtonFrameColor, menuButtonTextColor, menuButtonFont, NULL, submenuArrowFlg);
 }
 
 //
@@ -1327,11 +1939,15 @@ void TouchUserInterfaceForArduino::drawButton(const char *labelText, boolean sho
 //          buttonFrameColor = color to make the button look raised
 //          buttonTextColor = color for the button's text
 //          buttonFont -> font for the button's text
+//          label -> the text measured by UI_TEXT(), or NULL to measure labelText here
+//          submenuArrowFlg = true to draw a triangle showing the button connects to a submenu
 //
 void TouchUserInterfaceForArduino::drawButton(const char *labelText, int buttonX, int buttonY, int buttonWidth, 
   int buttonHeight, uint16_t buttonColor, uint16_t buttonFrameColor, uint16_t buttonTextColor, 
-  const byte *buttonFont)
+  const byte *buttonFont, const UI_LABEL *label, boolean submenuArrowFlg)
 {
+  PROFILE_FUNCTION(PROFILE_DRAW_BUTTON);
+  TRACE_SCOPE(TRACE_DRAW_BUTTON);
   const int buttonTextBufferLength = 40;
   char buttonTextBufferLine1[buttonTextBufferLength];
   const char *buttonTextLine2;
@@ -1341,87 +1957,325 @@ void TouchUserInterfaceForArduino::drawButton(const char *labelText, int buttonX
   boolean finishedFlg;
   int maxTextWidthInPixels;
   int textWidthInPixels;
-  int lineCount;
+  int line1Length;
+  int line1Width;
+  int line2Width;
+  BUTTON_LAYOUT *buttonLayout;
   
   //
-  // draw the button's face with raised edges
+  // break the button's text into 1 or 2 lines insuring that the text fits on the button
   //
-  lcdDrawLine(buttonX,  buttonY + buttonHeight-1,   buttonX,                  buttonY,   buttonFrameColor);
-  lcdDrawLine(buttonX,  buttonY,                    buttonX + buttonWidth-1,  buttonY,   buttonFrameColor);
-  lcdDrawFilledRectangle(buttonX+1, buttonY+1, buttonWidth-1, buttonHeight-1, buttonColor);
+  maxTextWidthInPixels = buttonWidth - 8;
+  buttonTextLine2 = NULL;
+  line2Width = 0;
 
   //
-  // break the button's text into 1 or 2 lines insuring that the text fits on the button
+  // a label from UI_TEXT() was measured when compiling, so it can be broken and 
+  // centered without measuring
   //
-  maxTextWidthInPixels = buttonWidth - 8;
-  lineCount = 1;
+  if ((label != NULL) && (label->font == buttonFont) && 
+      breakLabel(label, maxTextWidthInPixels, buttonTextBufferLength, &line1Length, &line1Width))
+  {
+    memcpy(buttonTextBufferLine1, label->text, line1Length);
+    buttonTextBufferLine1[line1Length] = 0;
+
+    lcdSetFont(buttonFont);
+    if (line1Length != label->length)
+    {
+      buttonTextLine2 = label->text + line1Length + 1;
+      line2Width = label->width - line1Width - lcdCharacterWidth(' ');
+    }
+  }
+
+  else
+  {
+    if (label != NULL)
+      labelText = label->text;
+
+    //
+    // use how this text was broken the last time it was drawn on a button this wide
+    //
+    buttonLayout = findButtonLayout(labelText, buttonFont, maxTextWidthInPixels);
+    if (buttonLayout != NULL)
+    {
+      memcpy(buttonTextBufferLine1, labelText, buttonLayout->line1Length);
+      buttonTextBufferLine1[buttonLayout->line1Length] = 0;
+      line1Width = buttonLayout->line1Width;
+
+      if (buttonLayout->line2Index != 0)
+      {
+        buttonTextLine2 = labelText + buttonLayout->line2Index;
+        line2Width = buttonLayout->line2Width;
+      }
+    }
+
+    else
+    {
+      //
+      // find the first line, measuring in the button's font the same as UI_TEXT() 
+      // does, so a button is broken the same way drawn from a label or its string
+      //
+      lcdSetFont(buttonFont);
+      srcIndexStart = 0;
+      breakAtWhiteCount = 1;
+      buttonTextBufferLine1[0] = 0;
+      while(true)
+      {
+        srcIndex = srcIndexStart;
+        finishedFlg = breakStringAtWhiteSpace(labelText, &srcIndex, buttonTextBufferLine1, buttonTextBufferLength, breakAtWhiteCount);
+        textWidthInPixels = lcdStringWidthInPixels(buttonTextBufferLine1);
+       
+        if ((textWidthInPixels > maxTextWidthInPixels) && (breakAtWhiteCount == 1))
+          break;
+     
+        if ((textWidthInPixels < maxTextWidthInPixels) && (!finishedFlg))
+        {
+          breakAtWhiteCount++;
+          continue;
+        }
+     
+        if ((textWidthInPixels <= maxTextWidthInPixels) && (finishedFlg))
+          break;
+       
+        if (textWidthInPixels > maxTextWidthInPixels)
+        {
+          breakAtWhiteCount--;
+          srcIndex = srcIndexStart;
+          finishedFlg = breakStringAtWhiteSpace(labelText, &srcIndex, buttonTextBufferLine1, buttonTextBufferLength, breakAtWhiteCount);
+          break;
+        }
+
+        break;
+      }
+
+      //
+      // measure the lines, checking if there is a second line
+      //
+      line1Width = lcdStringWidthInPixels(buttonTextBufferLine1);
+      if (!finishedFlg)
+      {
+        buttonTextLine2 = labelText + srcIndex;
+        line2Width = lcdStringWidthInPixels(buttonTextLine2);
+      }
+
+      saveButtonLayout(labelText, buttonFont, maxTextWidthInPixels, strlen(buttonTextBufferLine1), 
+        finishedFlg ? 0 : srcIndex, line1Width, line2Width);
+    }
+  }
+
+
+  //
+  // find where the text goes on the button, either 1 line or two, centered using
+  // the widths found above
+  //
+  lcdSetFont(buttonFont);
+  lcdSetFontColor(buttonTextColor);
+
+  int textCenterX = buttonX + buttonWidth/2;
+  int line1Y;
+  int line2Y = 0;
+  if (buttonTextLine2 == NULL)
+    line1Y = buttonY + (buttonHeight / 2) - (lcdGetFontHeightWithoutDecenders()/2);
+  else
+  {
+    line1Y = buttonY + (buttonHeight / 2) - (4 + lcdGetFontHeightWithoutDecenders());
+    line2Y = buttonY + (buttonHeight / 2) + 2;
+  }
+
+  int arrowX = buttonX + buttonWidth - 18;
+  int arrowCenterY = buttonY + buttonHeight / 2;
+
+  //
+  // draw the whole button at once with the compositor when it can be
+  //
+  BUTTON_COMPOSITE composite = {};
+  composite.x = buttonX;
+  composite.y = buttonY;
+  composite.width = buttonWidth;
+  composite.height = buttonHeight;
+  composite.faceColor = buttonColor;
+  composite.frameFlg = true;
+  composite.frameColor = buttonFrameColor;
+  composite.font = buttonFont;
+  composite.textColor = buttonTextColor;
+  composite.text[0] = buttonTextBufferLine1;
+  composite.textX[0] = max(textCenterX - line1Width/2, 0);
+  composite.textY[0] = line1Y;
+  if (buttonTextLine2 != NULL)
+  {
+    composite.text[1] = buttonTextLine2;
+    composite.textX[1] = max(textCenterX - line2Width/2, 0);
+    composite.textY[1] = line2Y;
+  }
+  if (submenuArrowFlg)
+  {
+    composite.symbolColor = menuButtonTextColor;
+    composite.arrowFlg = true;
+    composite.arrowX[0] = arrowX;               composite.arrowY[0] = arrowCenterY - arrowWidth/2;
+    composite.arrowX[1] = arrowX + arrowWidth;  composite.arrowY[1] = arrowCenterY;
+    composite.arrowX[2] = arrowX;               composite.arrowY[2] = arrowCenterY + arrowWidth/2;
+  }
+  if (drawCompositeButton(composite))
+    return;
 
   //
-  // find the first line
+  // otherwise draw the button's face with raised edges, then its text and arrow
   //
-  srcIndexStart = 0;
-  breakAtWhiteCount = 1;
-  buttonTextBufferLine1[0] = 0;
+  lcdDrawLine(buttonX,  buttonY + buttonHeight-1,   buttonX,                  buttonY,   buttonFrameColor);
+  lcdDrawLine(buttonX,  buttonY,                    buttonX + buttonWidth-1,  buttonY,   buttonFrameColor);
+  lcdDrawFilledRectangle(buttonX+1, buttonY+1, buttonWidth-1, buttonHeight-1, buttonColor);
+
+  lcdSetCursorXY(textCenterX, line1Y);  
+  drawContext.cursorX = max(drawContext.cursorX - line1Width/2, 0);
+  lcdPrint(buttonTextBufferLine1);
+
+  if (buttonTextLine2 != NULL)
+  {
+    lcdSetCursorXY(textCenterX, line2Y);  
+    drawContext.cursorX = max(drawContext.cursorX - line2Width/2, 0);
+    lcdPrint(buttonTextLine2);
+  }
+
+  if (submenuArrowFlg)
+    lcdDrawFilledTriangle(arrowX,               arrowCenterY - arrowWidth/2,
+                          arrowX + arrowWidth,  arrowCenterY,
+                          arrowX,               arrowCenterY + arrowWidth/2,
+                          menuButtonTextColor);
+}
+
+
+
+//
+// find where to break a label made by UI_TEXT() onto two lines, the same way 
+// breakStringAtWhiteSpace() is used to break text, but using the widths measured
+// when compiling
+//  Enter:  label -> the label
+//          maxTextWidthInPixels = widest the first line should be
+//          destBufferLength = size of the buffer the first line is copied to
+//  Exit:   line1Length -> number of characters on the first line, if this is the
+//            label's length there's only one line, else the second line starts 
+//            after the space following it
+//          line1Width -> width of the first line in pixels
+//          false returned if the label can't be broken without measuring it
+//
+boolean TouchUserInterfaceForArduino::breakLabel(const UI_LABEL *label, int maxTextWidthInPixels, int destBufferLength, int *line1Length, int *line1Width)
+{
+  int breakAtWhiteCount = 1;
+  boolean finishedFlg;
+  int textWidthInPixels;
+
+  if (label->length >= destBufferLength - 1)
+    return(false);
+
   while(true)
   {
-    srcIndex = srcIndexStart;
-    finishedFlg = breakStringAtWhiteSpace(labelText, &srcIndex, buttonTextBufferLine1, buttonTextBufferLength, breakAtWhiteCount);
-    textWidthInPixels = lcdStringWidthInPixels(buttonTextBufferLine1);
-   
+    finishedFlg = (breakAtWhiteCount > label->spaceCount);
+    if (!finishedFlg && (breakAtWhiteCount > UI_LABEL_MAX_BREAKS))
+      return(false);
+
+    if (finishedFlg)
+      textWidthInPixels = label->width;
+    else
+      textWidthInPixels = label->breakWidths[breakAtWhiteCount - 1];
+
     if ((textWidthInPixels > maxTextWidthInPixels) && (breakAtWhiteCount == 1))
       break;
- 
+
     if ((textWidthInPixels < maxTextWidthInPixels) && (!finishedFlg))
     {
       breakAtWhiteCount++;
       continue;
     }
- 
+
     if ((textWidthInPixels <= maxTextWidthInPixels) && (finishedFlg))
       break;
-   
+
     if (textWidthInPixels > maxTextWidthInPixels)
-    {
       breakAtWhiteCount--;
-      srcIndex = srcIndexStart;
-      finishedFlg = breakStringAtWhiteSpace(labelText, &srcIndex, buttonTextBufferLine1, buttonTextBufferLength, breakAtWhiteCount);
-      break;
-    }
 
     break;
   }
 
-
-  //
-  // check if there is a second line
-  //
-  if (!finishedFlg)
+  if (breakAtWhiteCount > label->spaceCount)
+  {
+    *line1Length = label->length;
+    *line1Width = label->width;
+  }
+  else
   {
-    lineCount++;
-    buttonTextLine2 = labelText + srcIndex;
+    *line1Length = label->breakIndexes[breakAtWhiteCount - 1];
+    *line1Width = label->breakWidths[breakAtWhiteCount - 1];
   }
+  return(true);
+}
 
 
-  //
-  // draw the text on the button, either 1 line or two
-  //
-  lcdSetFont(buttonFont);
-  lcdSetFontColor(buttonTextColor);
 
-  if (lineCount == 1)
+//
+// find how a button's text was broken onto lines the last time it was drawn
+//  Enter:  text -> the button's text
+//          font -> the button's font
+//          maxTextWidthInPixels = widest the first line can be
+//  Exit:   pointer to the layout returned, or NULL if it isn't kept
+//
+BUTTON_LAYOUT *TouchUserInterfaceForArduino::findButtonLayout(const char *text, const byte *font, 
+  int maxTextWidthInPixels)
+{
+  for (int i = 0; i < BUTTON_LAYOUT_CACHE_SIZE; i++)
   {
-    lcdSetCursorXY(buttonX + buttonWidth/2, buttonY + (buttonHeight / 2) - (lcdGetFontHeightWithoutDecenders()/2));  
-    lcdPrintCentered(buttonTextBufferLine1);
+    BUTTON_LAYOUT *buttonLayout = &buttonLayouts[i];
+
+    if ((buttonLayout->font == font) && (buttonLayout->maxTextWidthInPixels == maxTextWidthInPixels) && 
+        (strcmp(buttonLayout->text, text) == 0))
+    {
+      buttonLayoutUseCount++;
+      buttonLayout->lastUsed = buttonLayoutUseCount;
+      return(buttonLayout);
+    }
   }
+  return(NULL);
+}
 
-  else
+
+
+//
+// keep how a button's text was broken onto lines, replacing the layout used least
+// recently
+//  Enter:  text -> the button's text, it's not kept if longer than BUTTON_LAYOUT_MAX_TEXT_LENGTH - 1
+//          font -> the button's font
+//          maxTextWidthInPixels = widest the first line can be
+//          line1Length = number of characters on the first line
+//          line2Index = index in the text where the second line starts, 0 if none
+//          line1Width, line2Width = width of each line in pixels
+//
+void TouchUserInterfaceForArduino::saveButtonLayout(const char *text, const byte *font, 
+  int maxTextWidthInPixels, int line1Length, int line2Index, int line1Width, int line2Width)
+{
+  if (strlen(text) >= (size_t) BUTTON_LAYOUT_MAX_TEXT_LENGTH)
+    return;
+
+  BUTTON_LAYOUT *buttonLayout = &buttonLayouts[0];
+  for (int i = 0; i < BUTTON_LAYOUT_CACHE_SIZE; i++)
   {
-    lcdSetCursorXY(buttonX + buttonWidth/2, buttonY + (buttonHeight / 2) - (4 + lcdGetFontHeightWithoutDecenders()));  
-    lcdPrintCentered(buttonTextBufferLine1);
+    if (buttonLayouts[i].font == NULL)
+    {
+      buttonLayout = &buttonLayouts[i];
+      break;
+    }
 
-    lcdSetCursorXY(buttonX + buttonWidth/2, buttonY + (buttonHeight / 2) + 2);  
-    lcdPrintCentered(buttonTextLine2);
+    if (buttonLayouts[i].lastUsed < buttonLayout->lastUsed)
+      buttonLayout = &buttonLayouts[i];
   }
+
+  strcpy(buttonLayout->text, text);
+  buttonLayout->font = font;
+  buttonLayout->maxTextWidthInPixels = maxTextWidthInPixels;
+  buttonLayout->line1Length = line1Length;
+  buttonLayout->line2Index = line2Index;
+  buttonLayout->line1Width = line1Width;
+  buttonLayout->line2Width = line2Width;
+  buttonLayoutUseCount++;
+  buttonLayout->lastUsed = buttonLayoutUseCount;
 }
 
 
@@ -1474,6 +2328,8 @@ boolean TouchUserInterfaceForArduino::breakStringAtWhiteSpace(const char *srcStr
 //
 boolean TouchUserInterfaceForArduino::checkForButtonClicked(BUTTON &uiButton)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_BUTTON);
+
   //
   // return if there is No Event
   //
@@ -1518,6 +2374,8 @@ boolean TouchUserInterfaceForArduino::checkForButtonClicked(BUTTON &uiButton)
 //
 boolean TouchUserInterfaceForArduino::checkForButtonClicked(BUTTON_EXTENDED &uiButton)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_BUTTON);
+
   //
   // return if there is No Event
   //
@@ -1563,6 +2421,8 @@ boolean TouchUserInterfaceForArduino::checkForButtonClicked(BUTTON_EXTENDED &uiB
 //
 boolean TouchUserInterfaceForArduino::checkForButtonAutoRepeat(BUTTON &uiButton)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_BUTTON);
+
   //
   // return if there is No Event
   //
@@ -1612,6 +2472,8 @@ boolean TouchUserInterfaceForArduino::checkForButtonAutoRepeat(BUTTON &uiButton)
 //
 boolean TouchUserInterfaceForArduino::checkForButtonAutoRepeat(BUTTON_EXTENDED &uiButton)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_BUTTON);
+
   //
   // return if there is No Event
   //
@@ -1664,6 +2526,8 @@ boolean TouchUserInterfaceForArduino::checkForButtonAutoRepeat(BUTTON_EXTENDED &
 //
 boolean TouchUserInterfaceForArduino::checkForButtonFirstTouched(BUTTON &uiButton)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_BUTTON);
+
   //
   // return if there is No Event
   //
@@ -1701,6 +2565,8 @@ boolean TouchUserInterfaceForArduino::checkForButtonFirstTouched(BUTTON &uiButto
 //
 boolean TouchUserInterfaceForArduino::checkForButtonFirstTouched(BUTTON_EXTENDED &uiButton)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_BUTTON);
+
   //
   // return if there is No Event
   //
@@ -1782,6 +2648,9 @@ void TouchUserInterfaceForArduino::drawImageButton(IMAGE_BUTTON &uiImageButton,
 void TouchUserInterfaceForArduino::drawImageButton(const uint16_t *image, int buttonX, int buttonY, int buttonWidth, 
   int buttonHeight, uint16_t buttonFrameColor)
 {
+  PROFILE_FUNCTION(PROFILE_DRAW_IMAGE_BUTTON);
+  TRACE_SCOPE(TRACE_DRAW_IMAGE_BUTTON);
+
   //
   // draw the button's face with raised edges
   //
@@ -1800,6 +2669,8 @@ void TouchUserInterfaceForArduino::drawImageButton(const uint16_t *image, int bu
 //
 boolean TouchUserInterfaceForArduino::checkForImageButtonClicked(IMAGE_BUTTON &uiImageButton)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_IMAGE_BUTTON);
+
   //
   // return if there is No Event
   //
@@ -1845,6 +2716,8 @@ boolean TouchUserInterfaceForArduino::checkForImageButtonClicked(IMAGE_BUTTON &u
 //
 boolean TouchUserInterfaceForArduino::checkForImageButtonAutoRepeat(IMAGE_BUTTON &uiImageButton)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_IMAGE_BUTTON);
+
   //
   // return if there is No Event
   //
@@ -1896,6 +2769,8 @@ boolean TouchUserInterfaceForArduino::checkForImageButtonAutoRepeat(IMAGE_BUTTON
 //
 boolean TouchUserInterfaceForArduino::checkForImageButtonFirstTouched(IMAGE_BUTTON &uiImageButton)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_IMAGE_BUTTON);
+
   //
   // return if there is No Event
   //
@@ -1933,6 +2808,8 @@ boolean TouchUserInterfaceForArduino::checkForImageButtonFirstTouched(IMAGE_BUTT
 //
 void TouchUserInterfaceForArduino::drawNumberBox(NUMBER_BOX &numberBox)
 {
+  PROFILE_FUNCTION(PROFILE_DRAW_NUMBER_BOX);
+  TRACE_SCOPE(TRACE_DRAW_NUMBER_BOX);
   int downButtonX;
   int numberX;
   int upButtonX;
@@ -1996,6 +2873,7 @@ void TouchUserInterfaceForArduino::drawNumberBox(NUMBER_BOX &numberBox)
 //
 boolean TouchUserInterfaceForArduino::checkForNumberBoxTouched(NUMBER_BOX &numberBox)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_NUMBER_BOX);
   int downButtonX;
   int numberX;
   int upButtonX;
@@ -2291,6 +3169,8 @@ void TouchUserInterfaceForArduino::getNumberBoxCoordinates(NUMBER_BOX &numberBox
 //
 void TouchUserInterfaceForArduino::drawNumberBox(NUMBER_BOX_FLOAT &numberBox)
 {
+  PROFILE_FUNCTION(PROFILE_DRAW_NUMBER_BOX);
+  TRACE_SCOPE(TRACE_DRAW_NUMBER_BOX);
   int downButtonX;
   int numberX;
   int upButtonX;
@@ -2355,6 +3235,7 @@ void TouchUserInterfaceForArduino::drawNumberBox(NUMBER_BOX_FLOAT &numberBox)
 //
 boolean TouchUserInterfaceForArduino::checkForNumberBoxTouched(NUMBER_BOX_FLOAT &numberBox)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_NUMBER_BOX);
   int downButtonX;
   int numberX;
   int upButtonX;
@@ -2587,7 +3468,7 @@ boolean TouchUserInterfaceForArduino::updateNumberBoxNumberFloat(NUMBER_BOX_FLOA
 //
 void TouchUserInterfaceForArduino::drawNumberInNumberBoxFloat(NUMBER_BOX_FLOAT &numberBox)
 {
-  char stringBuffer[20];
+  char stringBuffer[UI_NUMBER_BUFFER_LENGTH];
   int downButtonX;
   int numberX;
   int upButtonX;
@@ -2613,7 +3494,7 @@ void TouchUserInterfaceForArduino::drawNumberInNumberBoxFloat(NUMBER_BOX_FLOAT &
   //
   // draw the number
   //
-  dtostrf(numberBox.value, 1, numberBox.digitsRightOfDecimal, stringBuffer);
+  uiFormatFloat(stringBuffer, numberBox.value, numberBox.digitsRightOfDecimal);
   lcdSetCursorXY(numberX + numberWidth/2, textY);
   lcdPrintCentered(stringBuffer);
 }
@@ -2656,6 +3537,8 @@ void TouchUserInterfaceForArduino::getNumberBoxCoordinatesFloat(NUMBER_BOX_FLOAT
 //
 void TouchUserInterfaceForArduino::drawSelectionBox(SELECTION_BOX &selectionBox)
 {
+  PROFILE_FUNCTION(PROFILE_DRAW_SELECTION_BOX);
+  TRACE_SCOPE(TRACE_DRAW_SELECTION_BOX);
   int X, Y;
   int width, height;
   
@@ -2698,6 +3581,7 @@ void TouchUserInterfaceForArduino::drawSelectionBox(SELECTION_BOX &selectionBox)
 //
 boolean TouchUserInterfaceForArduino::checkForSelectionBoxTouched(SELECTION_BOX &selectionBox)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_SELECTION_BOX);
   int X, Y;
   int width, height;
   
@@ -2864,6 +3748,9 @@ const int SLIDER_BALL_RADIUS = 10;
 //
 void TouchUserInterfaceForArduino::drawSlider(SLIDER &slider)
 {  
+  PROFILE_FUNCTION(PROFILE_DRAW_SLIDER);
+  TRACE_SCOPE(TRACE_DRAW_SLIDER);
+
   //
   // draw the Slider's line and ball
   //
@@ -2903,6 +3790,7 @@ void TouchUserInterfaceForArduino::drawSliderBall(SLIDER &slider, uint16_t ballC
 //
 boolean TouchUserInterfaceForArduino::checkForSliderTouched(SLIDER &slider)
 {
+  PROFILE_FUNCTION(PROFILE_CHECK_FOR_SLIDER);
   int touchXlcd;
   int touchYlcd;
   int originalValue = slider.value;
@@ -3016,91 +3904,333 @@ int TouchUserInterfaceForArduino::getBallsValue(SLIDER &slider, int lcdX)
 
 
 // ---------------------------------------------------------------------------------
-//          Numeric Keypad - Allows user to enter a number (float or int)
+//                                Text Box functions  
 // ---------------------------------------------------------------------------------
 
-const int DIGIT_BUTTONS_WIDTH = 56;
-const int DIGIT_BUTTONS_HEIGHT = 44;
-const int DIGIT_BUTTONS_HORZ_SPACING = DIGIT_BUTTONS_WIDTH + 7;
-const int DIGIT_BUTTONS_VERT_SPACING = DIGIT_BUTTONS_HEIGHT + 7;
-const int DIGIT_BUTTONS_X = 35;
-const int DIGIT_BUTTONS_Y = 61;
-const int NUMBER_FIELD_WIDTH = 117;
-const int NUMBER_FIELD_HEIGHT = 32;
-const int NUMBER_FIELD_X = 196;
-const int NUMBER_FIELD_Y = 46;
-const int OTHER_BUTTONS_X = 254;
-const int OTHER_BUTTONS_Y = 111;
-const int OTHER_BUTTONS_WIDTH = 80;
-const int OTHER_BUTTONS_HEIGHT = DIGIT_BUTTONS_HEIGHT;
-const int OTHER_BUTTONS_SPACING = DIGIT_BUTTONS_VERT_SPACING;
-
-const int MAX_CHARACTERS = 12;
-char valueStr[MAX_CHARACTERS + 15];
+//
+// constants used by the Text Box
+//
+const int TEXT_BOX_MARGIN = 4;
+const int TEXT_BOX_SCROLL_BAR_WIDTH = 6;
 
 
 //
-// display a keypad allowing user to enter a float number
-//  Enter:  titleBar -> text to display on the titlebar
-//          value -> storage for initial value and returned value
-//          minValue = minimum value (a lower will disable the "OK" button)
-//          maxValue = maximum value (a higher will disable the "OK" button)
-//  Exit:   true returned if user pressed "OK", false returned if user pressed "Cancel"
+// draw a Text Box, showing the lines that fit starting with its topLine.  The text 
+// is drawn with the font and color set with lcdSetFont() and lcdSetFontColor(), on
+// the menu's background color.  It's broken into lines the first time it's drawn, 
+// and again only if its text, font or width changes.
+//  Enter:  textBox -> the specifications of the Text Box to draw
 //
-boolean TouchUserInterfaceForArduino::numericKeyPad(const char *titleBar, float &value, float minValue, float maxValue)
+void TouchUserInterfaceForArduino::drawTextBox(TEXT_BOX &textBox)
 {
-  boolean firstFlg = true;
+  int boxX = textBox.centerX - textBox.width/2;
+  int boxY = textBox.centerY - textBox.height/2;
+  int maxTextWidthInPixels = textBox.width - TEXT_BOX_MARGIN*2;
 
-  
   //
-  // draw title bar without a "Back" button
+  // break the text into lines if it hasn't been, if they don't all fit break it 
+  // again leaving room for the scroll bar
   //
-  drawTitleBar(titleBar);
-  clearDisplaySpace();
-
+  if ((textBox.layoutText != textBox.text) || (textBox.layoutFont != drawContext.font) || 
+      (textBox.layoutWidth != textBox.width))
+  {
+    layoutTextBox(textBox, maxTextWidthInPixels);
+    if (textBox.lineCount > getTextBoxVisibleLines(textBox))
+      layoutTextBox(textBox, maxTextWidthInPixels - TEXT_BOX_SCROLL_BAR_WIDTH);
+  }
 
   //
-  // define the digits buttons, along with .  &  -
+  // keep the top line in range
   //
-  int row = 0;
-  int col = 0;
-  BUTTON button7 = {"7", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
-  BUTTON button8 = {"8", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
-  BUTTON button9 = {"9", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
-
-  row = 1;
-  col = 0;
-  BUTTON button4 = {"4", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
-  BUTTON button5 = {"5", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
-  BUTTON button6 = {"6", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
-
-  row = 2;
-  col = 0;
-  BUTTON button1 = {"1", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
-  BUTTON button2 = {"2", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
-  BUTTON button3 = {"3", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
-
-  row = 3;
-  col = 0;
-  BUTTON button0     = {"0", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
-  BUTTON buttonDot   = {".", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
-  BUTTON buttonMinus = {"+/-", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+  int visibleLines = getTextBoxVisibleLines(textBox);
+  if (textBox.topLine > textBox.lineCount - visibleLines)
+    textBox.topLine = textBox.lineCount - visibleLines;
+  if (textBox.topLine < 0)
+    textBox.topLine = 0;
 
   //
-  // display the digits buttons
+  // draw the lines that are showing
   //
-  drawButton(button1);
-  drawButton(button2);
-  drawButton(button3);
-  drawButton(button4);
-  drawButton(button5);
-  drawButton(button6);
-  drawButton(button7);
-  drawButton(button8);
-  drawButton(button9);
-  drawButton(button0);
-  drawButton(buttonDot);
-  drawButton(buttonMinus);
+  lcdDrawFilledRectangle(boxX, boxY, textBox.width, textBox.height, menuBackgroundColor);
+
+  int lineHeight = lcdGetFontHeightWithDecentersAndLineSpacing();
+  for (int line = textBox.topLine; (line < textBox.lineCount) && (line < textBox.topLine + visibleLines); line++)
+  {
+    int startIdx = textBox.lineStarts[line];
+    int endIdx = textBox.lineStarts[line + 1];
+    while ((endIdx > startIdx) && ((textBox.text[endIdx - 1] == ' ') || (textBox.text[endIdx - 1] == '\n')))
+      endIdx--;
+
+    lcdSetCursorXY(boxX + TEXT_BOX_MARGIN, boxY + TEXT_BOX_MARGIN + (line - textBox.topLine) * lineHeight);
+    for (int idx = startIdx; idx < endIdx; idx++)
+      lcdPrintCharacter(textBox.text[idx]);
+  }
+
+  //
+  // draw the scroll bar if all of the lines don't fit
+  //
+  if (textBox.lineCount > visibleLines)
+  {
+    int scrollBarX = boxX + textBox.width - TEXT_BOX_SCROLL_BAR_WIDTH;
+    lcdDrawFilledRectangle(scrollBarX, boxY, TEXT_BOX_SCROLL_BAR_WIDTH, textBox.height, menuButtonFrameColor);
+
+    int thumbHeight = max(textBox.height * visibleLines / textBox.lineCount, TEXT_BOX_SCROLL_BAR_WIDTH);
+    int thumbY = boxY + (textBox.height - thumbHeight) * textBox.topLine / (textBox.lineCount - visibleLines);
+    lcdDrawFilledRectangle(scrollBarX + 1, thumbY + 1, TEXT_BOX_SCROLL_BAR_WIDTH - 2, thumbHeight - 2, menuButtonColor);
+  }
+}
+
+
+
+//
+// change the text shown in a Text Box, the text is broken into lines and shown
+// from its first line the next time the Text Box is drawn.  Call this when the 
+// text is changed in place, as the Text Box can't tell.
+//  Enter:  textBox -> the Text Box
+//          text -> the new text
+//
+void TouchUserInterfaceForArduino::setTextBoxText(TEXT_BOX &textBox, const char *text)
+{
+  textBox.text = text;
+  textBox.topLine = 0;
+  textBox.layoutText = NULL;
+}
+
+
+
+//
+// scroll a Text Box and redraw it
+//  Enter:  textBox -> the Text Box
+//          lines = number of lines to scroll, positive to show lines further down
+//
+void TouchUserInterfaceForArduino::scrollTextBox(TEXT_BOX &textBox, int lines)
+{
+  textBox.topLine += lines;
+  drawTextBox(textBox);
+}
+
+
+
+//
+// check if the user touched a Text Box, touching the top half scrolls up a page, 
+// the bottom half scrolls down a page
+// Note: getTouchEvents() must be called at the top of the loop that calls this function
+//  Enter:  textBox -> the Text Box
+//  Exit:   true returned if the Text Box was scrolled, else false
+//
+boolean TouchUserInterfaceForArduino::checkForTextBoxTouched(TEXT_BOX &textBox)
+{
+  //
+  // return if there is No Event
+  //
+  if (touchEventType == TOUCH_NO_EVENT)
+    return(false);
+
+  int boxX = textBox.centerX - textBox.width/2;
+  int boxY = textBox.centerY - textBox.height/2;
+  int visibleLines = getTextBoxVisibleLines(textBox);
+  int pageLines = max(visibleLines - 1, 1);
+
+  //
+  // check if scrolling up
+  //
+  if (checkForTouchEventInRect(TOUCH_PUSHED_EVENT,   boxX, boxY,   boxX + textBox.width-1, boxY + textBox.height/2 - 1))
+  {
+    if (textBox.topLine <= 0)
+      return(false);
+
+    scrollTextBox(textBox, -pageLines);
+    return(true);
+  }
+
+  //
+  // check if scrolling down
+  //
+  if (checkForTouchEventInRect(TOUCH_PUSHED_EVENT,   boxX, boxY + textBox.height/2,   boxX + textBox.width-1, boxY + textBox.height-1))
+  {
+    if (textBox.topLine + visibleLines >= textBox.lineCount)
+      return(false);
+
+    scrollTextBox(textBox, pageLines);
+    return(true);
+  }
+
+  return(false);
+}
+
+
+
+//
+// break a Text Box's text into lines that fit, at spaces if possible, and at each
+// newline.  The index in the text where each line starts is saved in lineStarts[], 
+// followed by the index where the last line ends.
+//  Enter:  textBox -> the Text Box, using the font set with lcdSetFont()
+//          maxTextWidthInPixels = widest a line can be
+//
+void TouchUserInterfaceForArduino::layoutTextBox(TEXT_BOX &textBox, int maxTextWidthInPixels)
+{
+  const char *text = textBox.text;
+  int maxLineCount = textBox.lineStartsSize - 1;
+  int lineStartIdx = 0;
+
+  textBox.lineCount = 0;
+  textBox.layoutText = textBox.text;
+  textBox.layoutFont = drawContext.font;
+  textBox.layoutWidth = textBox.width;
+  if ((text == NULL) || (maxLineCount < 1))
+    return;
+
+  while((text[lineStartIdx] != 0) && (textBox.lineCount < maxLineCount))
+  {
+    int idx = lineStartIdx;
+    int breakIdx = -1;
+    int lineWidthInPixels = 0;
+
+    textBox.lineStarts[textBox.lineCount] = lineStartIdx;
+    textBox.lineCount++;
+
+    //
+    // add characters until the end of the text, a newline, or one that doesn't fit
+    //
+    while(true)
+    {
+      byte c = text[idx];
+      if (c == 0)
+        break;
+
+      if (c == '\n')
+      {
+        idx++;
+        break;
+      }
+
+      int characterWidth = ((c >= 0x20) && (c <= 0x7f)) ? lcdCharacterWidth(c) : 0;
+      if ((lineWidthInPixels + characterWidth > maxTextWidthInPixels) && (idx > lineStartIdx))
+      {
+        //
+        // the character doesn't fit, break after the last space if there was one
+        //
+        if ((c != ' ') && (breakIdx > lineStartIdx))
+          idx = breakIdx + 1;
+
+        while(text[idx] == ' ')
+          idx++;
+        break;
+      }
+
+      if (c == ' ')
+        breakIdx = idx;
+      lineWidthInPixels += characterWidth;
+      idx++;
+    }
+
+    lineStartIdx = idx;
+  }
+
+  textBox.lineStarts[textBox.lineCount] = lineStartIdx;
+}
+
+
+
+//
+// get the number of lines that fit in a Text Box, in the font set with lcdSetFont()
+//
+int TouchUserInterfaceForArduino::getTextBoxVisibleLines(TEXT_BOX &textBox)
+{
+  int visibleLines = (textBox.height - TEXT_BOX_MARGIN*2) / lcdGetFontHeightWithDecentersAndLineSpacing();
+  if (visibleLines < 1)
+    visibleLines = 1;
+  return(visibleLines);
+}
+
+
+// ---------------------------------------------------------------------------------
+//          Numeric Keypad - Allows user to enter a number (float or int)
+// ---------------------------------------------------------------------------------
+
+const int DIGIT_BUTTONS_WIDTH = 56;
+const int DIGIT_BUTTONS_HEIGHT = 44;
+const int DIGIT_BUTTONS_HORZ_SPACING = DIGIT_BUTTONS_WIDTH + 7;
+const int DIGIT_BUTTONS_VERT_SPACING = DIGIT_BUTTONS_HEIGHT + 7;
+const int DIGIT_BUTTONS_X = 35;
+const int DIGIT_BUTTONS_Y = 61;
+const int NUMBER_FIELD_WIDTH = 117;
+const int NUMBER_FIELD_HEIGHT = 32;
+const int NUMBER_FIELD_X = 196;
+const int NUMBER_FIELD_Y = 46;
+const int OTHER_BUTTONS_X = 254;
+const int OTHER_BUTTONS_Y = 111;
+const int OTHER_BUTTONS_WIDTH = 80;
+const int OTHER_BUTTONS_HEIGHT = DIGIT_BUTTONS_HEIGHT;
+const int OTHER_BUTTONS_SPACING = DIGIT_BUTTONS_VERT_SPACING;
+
+const int MAX_CHARACTERS = 12;
+char valueStr[MAX_CHARACTERS + 15];
+
+
+//
+// display a keypad allowing user to enter a float number
+//  Enter:  titleBar -> text to display on the titlebar
+//          value -> storage for initial value and returned value
+//          minValue = minimum value (a lower will disable the "OK" button)
+//          maxValue = maximum value (a higher will disable the "OK" button)
+//  Exit:   true returned if user pressed "OK", false returned if user pressed "Cancel"
+//
+boolean TouchUserInterfaceForArduino::numericKeyPad(const char *titleBar, float &value, float minValue, float maxValue)
+{
+  TRACE_SCOPE(TRACE_NUMERIC_KEYPAD);
+  boolean firstFlg = true;
+
+  
+  //
+  // draw title bar without a "Back" button
+  //
+  drawTitleBar(titleBar);
+  clearDisplaySpace();
+
+
+  //
+  // define the digits buttons, along with .  &  -
+  //
+  int row = 0;
+  int col = 0;
+  BUTTON button7 = {"7", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+  BUTTON button8 = {"8", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+  BUTTON button9 = {"9", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+
+  row = 1;
+  col = 0;
+  BUTTON button4 = {"4", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+  BUTTON button5 = {"5", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+  BUTTON button6 = {"6", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+
+  row = 2;
+  col = 0;
+  BUTTON button1 = {"1", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+  BUTTON button2 = {"2", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+  BUTTON button3 = {"3", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+
+  row = 3;
+  col = 0;
+  BUTTON button0     = {"0", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+  BUTTON buttonDot   = {".", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+  BUTTON buttonMinus = {"+/-", DIGIT_BUTTONS_X + (col++*DIGIT_BUTTONS_HORZ_SPACING), DIGIT_BUTTONS_Y + (row*DIGIT_BUTTONS_VERT_SPACING), DIGIT_BUTTONS_WIDTH, DIGIT_BUTTONS_HEIGHT};
+
+  //
+  // display the digits buttons
+  //
+  drawButton(button1);
+  drawButton(button2);
+  drawButton(button3);
+  drawButton(button4);
+  drawButton(button5);
+  drawButton(button6);
+  drawButton(button7);
+  drawButton(button8);
+  drawButton(button9);
+  drawButton(button0);
+  drawButton(buttonDot);
+  drawButton(buttonMinus);
 
 
   //
@@ -3124,7 +4254,7 @@ boolean TouchUserInterfaceForArduino::numericKeyPad(const char *titleBar, float
   //
   // convert the initial value into a string, remove trailing zeros, then display it
   //
-  dtostrf(value, 0, 4, valueStr);
+  uiFormatFloat(valueStr, value, 4);
 
   int i = strlen(valueStr);
 
@@ -3244,6 +4374,7 @@ boolean TouchUserInterfaceForArduino::numericKeyPad(const char *titleBar, float
 //
 boolean TouchUserInterfaceForArduino::numericKeyPad(const char *titleBar, int &value, int minValue, int maxValue)
 {
+  TRACE_SCOPE(TRACE_NUMERIC_KEYPAD);
   boolean firstFlg = true;
 
   
@@ -3317,7 +4448,7 @@ boolean TouchUserInterfaceForArduino::numericKeyPad(const char *titleBar, int &v
   //
   // convert the initial value into a string, remove trailing zeros, then display it
   //
-  dtostrf(value, 0, 4, valueStr);
+  uiFormatFloat(valueStr, value, 4);
 
   int i = strlen(valueStr);
 
@@ -3467,6 +4598,14 @@ const long TOUCH_AUTO_REPEAT_DELAY = 800;
 const long TOUCH_AUTO_REPEAT_RATE = 120;
 
 
+//
+// recording and replaying touch screen samples, when replaying the virtual clock
+// advances this many milliseconds each time getTouchEvents() is called
+//
+const long TOUCH_REPLAY_TICK_PERIOD = 1;
+
+
+
 // ---------------------------------------------------------------------------------
 
 //
@@ -3476,7 +4615,10 @@ const long TOUCH_AUTO_REPEAT_RATE = 120;
 //
 void TouchUserInterfaceForArduino::touchScreenInitialize(int lcdOrientation)
 {
-  ts->begin();
+  if (touchScreenSPI != NULL)
+    ts->begin(*touchScreenSPI);
+  else
+    ts->begin();
   touchScreenSetOrientation(lcdOrientation);
 }
 
@@ -3531,20 +4673,43 @@ boolean TouchUserInterfaceForArduino::checkForTouchEventInRect(int eventType, in
 //
 void TouchUserInterfaceForArduino::getTouchEvents(void)
 {
+  PROFILE_FUNCTION(PROFILE_GET_TOUCH_EVENTS);
   boolean currentlyTouched;
   int currentTouchX;
   int currentTouchY;
   unsigned long currentTime = millis();
-  static unsigned long touchEventStartTime;
-  static int recordedTouchX;
-  static int recordedTouchY;
+
+  if (performanceOverlayFont != NULL)
+    updatePerformanceOverlay();
 
   touchEventType = TOUCH_NO_EVENT;                          // assume there will be no touch event
 
+  //
+  // when replaying a touch recording, time comes from the replay's virtual clock
+  //
+  if (touchReplaySamples != NULL)
+  {
+    touchReplayTime += TOUCH_REPLAY_TICK_PERIOD;
+    if (touchReplayTime > touchReplaySamples[touchReplayCount - 1].time)
+    {
+      //
+      // end of the recording, back to the touch screen.  A touch still held at the 
+      // end is dropped, its times are on the virtual clock.
+      //
+      touchReplaySamples = NULL;
+      touchState = WAITING_FOR_TOUCH_DOWN_STATE;
+      touchEventStartTime = currentTime;
+    }
+    else
+      currentTime = touchReplayTime;
+  }
+
   //
   // check if anything is touched now
   //
   currentlyTouched = getTouchScreenCoords(&currentTouchX, &currentTouchY);
+  if (currentlyTouched)
+    configurationIdleStartTime = millis();                  // UI isn't idle, hold off saving configuration values
 
   //
   // select the current touch state
@@ -3560,7 +4725,10 @@ void TouchUserInterfaceForArduino::getTouchEvents(void)
       {
          touchState = CONFIRM_TOUCH_DOWN_STATE;             // screen is touched, start timer to confirm touch
          touchEventStartTime = currentTime;
+         return;
       }
+
+      commitConfigurationWhenIdle();                        // UI is idle, save any changed configuration values
       return;
      } 
 
@@ -3786,531 +4954,1846 @@ boolean TouchUserInterfaceForArduino::getTouchScreenCoords(int *xLCD, int *yLCD)
 //
 boolean TouchUserInterfaceForArduino::getRAWTouchScreenCoords(int *xRaw, int *yRaw)
 {
+  TRACE_SCOPE(TRACE_TOUCH_SAMPLE);
+
   //
-  // check if the screen is currently being touched
+  // when replaying a recording, the samples come from it rather than the screen
+  //
+  if (touchReplaySamples != NULL)
+    return(getReplayedTouchSample(xRaw, yRaw));
+
   //
-  if (ts->touched() == false)
+  // check if the screen is currently being touched and get the raw coordinates, 
+  // taking the SPI bus from the render loop if it's running
+  //
+  boolean touchedFlg;
+  TS_Point rawTouchPoint;
+  {
+    LCD_BUS_LOCK();
+    boolean renderQueueRunningFlg = (renderQueue != NULL);
+    if (renderQueueRunningFlg)
+      lockSPIBus(SPI_BUS_APP);
+
+    touchedFlg = ts->touched();
+    if (touchedFlg)
+      rawTouchPoint = ts->getPoint();
+
+    if (renderQueueRunningFlg)
+      unlockSPIBus(SPI_BUS_APP);
+  }
+
+  if (touchedFlg == false)
+  {
+    if (touchRecordingFlg)
+      recordTouchSample(false, 0, 0);
     return(false);
+  }
 
   //
-  // get the raw coordinates and return them
+  // return the raw coordinates
   //
-  TS_Point rawTouchPoint = ts->getPoint();
 
   *xRaw = rawTouchPoint.x;
   *yRaw = rawTouchPoint.y;
+
+  if (touchRecordingFlg)
+    recordTouchSample(true, *xRaw, *yRaw);
   return(true);
 }
 
 
 // ---------------------------------------------------------------------------------
-//                                    LCD functions  
+//                       Recording and replaying touch samples  
 // ---------------------------------------------------------------------------------
 
 //
-// initialize the LCD display
-//  Enter:  lcdOrientation = LCD_ORIENTATION_PORTRAIT_4PIN_TOP, LCD_ORIENTATION_LANDSCAPE_4PIN_LEFT
-//                           LCD_ORIENTATION_PORTRAIT_4PIN_BOTTOM, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT
-//          font -> the font typeface to load, ei: Arial_10
+// start recording samples from the touch screen, a sample is saved each time the
+// screen is read and the touch has changed, until the buffer is full
+//  Enter:  sampleBuffer -> storage for the samples
+//          bufferSize = number of samples the buffer holds (at least 2)
 //
-void TouchUserInterfaceForArduino::lcdInitialize(int lcdOrientation, const byte *font)
+void TouchUserInterfaceForArduino::startTouchRecording(TOUCH_SAMPLE *sampleBuffer, int bufferSize)
 {
-  lcd->begin();
-  lcdSetOrientation(lcdOrientation);
-  lcdClearScreen(LCD_BLACK);
-  lcdSetFontColor(LCD_WHITE);  
-  lcdSetFont(font);
+  if (bufferSize < 2)
+    return;
+
+  touchRecordingSamples = sampleBuffer;
+  touchRecordingBufferSize = bufferSize;
+  touchRecordingCount = 0;
+  touchRecordingStartTime = millis();
+  touchRecordingFlg = true;
 }
 
 
 
 //
-// set the LCD display's orientation
-//  Enter:  lcdOrientation = LCD_ORIENTATION_PORTRAIT_4PIN_TOP, LCD_ORIENTATION_LANDSCAPE_4PIN_LEFT
-//                           LCD_ORIENTATION_PORTRAIT_4PIN_BOTTOM, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT
+// stop recording samples from the touch screen
+//  Exit:   number of samples in the recording returned
 //
-void TouchUserInterfaceForArduino::lcdSetOrientation(int lcdOrientation)
+int TouchUserInterfaceForArduino::stopTouchRecording(void)
 {
-  lcd->setRotation(lcdOrientation);
-  lcdWidth = lcd->width();
-  lcdHeight = lcd->height();
-  lcdSetCursorXY(0, 0);
+  if (!touchRecordingFlg)
+    return(touchRecordingCount);
+
+  //
+  // add a last sample marking when the recording stopped, repeating the final 
+  // touch (space for this was saved by recordTouchSample())
+  //
+  TOUCH_SAMPLE &lastSample = touchRecordingSamples[touchRecordingCount];
+  if (touchRecordingCount == 0)
+  {
+    lastSample.touchedFlg = false;
+    lastSample.xRaw = 0;
+    lastSample.yRaw = 0;
+  }
+  else
+    lastSample = touchRecordingSamples[touchRecordingCount - 1];
+  lastSample.time = millis() - touchRecordingStartTime;
+  touchRecordingCount++;
+
+  touchRecordingFlg = false;
+  return(touchRecordingCount);
 }
 
 
 
 //
-// fill the entire lcd screen with the given color
-//  Enter:  color = 16 bit color, bit format: rrrrrggggggbbbbb
+// print the most recent recording, formatted as C code that can be pasted into 
+// a sketch and played back with startTouchReplay()
+//  Enter:  port = where to print, ie: Serial
 //
-void TouchUserInterfaceForArduino::lcdClearScreen(uint16_t color)
+void TouchUserInterfaceForArduino::printTouchRecording(Print &port)
 {
-  lcd->fillScreen(color);
+  port.print("const TOUCH_SAMPLE touchRecording[");
+  port.print(touchRecordingCount);
+  port.println("] = {");
+  for (int i = 0; i < touchRecordingCount; i++)
+  {
+    port.print("  {");
+    port.print(touchRecordingSamples[i].time);
+    port.print(", ");
+    port.print(touchRecordingSamples[i].touchedFlg ? "true" : "false");
+    port.print(", ");
+    port.print(touchRecordingSamples[i].xRaw);
+    port.print(", ");
+    port.print(touchRecordingSamples[i].yRaw);
+    port.println(i < touchRecordingCount - 1 ? "}," : "}");
+  }
+  port.println("};");
 }
 
 
 
 //
-// draw one pixel with the given coords and color
-//  Enter:  x, y = coords of the pixel to draw
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+// save a sample from the touch screen to the recording, if it's changed since 
+// the last one
+//  Enter:  touchedFlg = true if the screen is being touched
+//          xRaw, yRaw = raw touch screen coordinates
 //
-void TouchUserInterfaceForArduino::lcdDrawPixel(int x, int y, uint16_t color)
+void TouchUserInterfaceForArduino::recordTouchSample(boolean touchedFlg, int xRaw, int yRaw)
 {
-  lcd->drawPixel(x, y, color);
+  //
+  // check if the buffer is full, keeping one spot for stopTouchRecording()
+  //
+  if (touchRecordingCount >= touchRecordingBufferSize - 1)
+    return;
+
+  //
+  // only save samples that are different from the previous one
+  //
+  if (touchRecordingCount > 0)
+  {
+    TOUCH_SAMPLE &previous = touchRecordingSamples[touchRecordingCount - 1];
+    if ((previous.touchedFlg == touchedFlg) && (previous.xRaw == xRaw) && (previous.yRaw == yRaw))
+      return;
+  }
+
+  TOUCH_SAMPLE &sample = touchRecordingSamples[touchRecordingCount];
+  sample.time = millis() - touchRecordingStartTime;
+  sample.touchedFlg = touchedFlg;
+  sample.xRaw = xRaw;
+  sample.yRaw = yRaw;
+  touchRecordingCount++;
 }
 
 
 
 //
-// draw a line with the given coords and color
-//  Enter:  x1, y1 = first endpoint of line
-//          x2, y2 = second endpoint of line
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+// start playing back a recording of touch screen samples, until it ends the 
+// samples are used in place of the touch screen and getTouchEvents() runs on a 
+// virtual clock that advances 1ms each time it's called, so the same recording 
+// always gives the same events
+//  Enter:  samples -> the recording, ie: as printed by printTouchRecording()
+//          sampleCount = number of samples in the recording
 //
-void TouchUserInterfaceForArduino::lcdDrawLine(int x1, int y1, int x2, int y2, uint16_t color)
+void TouchUserInterfaceForArduino::startTouchReplay(const TOUCH_SAMPLE *samples, int sampleCount)
 {
-  lcd->drawLine(x1, y1, x2, y2, color);
+  if (sampleCount <= 0)
+    return;
+
+  touchReplayCount = sampleCount;
+  touchReplayIdx = -1;
+  touchReplayTime = 0;
+  touchState = WAITING_FOR_TOUCH_DOWN_STATE;
+  touchReplaySamples = samples;
 }
 
 
 
 //
-// draw a horizontal line with the given coords, length and color
-//  Enter:  x, y = first endpoint of line
-//          length = length of line
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+// check if a recording of touch screen samples is being played back
+//  Exit:   true returned if playing back
 //
-void TouchUserInterfaceForArduino::lcdDrawHorizontalLine(int x, int y, int length, uint16_t color)
+boolean TouchUserInterfaceForArduino::isTouchReplayRunning(void)
 {
-  lcd->drawFastHLine(x, y, length, color);
+  return(touchReplaySamples != NULL);
 }
 
 
 
 //
-// draw a vertical line with the given coords, length and color
-//  Enter: x, y = first endpoint of line
-//          length = length of line
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+// get the time on the replay's virtual clock, comparing it with the time of a 
+// sample gives how long events took to be reported
+//  Exit:   ms since the start of the recording returned
 //
-void TouchUserInterfaceForArduino::lcdDrawVerticalLine(int x, int y, int length, uint16_t color)
+unsigned long TouchUserInterfaceForArduino::getTouchReplayTime(void)
 {
-  lcd->drawFastVLine(x, y, length, color);
+  return(touchReplayTime);
 }
 
 
 
 //
-// draw rectangle at the given coords, length, width and color
-//  Enter:  x, y = upper left corner of rect
-//          width = width of rectangle
-//          height = height of rectangle
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+// get the sample from the recording being played back at the current virtual time
+//  Enter:  xRaw, yRaw -> storage to return X and Y raw coordinates
+//  Exit:   true returned if the screen was being touched at this time, else false
 //
-void TouchUserInterfaceForArduino::lcdDrawRectangle(int x, int y, int width, int height, uint16_t color)
+boolean TouchUserInterfaceForArduino::getReplayedTouchSample(int *xRaw, int *yRaw)
 {
-  lcd->drawRect(x, y, width, height, color);
-}
-
+  //
+  // find the last sample at or before the virtual time
+  //
+  while ((touchReplayIdx < touchReplayCount - 1) && 
+         (touchReplaySamples[touchReplayIdx + 1].time <= touchReplayTime))
+    touchReplayIdx++;
 
+  if ((touchReplayIdx < 0) || !touchReplaySamples[touchReplayIdx].touchedFlg)
+    return(false);
 
-//
-// draw rounded rectangle at the given coords, length, width and color
-//  Enter:  x, y = upper left corner of rect
-//          width = width of rectangle
-//          height = height of rectangle
-//          radius = radius of the corners
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
-//
-void TouchUserInterfaceForArduino::lcdDrawRoundedRectangle(int x, int y, int width, int height, int radius, uint16_t color)
-{
-  lcd->drawRoundRect(x, y, width, height, radius, color);
+  *xRaw = touchReplaySamples[touchReplayIdx].xRaw;
+  *yRaw = touchReplaySamples[touchReplayIdx].yRaw;
+  return(true);
 }
 
 
+// ---------------------------------------------------------------------------------
+//                            Number formatting functions  
+// ---------------------------------------------------------------------------------
 
 //
-// draw a circle at the given coords, radius and color
-//  Enter:  x0, y0 = endpoint 0 of the triangle
-//          x1, y1 = endpoint 1 of the triangle
-//          x2, y2 = endpoint 2 of the triangle
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+// the number printing functions format with these rather than itoa() and dtostrf().
+// A float is split into its integer part and its fraction, each scaled to an 
+// unsigned long, so there's one float multiply and no float formatting (dtostrf()
+// takes hundreds of microseconds on the RP2040, which has no FPU).
 //
-void TouchUserInterfaceForArduino::lcdDrawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, uint16_t color)
-{
-  lcd->drawTriangle(x0, y0, x1, y1, x2, y2, color);
-}
-
+static const unsigned long powersOfTen[UI_NUMBER_MAX_DIGITS_RIGHT_OF_DECIMAL + 1] = 
+  {1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL};
 
 
 //
-// draw a triangle at the given coords and color
-//  Enter:  x, y = upper left corner of rect
-//          radius = radius of the circle
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+// write the digits of an unsigned number, with a decimal point
+//  Enter:  buffer -> where to write the digits
+//          n = the number, scaled by 10^digitsRightOfDecimal
+//          digitsRightOfDecimal = number of digits after the decimal point, 0 for none
+//  Exit:   number of characters written returned, the buffer isn't terminated
 //
-void TouchUserInterfaceForArduino::lcdDrawCircle(int x, int y, int radius, uint16_t color)
+static int formatDigits(char *buffer, unsigned long n, int digitsRightOfDecimal)
 {
-  lcd->drawCircle(x, y, radius, color);
+  char digits[UI_NUMBER_BUFFER_LENGTH];
+  int digitCount = 0;
+
+  //
+  // find the digits from right to left, always with one left of the decimal point
+  //
+  do
+  {
+    if ((digitCount == digitsRightOfDecimal) && (digitsRightOfDecimal > 0))
+      digits[digitCount++] = '.';
+    digits[digitCount++] = '0' + (n % 10);
+    n = n / 10;
+  } while((n != 0) || (digitCount <= digitsRightOfDecimal));
+
+  for (int i = 0; i < digitCount; i++)
+    buffer[i] = digits[digitCount - 1 - i];
+  return(digitCount);
 }
 
 
 
 //
-// draw a filled rectangle at the given coords, length, width and color
-//  Enter:  x, y = upper left corner of rect
-//          width = width of rectangle
-//          height = height of rectangle
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+// format a signed integer
+//  Enter:  buffer -> storage for at least UI_NUMBER_BUFFER_LENGTH characters
+//          n = the number
+//  Exit:   length of the text returned
 //
-void TouchUserInterfaceForArduino::lcdDrawFilledRectangle(int x, int y, int width, int height, uint16_t color)
+int uiFormatInt(char *buffer, long n)
 {
-  lcd->fillRect(x, y, width, height, color);
+  return(uiFormatFixed(buffer, n, 0));
 }
 
 
 
 //
-// draw a filled rounded rectangle at the given coords, length, width and color
-//  Enter:  x, y = upper left corner of rect
-//          width = width of rectangle
-//          height = height of rectangle
-//          radius = radius of the corners
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+// format a fixed point number, stored as an integer scaled by a power of 10, 
+// ie: 1234 with 2 digits right of the decimal is "12.34"
+//  Enter:  buffer -> storage for at least UI_NUMBER_BUFFER_LENGTH characters
+//          scaledValue = the number times 10^digitsRightOfDecimal
+//          digitsRightOfDecimal = 0 to UI_NUMBER_MAX_DIGITS_RIGHT_OF_DECIMAL
+//  Exit:   length of the text returned
 //
-void TouchUserInterfaceForArduino::lcdDrawFilledRoundedRectangle(int x, int y, int width, int height, int radius, uint16_t color)
+int uiFormatFixed(char *buffer, long scaledValue, int digitsRightOfDecimal)
 {
-  lcd->fillRoundRect(x, y, width, height, radius, color);
-}
+  int length = 0;
+  unsigned long magnitude = (unsigned long) scaledValue;
 
+  if (digitsRightOfDecimal < 0)
+    digitsRightOfDecimal = 0;
+  if (digitsRightOfDecimal > UI_NUMBER_MAX_DIGITS_RIGHT_OF_DECIMAL)
+    digitsRightOfDecimal = UI_NUMBER_MAX_DIGITS_RIGHT_OF_DECIMAL;
 
+  if (scaledValue < 0)
+  {
+    buffer[length++] = '-';
+    magnitude = 0UL - magnitude;
+  }
 
-//
-// draw a circle at the given coords, radius and color
-//  Enter:  x0, y0 = endpoint 0 of the triangle
-//          x1, y1 = endpoint 1 of the triangle
-//          x2, y2 = endpoint 2 of the triangle
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
-//
-void TouchUserInterfaceForArduino::lcdDrawFilledTriangle(int x0, int y0, int x1, int y1, int x2, int y2, uint16_t color)
-{
-  lcd->fillTriangle(x0, y0, x1, y1, x2, y2, color);
+  length += formatDigits(buffer + length, magnitude, digitsRightOfDecimal);
+  buffer[length] = 0;
+  return(length);
 }
 
 
 
 //
-// draw a filled circle at the given coords, radius and color
-//  Enter:  x, y = upper left corner of rect
-//          radius = radius of the circle
-//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+// format a float or double, rounded to the given number of digits right of the
+// decimal point.  Halves round away from zero.  As with Arduino's Serial.print(), 
+// numbers beyond +/-4294967040 are shown as "ovf".
+//  Enter:  buffer -> storage for at least UI_NUMBER_BUFFER_LENGTH characters
+//          n = the number
+//          digitsRightOfDecimal = 0 to UI_NUMBER_MAX_DIGITS_RIGHT_OF_DECIMAL
+//  Exit:   length of the text returned
 //
-void TouchUserInterfaceForArduino::lcdDrawFilledCircle(int x, int y, int radius, uint16_t color)
+int uiFormatFloat(char *buffer, double n, int digitsRightOfDecimal)
 {
-  lcd->fillCircle(x, y, radius, color);
-}
+  int length = 0;
 
+  if (digitsRightOfDecimal < 0)
+    digitsRightOfDecimal = 0;
+  if (digitsRightOfDecimal > UI_NUMBER_MAX_DIGITS_RIGHT_OF_DECIMAL)
+    digitsRightOfDecimal = UI_NUMBER_MAX_DIGITS_RIGHT_OF_DECIMAL;
 
+  if (isnan(n))
+  {
+    strcpy(buffer, "nan");
+    return(3);
+  }
 
+  if (!isinf(n) && ((n > 4294967040.0) || (n < -4294967040.0)))
+  {
+    strcpy(buffer, "ovf");
+    return(3);
+  }
 
-//
-// draw an image
-//  Enter:  x, y = coords of upper left corner on LCD where the image will be displayed
-//          width, height =  size of the image, this must be the same as the image data
-//          image -> image data, 2 bytes/pixel in the RGB565 format stored in PROGMEM
-// Note: use this utility to convert an image to C sourse code:
-//       www.rinkydinkelectronics.com/_t_doimageconverter565.php
-//
-void TouchUserInterfaceForArduino::lcdDrawImage(int x, int y, int width, int height, const uint16_t *image)
-{
-  lcd->drawRGBBitmap(x, y, image, width, height);
-}
+  if (n < 0)
+  {
+    buffer[length++] = '-';
+    n = -n;
+  }
 
+  if (isinf(n))
+  {
+    strcpy(buffer + length, "inf");
+    return(length + 3);
+  }
 
+  //
+  // split the number into integer and fraction parts, then round the fraction, 
+  // carrying into the integer part if it rounds up to 1
+  //
+  unsigned long scale = powersOfTen[digitsRightOfDecimal];
+  unsigned long integerPart = (unsigned long) n;
+  unsigned long fractionPart = (unsigned long) ((n - (double) integerPart) * (double) scale + 0.5);
+  if (fractionPart >= scale)
+  {
+    fractionPart -= scale;
+    integerPart++;
+  }
 
-//
-// set the text font for the "print" functions
-//  Enter:  font -> the font typeface to load
-//
-void TouchUserInterfaceForArduino::lcdSetFont(const byte *font)
-{
-  currentFont = font;
+  length += formatDigits(buffer + length, integerPart, 0);
+  if (digitsRightOfDecimal > 0)
+  {
+    buffer[length++] = '.';
+    for (unsigned long digitScale = scale / 10; digitScale > 0; digitScale /= 10)
+    {
+      buffer[length++] = '0' + (fractionPart / digitScale);
+      fractionPart = fractionPart % digitScale;
+    }
+  }
+  buffer[length] = 0;
+  return(length);
 }
 
 
+// ---------------------------------------------------------------------------------
+//                                 Clipping functions  
+// ---------------------------------------------------------------------------------
 
 //
-// set the foreground color for the "print" functions
-//  Enter:  color = 16 bit color, bit format: rrrrrggggggbbbbb
+// Drawing can be clipped to a rectangle, ie: to keep a scrolled list from drawing
+// over the title bar.  pushClip() narrows the clip and popClip() puts back the 
+// one before it.  While a clip is set, every LCD function, the text and the images
+// only change the pixels inside of it.  A shape that's entirely outside of the clip 
+// (or off the screen) is dropped before anything is drawn or queued, one that's 
+// partly inside has its lines and rectangles trimmed before they're sent to the 
+// display.
+//
+//      ui.pushClip(0, 34, 320, 206);
+//      ...draw the list...
+//      ui.popClip();
 //
-void TouchUserInterfaceForArduino::lcdSetFontColor(uint16_t color)
-{
-  fontColor = color;
-}
 
 
 
 //
-// print a string to the LCD display
-//  Enter:  s -> a null terminated string 
+// clip drawing to a rectangle, inside of the current clip
+//  Enter:  x, y = upper left corner of the rectangle
+//          width, height = size of the rectangle
+//  Exit:   true returned, false if the clips are nested more than CLIP_STACK_DEPTH
+//            deep (the clip isn't changed, but popClip() must still be called)
 //
-void TouchUserInterfaceForArduino::lcdPrint(char *s)
+boolean TouchUserInterfaceForArduino::pushClip(int x, int y, int width, int height)
 {
-  int index = 0;
-  char c;
+  clipStackDepth++;
+  if (clipStackDepth > CLIP_STACK_DEPTH)
+    return(false);
 
-  while(true)
-  {
-    c = s[index++];
-    if (c == 0)
-      break;
-    lcdPrintCharacter(c);
-  }
-}
+  const CLIP_RECT &outerClip = clipStack[clipStackDepth - 1];
+  CLIP_RECT &clip = clipStack[clipStackDepth];
+  clip.leftX = max(x, (int) outerClip.leftX);
+  clip.topY = max(y, (int) outerClip.topY);
+  clip.rightX = min(x + width - 1, (int) outerClip.rightX);
+  clip.bottomY = min(y + height - 1, (int) outerClip.bottomY);
 
-void TouchUserInterfaceForArduino::lcdPrint(const char *s)
-{
-  lcdPrint((char*) s);
+  setDrawClip();
+  return(true);
 }
 
 
 
 //
-// print a signed int at location of the cursor
-//  Enter:  n = signed number to print 
+// put back the clip from before the last pushClip()
 //
-void TouchUserInterfaceForArduino::lcdPrint(int n)
+void TouchUserInterfaceForArduino::popClip(void)
 {
-  char stringBuffer[14];
-  
-  itoa(n, stringBuffer, 10);
-  lcdPrint(stringBuffer);
+  if (clipStackDepth == 0)
+    return;
+
+  clipStackDepth--;
+  if (clipStackDepth < CLIP_STACK_DEPTH)
+    setDrawClip();
 }
 
 
 
 //
-// print a float or double at location of the cursor
-//  Enter:  n = signed number to print 
-//          digitsRightOfDecimal = number of digits to display right of decimal point (optional)
+// check if a shape is entirely outside of the clip or the screen, so it doesn't 
+// need to be drawn
+//  Enter:  leftX, topY, rightX, bottomY = the box the shape is in, edges included
+//  Exit:   true returned if none of the box can be seen
 //
-void TouchUserInterfaceForArduino::lcdPrint(double n, int digitsRightOfDecimal)
+boolean TouchUserInterfaceForArduino::isClippedOut(int leftX, int topY, int rightX, int bottomY)
 {
-  char stringBuffer[40];
+  const CLIP_RECT &clip = clipStack[min(clipStackDepth, CLIP_STACK_DEPTH)];
 
-  dtostrf(n, 1, digitsRightOfDecimal, stringBuffer);
-  lcdPrint(stringBuffer);
+  if ((max(leftX, rightX) < max((int) clip.leftX, 0)) || 
+      (min(leftX, rightX) > min((int) clip.rightX, lcdWidth - 1)))
+    return(true);
+
+  return((max(topY, bottomY) < max((int) clip.topY, 0)) || 
+         (min(topY, bottomY) > min((int) clip.bottomY, lcdHeight - 1)));
 }
 
 
 
 //
-// print a string to the LCD, right justified at the cursor
-//  Enter:  s -> string to print 
+// give the display the clip on the top of the stack, or queue it for the render 
+// loop so it's used for the commands queued after it
 //
-void TouchUserInterfaceForArduino::lcdPrintRightJustified(char *s)
+void TouchUserInterfaceForArduino::setDrawClip(void)
 {
-  int cursorX;
-  int cursorY;
-
-  lcdGetCursorXY(&cursorX, &cursorY);           // get the current cursor position
-  int stringWidth = lcdStringWidthInPixels(s);  // get the width of the string to print
-  cursorX = cursorX - stringWidth;              // determine new X coord for cursor to right justify
+  const CLIP_RECT &clip = clipStack[min(clipStackDepth, CLIP_STACK_DEPTH)];
 
-  if (cursorX < 0)                              // set the new cursor position
-    cursorX = 0;
-  lcdSetCursorXY(cursorX, cursorY);
-  
-  lcdPrint(s);                                  // print the string
-}
-
-void TouchUserInterfaceForArduino::lcdPrintRightJustified(const char *s)
-{
-  lcdPrintRightJustified((char *)s);
+  LCD_BUS_LOCK();
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_SET_CLIP, 0, NULL, clip.leftX, clip.topY, clip.rightX, clip.bottomY);
+  else
+    drawClip = clip;
 }
 
 
+// ---------------------------------------------------------------------------------
+//                                    LCD functions  
+// ---------------------------------------------------------------------------------
 
 //
-// print a signed int on the LCD, right justify at the cursor 
-//  Enter:  n = signed number to print 
+// initialize the LCD display
+//  Enter:  lcdOrientation = LCD_ORIENTATION_PORTRAIT_4PIN_TOP, LCD_ORIENTATION_LANDSCAPE_4PIN_LEFT
+//                           LCD_ORIENTATION_PORTRAIT_4PIN_BOTTOM, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT
+//          font -> the font typeface to load, ei: Arial_10
 //
-void TouchUserInterfaceForArduino::lcdPrintRightJustified(int n)
+void TouchUserInterfaceForArduino::lcdInitialize(int lcdOrientation, const byte *font)
 {
-  char stringBuffer[14];
-  
-  itoa(n, stringBuffer, 10);
-  lcdPrintRightJustified(stringBuffer);
+  lcd->begin();
+  lcdSetOrientation(lcdOrientation);
+  lcdClearScreen(LCD_BLACK);
+  lcdSetFontColor(LCD_WHITE);  
+  lcdSetFont(font);
 }
 
 
 
 //
-// print a float on the LCD, right justify at the cursor 
-//  Enter:  n = signed number to print 
-//          digitsRightOfDecimal = number of digits to display right of decimal point (optional)
+// set the LCD display's orientation
+//  Enter:  lcdOrientation = LCD_ORIENTATION_PORTRAIT_4PIN_TOP, LCD_ORIENTATION_LANDSCAPE_4PIN_LEFT
+//                           LCD_ORIENTATION_PORTRAIT_4PIN_BOTTOM, LCD_ORIENTATION_LANDSCAPE_4PIN_RIGHT
 //
-void TouchUserInterfaceForArduino::lcdPrintRightJustified(double n, int digitsRightOfDecimal)
+void TouchUserInterfaceForArduino::lcdSetOrientation(int lcdOrientation)
 {
-  char stringBuffer[40];
-
-  dtostrf(n, 1, digitsRightOfDecimal, stringBuffer);
-  lcdPrintRightJustified(stringBuffer);
+  waitForRenderQueue();
+  {
+    LCD_BUS_LOCK();
+    lcd->setRotation(lcdOrientation);
+  }
+  lcdWidth = lcd->width();
+  lcdHeight = lcd->height();
+  lcdSetCursorXY(0, 0);
 }
 
 
 
 //
-// print a string to the LCD, centered side-to-side at the cursor 
-//  Enter:  s -> string to print 
+// fill the entire lcd screen with the given color
+//  Enter:  color = 16 bit color, bit format: rrrrrggggggbbbbb
 //
-void TouchUserInterfaceForArduino::lcdPrintCentered(char *s)
+void TouchUserInterfaceForArduino::lcdClearScreen(uint16_t color)
 {
-  int cursorX;
-  int cursorY;
+  PROFILE_FUNCTION(PROFILE_LCD_CLEAR_SCREEN);
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS((long) lcdWidth * lcdHeight);
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_CLEAR_SCREEN, color, NULL);
+  else
+    lcd->fillScreen(color);
+}
 
-  lcdGetCursorXY(&cursorX, &cursorY);           // get the current cursor position
-  int stringWidth = lcdStringWidthInPixels(s);  // get the width of the string to print
-  cursorX = cursorX - stringWidth/2;            // determine new X coord for cursor to center
 
-  if (cursorX < 0)                              // set the new cursor position
-    cursorX = 0;
-  lcdSetCursorXY(cursorX, cursorY);
-  
-  lcdPrint(s);                                  // print the string
-}
 
-void TouchUserInterfaceForArduino::lcdPrintCentered(const char *s)
+//
+// draw one pixel with the given coords and color
+//  Enter:  x, y = coords of the pixel to draw
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawPixel(int x, int y, uint16_t color)
 {
-  lcdPrintCentered((char *) s);
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_PIXEL);
+  if (isClippedOut(x, y, x, y))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS(1);
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_PIXEL, color, NULL, x, y);
+  else
+    lcd->drawPixel(x, y, color);
 }
 
 
 
 //
-// print a signed int to the LCD, centered side-to-side at the cursor
-//  Enter:  n = signed number to print 
+// draw a line with the given coords and color
+//  Enter:  x1, y1 = first endpoint of line
+//          x2, y2 = second endpoint of line
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
 //
-void TouchUserInterfaceForArduino::lcdPrintCentered(int n)
+void TouchUserInterfaceForArduino::lcdDrawLine(int x1, int y1, int x2, int y2, uint16_t color)
 {
-  char stringBuffer[14];
-  
-  itoa(n, stringBuffer, 10);
-  lcdPrintCentered(stringBuffer);
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_LINE);
+  if (isClippedOut(x1, y1, x2, y2))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS(max(abs(x2 - x1), abs(y2 - y1)) + 1);
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_LINE, color, NULL, x1, y1, x2, y2);
+  else
+    lcd->drawLine(x1, y1, x2, y2, color);
 }
 
 
 
 //
-// print a float to the LCD, centered side-to-side at the cursor
-//          digitsRightOfDecimal = number of digits to display right of decimal point (optional)
-//  Enter:  n = signed number to print 
+// draw a horizontal line with the given coords, length and color
+//  Enter:  x, y = first endpoint of line
+//          length = length of line
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
 //
-void TouchUserInterfaceForArduino::lcdPrintCentered(double n, int digitsRightOfDecimal)
+void TouchUserInterfaceForArduino::lcdDrawHorizontalLine(int x, int y, int length, uint16_t color)
 {
-  char stringBuffer[40];
-
-  dtostrf(n, 1, digitsRightOfDecimal, stringBuffer);
-  lcdPrintCentered(stringBuffer);
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_HORIZONTAL_LINE);
+  if (isClippedOut(x, y, x + length - 1, y))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS(length);
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_HORIZONTAL_LINE, color, NULL, x, y, length);
+  else
+    lcd->drawFastHLine(x, y, length, color);
 }
 
 
 
 //
-// print one ASCII charater to the LCD, at location of the cursor
-//  Enter:  c = character to display
-//
-void TouchUserInterfaceForArduino::lcdPrintCharacter(byte c)
-{
-  const byte *tablePntr;
-  uint16_t columnOfPixels;
-  
-  //
-  // make sure char is in ASCII range
-  //
-  if ((c < 0x20) || (c > 0x7f))
+// draw a vertical line with the given coords, length and color
+//  Enter: x, y = first endpoint of line
+//          length = length of line
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawVerticalLine(int x, int y, int length, uint16_t color)
+{
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_VERTICAL_LINE);
+  if (isClippedOut(x, y, x, y + length - 1))
     return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS(length);
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_VERTICAL_LINE, color, NULL, x, y, length);
+  else
+    lcd->drawFastVLine(x, y, length, color);
+}
 
-  //
-  // get info about the font
-  //
-  int characterHeight = pgm_read_byte(&currentFont[FONT_TABLE_HEIGHT_IDX]);
-  int extraSpaceBetweenChars = pgm_read_byte(&currentFont[FONT_TABLE_PAD_AFTER_CHAR_IDX]);
-  
+
+
+//
+// draw rectangle at the given coords, length, width and color
+//  Enter:  x, y = upper left corner of rect
+//          width = width of rectangle
+//          height = height of rectangle
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawRectangle(int x, int y, int width, int height, uint16_t color)
+{
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_RECTANGLE);
+  if (isClippedOut(x, y, x + width - 1, y + height - 1))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS(2 * (width + height));
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_RECTANGLE, color, NULL, x, y, width, height);
+  else
+    lcd->drawRect(x, y, width, height, color);
+}
+
+
+
+//
+// draw rounded rectangle at the given coords, length, width and color
+//  Enter:  x, y = upper left corner of rect
+//          width = width of rectangle
+//          height = height of rectangle
+//          radius = radius of the corners
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawRoundedRectangle(int x, int y, int width, int height, int radius, uint16_t color)
+{
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_ROUNDED_RECTANGLE);
+  if (isClippedOut(x, y, x + width - 1, y + height - 1))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS(2 * (width + height));
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_ROUNDED_RECTANGLE, color, NULL, x, y, width, height, radius);
+  else
+    lcd->drawRoundRect(x, y, width, height, radius, color);
+}
+
+
+
+//
+// draw a circle at the given coords, radius and color
+//  Enter:  x0, y0 = endpoint 0 of the triangle
+//          x1, y1 = endpoint 1 of the triangle
+//          x2, y2 = endpoint 2 of the triangle
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawTriangle(int x0, int y0, int x1, int y1, int x2, int y2, uint16_t color)
+{
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_TRIANGLE);
+  if (isClippedOut(min(x0, min(x1, x2)), min(y0, min(y1, y2)), max(x0, max(x1, x2)), max(y0, max(y1, y2))))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS(max(abs(x1 - x0), abs(y1 - y0)) + max(abs(x2 - x1), abs(y2 - y1)) + max(abs(x0 - x2), abs(y0 - y2)));
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_TRIANGLE, color, NULL, x0, y0, x1, y1, x2, y2);
+  else
+    lcd->drawTriangle(x0, y0, x1, y1, x2, y2, color);
+}
+
+
+
+//
+// draw a triangle at the given coords and color
+//  Enter:  x, y = upper left corner of rect
+//          radius = radius of the circle
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawCircle(int x, int y, int radius, uint16_t color)
+{
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_CIRCLE);
+  if (isClippedOut(x - radius, y - radius, x + radius, y + radius))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS((radius * 44) / 7);
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_CIRCLE, color, NULL, x, y, radius);
+  else
+    lcd->drawCircle(x, y, radius, color);
+}
+
+
+
+//
+// draw a filled rectangle at the given coords, length, width and color
+//  Enter:  x, y = upper left corner of rect
+//          width = width of rectangle
+//          height = height of rectangle
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawFilledRectangle(int x, int y, int width, int height, uint16_t color)
+{
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_FILLED_RECTANGLE);
+  if (isClippedOut(x, y, x + width - 1, y + height - 1))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS((long) width * height);
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_FILLED_RECTANGLE, color, NULL, x, y, width, height);
+  else
+    lcd->fillRect(x, y, width, height, color);
+}
+
+
+
+//
+// draw a filled rounded rectangle at the given coords, length, width and color
+//  Enter:  x, y = upper left corner of rect
+//          width = width of rectangle
+//          height = height of rectangle
+//          radius = radius of the corners
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawFilledRoundedRectangle(int x, int y, int width, int height, int radius, uint16_t color)
+{
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_FILLED_ROUNDED_RECTANGLE);
+  if (isClippedOut(x, y, x + width - 1, y + height - 1))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS((long) width * height);
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_FILLED_ROUNDED_RECTANGLE, color, NULL, x, y, width, height, radius);
+  else
+    lcdDrawFilledRoundedRectanglePixels(x, y, width, height, radius, color);
+}
+
+
+
+//
+// draw a circle at the given coords, radius and color
+//  Enter:  x0, y0 = endpoint 0 of the triangle
+//          x1, y1 = endpoint 1 of the triangle
+//          x2, y2 = endpoint 2 of the triangle
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawFilledTriangle(int x0, int y0, int x1, int y1, int x2, int y2, uint16_t color)
+{
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_FILLED_TRIANGLE);
+  if (isClippedOut(min(x0, min(x1, x2)), min(y0, min(y1, y2)), max(x0, max(x1, x2)), max(y0, max(y1, y2))))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS(abs((long) (x1 - x0) * (y2 - y0) - (long) (x2 - x0) * (y1 - y0)) / 2);
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_FILLED_TRIANGLE, color, NULL, x0, y0, x1, y1, x2, y2);
+  else
+    lcdDrawFilledTrianglePixels(x0, y0, x1, y1, x2, y2, color);
+}
+
+
+
+//
+// draw a filled circle at the given coords, radius and color
+//  Enter:  x, y = upper left corner of rect
+//          radius = radius of the circle
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawFilledCircle(int x, int y, int radius, uint16_t color)
+{
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_FILLED_CIRCLE);
+  if (isClippedOut(x - radius, y - radius, x + radius, y + radius))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS(((long) radius * radius * 22) / 7);
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_FILLED_CIRCLE, color, NULL, x, y, radius);
+  else
+    lcdDrawFilledCirclePixels(x, y, radius, color);
+}
+
+
+
+//
+// the biggest corner or circle radius, and the widest triangle, that are filled
+// with merged rectangles.  Bigger ones are left to Adafruit, these limits keep
+// the tables of column heights on the stack small.
+//
+const int FILLED_SHAPE_MAX_RADIUS = 160;
+const int FILLED_TRIANGLE_MAX_COLUMNS = 64;
+
+
+
+//
+// draw the pixels of a filled rounded rectangle.  The pixels are the same as 
+// Adafruit's fillRoundRect(), but neighboring columns of the same height are sent
+// as one rectangle, so the middle of the rectangle and each run of equal columns 
+// in the corners costs one address window, instead of one per column
+//  Enter:  x, y = upper left corner of rect
+//          width = width of rectangle
+//          height = height of rectangle
+//          radius = radius of the corners
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawFilledRoundedRectanglePixels(int x, int y, int width, int height, int radius, uint16_t color)
+{
+  int maxRadius = ((width < height) ? width : height) / 2;
+  if (radius > maxRadius)
+    radius = maxRadius;
+
+  if (radius > FILLED_SHAPE_MAX_RADIUS)
+  {
+    lcd->fillRoundRect(x, y, width, height, radius, color);
+    return;
+  }
+
+  lcdDrawFilledRoundedColumns(x + radius, x + width - radius - 1, y + radius, radius, height - 2*radius, color);
+}
+
+
+
+//
+// draw the pixels of a filled circle, the same pixels as Adafruit's fillCircle(), 
+// with neighboring columns of the same height sent as one rectangle
+//  Enter:  x, y = center of the circle
+//          radius = radius of the circle
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawFilledCirclePixels(int x, int y, int radius, uint16_t color)
+{
+  if ((radius < 0) || (radius > FILLED_SHAPE_MAX_RADIUS))
+  {
+    lcd->fillCircle(x, y, radius, color);
+    return;
+  }
+
+  lcdDrawFilledRoundedColumns(x, x, y, radius, 1, color);
+}
+
+
+
+//
+// find the height of each column in a rounded corner, with the same midpoint 
+// circle as Adafruit's fillCircleHelper()
+//  Enter:  radius = radius of the corner, 0 to FILLED_SHAPE_MAX_RADIUS
+//          halfHeights -> table for radius + 1 heights
+//  Exit:   halfHeights[n] = how far the column n pixels from the corner's center 
+//            reaches above it, -1 if that column isn't drawn
+//
+static void findCornerHalfHeights(int radius, int16_t *halfHeights)
+{
+  for (int i = 0; i <= radius; i++)
+    halfHeights[i] = -1;
+
+  int f = 1 - radius;
+  int ddF_x = 1;
+  int ddF_y = -2 * radius;
+  int x = 0;
+  int y = radius;
+  int px = x;
+  int py = y;
+
+  while (x < y)
+  {
+    if (f >= 0)
+    {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+
+    if ((x < y + 1) && (y > halfHeights[x]))
+      halfHeights[x] = y;
+    if (y != py)
+    {
+      if (px > halfHeights[py])
+        halfHeights[py] = px;
+      py = y;
+    }
+    px = x;
+  }
+}
+
+
+
+//
+// draw a shape with round ends: full height columns from leftX to rightX, then 
+// each side is a half circle, stretched down by "stretch" pixels.  A circle is 
+// one column stretched 1 pixel, a rounded rectangle is the columns between the
+// centers of its corners.
+//
+// Instead of a line for each column of the half circles, the runs of columns 
+// with the same height are filled as one rectangle.  The full height columns are
+// widened by the columns on each side that are just as tall.
+//  Enter:  leftX, rightX = first and last full height columns (rightX = leftX - 1 when there are none)
+//          centerY = center of the top corners
+//          radius = radius of the corners
+//          stretch = pixels the corners are stretched down by, plus 1
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawFilledRoundedColumns(int leftX, int rightX, int centerY, int radius, int stretch, uint16_t color)
+{
+  int16_t halfHeights[FILLED_SHAPE_MAX_RADIUS + 1];
+  findCornerHalfHeights(radius, halfHeights);
 
   //
-  // get a pointer to the pixel data in the font for the character
-  //
-  int indexToCharacterIndex = FONT_TABLE_CHAR_LOOKUP_IDX + (((int)(c - 0x20)) << 1);
-  tablePntr = currentFont + indexToCharacterIndex;
-  int indexToPixels = pgm_read_word(tablePntr);
-  tablePntr = currentFont + indexToPixels;
-  
-  //
-  // determine the number of columns for the character
+  // fill the full height columns, along with the columns beside them that are as tall
   //
-  int characterWidth = pgm_read_byte(tablePntr++);
+  lcd->startWrite();
+  int column = 1;
+  while ((column <= radius) && (halfHeights[column] == radius))
+    column++;
+  lcd->writeFillRect(leftX - (column - 1), centerY - radius, 
+    rightX - leftX + 1 + 2*(column - 1), 2*radius + stretch, color);
 
   //
-  // loop through the font character collecting & writing each column of pixel data
+  // fill each run of columns with the same height, on the right then the left
   //
-  for (int column = 0; column < characterWidth; column++)
-  {     
-    columnOfPixels = (uint16_t) pgm_read_word(tablePntr);
-    tablePntr += 2;
+  while (column <= radius)
+  {
+    int runStart = column;
+    int halfHeight = halfHeights[column];
+    while ((column <= radius) && (halfHeights[column] == halfHeight))
+      column++;
 
-    boolean foundTop = false;
-    int row = 0;
-    int rowTop;
-    int colLength;
-    while(row < characterHeight)
-    {      
-      if (columnOfPixels & 0x0001)
-      {
-        if (!foundTop)
-        {
-          foundTop = true;
-          rowTop = row;
-          colLength = 1;
-        }
-        else
-          colLength++;
-      }
-      else
-      {
-        if (foundTop)
-        {
-          lcd->drawFastVLine(textCursorX, textCursorY+rowTop, colLength, fontColor);      
-          foundTop = false;
-        }
-      }
-      columnOfPixels = columnOfPixels >> 1;
-      row++;
+    if (halfHeight >= 0)
+    {
+      lcd->writeFillRect(rightX + runStart, centerY - halfHeight, 
+        column - runStart, 2*halfHeight + stretch, color);
+      lcd->writeFillRect(leftX - (column - 1), centerY - halfHeight, 
+        column - runStart, 2*halfHeight + stretch, color);
     }
-
-    if (foundTop)
-      lcd->drawFastVLine(textCursorX, textCursorY+rowTop, colLength, fontColor);
- 
-    //
-    // advance to next column of pixels, make sure that we haven't gone too far to the left
-    // 
-    if (textCursorX >= lcdWidth - 1)
-      return;
-    textCursorX++;
   }
+  lcd->endWrite();
+}
+
 
-  textCursorX += extraSpaceBetweenChars;
+
+//
+// swap two corners of a triangle
+//
+static void swapTriangleCorners(int *x, int *y, int i, int j)
+{
+  int t = x[i];
+  x[i] = x[j];
+  x[j] = t;
+  t = y[i];
+  y[i] = y[j];
+  y[j] = t;
 }
 
 
 
-////
-//// print one ASCII charater to the LCD, at location of the cursor
-////  Enter:  c = character to display
-////
-//void TouchUserInterfaceForArduino::lcdPrintCharacter(byte c)
-//{
+//
+// get the span of pixels that Adafruit's fillTriangle() fills on a row, the 
+// corners must be sorted from top to bottom
+//  Enter:  x[], y[] = corners of the triangle, y[0] <= y[1] <= y[2], y[0] < y[2]
+//          row = row to get, y[0] to y[2]
+//  Exit:   *left, *right = first and last pixel filled on the row
+//
+static void triangleRowSpan(const int *x, const int *y, int row, int *left, int *right)
+{
+  int lastRowOfTop = (y[1] == y[2]) ? y[1] : y[1] - 1;
+  int a, b;
+
+  if (row <= lastRowOfTop)
+    a = x[0] + (int) (((long) (x[1] - x[0]) * (row - y[0])) / (y[1] - y[0]));
+  else
+    a = x[1] + (int) (((long) (x[2] - x[1]) * (row - y[1])) / (y[2] - y[1]));
+  b = x[0] + (int) (((long) (x[2] - x[0]) * (row - y[0])) / (y[2] - y[0]));
+
+  if (a > b)
+  {
+    *left = b;
+    *right = a;
+  }
+  else
+  {
+    *left = a;
+    *right = b;
+  }
+}
+
+
+
+//
+// draw the pixels of a filled triangle.  The pixels are the same as Adafruit's 
+// fillTriangle(), which fills one row at a time.  Rows that are the same are 
+// sent as one rectangle.  When the triangle isn't too wide, its columns are also
+// found and used instead if that takes fewer rectangles, a triangle that's 
+// wider than it is tall has fewer columns than rows.
+//  Enter:  x0, y0 = endpoint 0 of the triangle
+//          x1, y1 = endpoint 1 of the triangle
+//          x2, y2 = endpoint 2 of the triangle
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawFilledTrianglePixels(int x0, int y0, int x1, int y1, int x2, int y2, uint16_t color)
+{
+  int x[3] = {x0, x1, x2};
+  int y[3] = {y0, y1, y2};
+  int left, right;
+
+  //
+  // sort the corners from top to bottom, the same way Adafruit does
+  //
+  if (y[0] > y[1])
+    swapTriangleCorners(x, y, 0, 1);
+  if (y[1] > y[2])
+    swapTriangleCorners(x, y, 1, 2);
+  if (y[0] > y[1])
+    swapTriangleCorners(x, y, 0, 1);
+
+  if (y[0] == y[2])
+  {
+    lcd->fillTriangle(x[0], y[0], x[1], y[1], x[2], y[2], color);
+    return;
+  }
+
+  //
+  // count the rectangles needed to fill by rows
+  //
+  int rowRectangles = 0;
+  int lastLeft = 0;
+  int lastRight = -1;
+  long pixels = 0;
+  for (int row = y[0]; row <= y[2]; row++)
+  {
+    triangleRowSpan(x, y, row, &left, &right);
+    if ((row == y[0]) || (left != lastLeft) || (right != lastRight))
+      rowRectangles++;
+    lastLeft = left;
+    lastRight = right;
+    pixels += right - left + 1;
+  }
+
+  //
+  // if the triangle isn't too wide, find its columns and fill by columns when 
+  // that takes fewer rectangles.  The columns are only used if they hold all 
+  // of the pixels that the rows do, so a column is never filled across a gap.
+  //
+  int minX = min(x[0], min(x[1], x[2]));
+  int columns = max(x[0], max(x[1], x[2])) - minX + 1;
+  if (columns <= FILLED_TRIANGLE_MAX_COLUMNS)
+  {
+    int16_t columnTops[FILLED_TRIANGLE_MAX_COLUMNS];
+    int16_t columnBottoms[FILLED_TRIANGLE_MAX_COLUMNS];
+
+    for (int i = 0; i < columns; i++)
+    {
+      columnTops[i] = y[2] + 1;
+      columnBottoms[i] = y[0] - 1;
+    }
+
+    for (int row = y[0]; row <= y[2]; row++)
+    {
+      triangleRowSpan(x, y, row, &left, &right);
+      for (int i = left - minX; i <= right - minX; i++)
+      {
+        if (row < columnTops[i])
+          columnTops[i] = row;
+        columnBottoms[i] = row;
+      }
+    }
+
+    int columnRectangles = 0;
+    long columnPixels = 0;
+    for (int i = 0; i < columns; i++)
+    {
+      if (columnBottoms[i] < columnTops[i])
+        continue;
+      if ((i == 0) || (columnTops[i] != columnTops[i - 1]) || (columnBottoms[i] != columnBottoms[i - 1]))
+        columnRectangles++;
+      columnPixels += columnBottoms[i] - columnTops[i] + 1;
+    }
+
+    if ((columnPixels == pixels) && (columnRectangles < rowRectangles))
+    {
+      lcd->startWrite();
+      int i = 0;
+      while (i < columns)
+      {
+        int runStart = i;
+        while ((i < columns) && (columnTops[i] == columnTops[runStart]) && (columnBottoms[i] == columnBottoms[runStart]))
+          i++;
+        if (columnBottoms[runStart] >= columnTops[runStart])
+          lcd->writeFillRect(minX + runStart, columnTops[runStart], i - runStart, 
+            columnBottoms[runStart] - columnTops[runStart] + 1, color);
+      }
+      lcd->endWrite();
+      return;
+    }
+  }
+
+  //
+  // fill by rows, each run of rows that are the same is one rectangle
+  //
+  lcd->startWrite();
+  int runStartRow = y[0];
+  triangleRowSpan(x, y, y[0], &lastLeft, &lastRight);
+  for (int row = y[0] + 1; row <= y[2] + 1; row++)
+  {
+    if (row <= y[2])
+    {
+      triangleRowSpan(x, y, row, &left, &right);
+      if ((left == lastLeft) && (right == lastRight))
+        continue;
+    }
+    lcd->writeFillRect(lastLeft, runStartRow, lastRight - lastLeft + 1, row - runStartRow, color);
+    runStartRow = row;
+    lastLeft = left;
+    lastRight = right;
+  }
+  lcd->endWrite();
+}
+
+
+
+//
+// most pixels of a button the compositor draws at a time, the rows are drawn in 
+// bands that fit in a buffer this big on the stack, and a row wider than this is
+// drawn in pieces
+//
+const int BUTTON_BAND_BUFFER_PIXELS = 128;
+
+
+//
+// get the width of a line of text for the compositor, the same as printing it 
+// advances the cursor
+//  Enter:  font -> the font typeface
+//          s -> the text
+//  Exit:   width in pixels returned
+//
+static int compositeTextWidth(const byte *font, const char *s)
+{
+  int width = 0;
+  int extraSpaceBetweenChars = pgm_read_byte(&font[FONT_TABLE_PAD_AFTER_CHAR_IDX]);
+
+  for (; *s != 0; s++)
+  {
+    byte c = *s;
+    if ((c < 0x20) || (c > 0x7f))
+      continue;
+    const byte *tablePntr = font + pgm_read_word(font + FONT_TABLE_CHAR_LOOKUP_IDX + (((int)(c - 0x20)) << 1));
+    width += pgm_read_byte(tablePntr) + extraSpaceBetweenChars;
+  }
+  return(width);
+}
+
+
+
+//
+// draw a band of a button into a buffer, setting each pixel to the color it ends 
+// up being when the face, text, arrow and bars are drawn one after the other
+//  Enter:  button = the button, its arrow's corners sorted from top to bottom
+//          halfHeights -> half heights of the columns of its rounded corners
+//          topRow = screen row of the band's first row
+//          rowCount = number of rows in the band
+//          leftColumn = screen column of the band's first column
+//          columnCount = number of columns in the band
+//          band -> buffer for rowCount rows of columnCount pixels
+//
+static void compositeButtonRows(const BUTTON_COMPOSITE &button, const int16_t *halfHeights, 
+  int topRow, int rowCount, int leftColumn, int columnCount, uint16_t *band)
+{
+  int bottomRow = topRow + rowCount - 1;
+  int rightColumn = leftColumn + columnCount - 1;
+
+  //
+  // the face, with the frame on the left and top edges or the rounded corners 
+  // showing the background
+  //
+  int leftCenterX = button.x + button.radius;
+  int rightCenterX = button.x + button.width - button.radius - 1;
+  int centerY = button.y + button.radius;
+  int stretch = button.height - 2 * button.radius;
+
+  for (int row = topRow; row <= bottomRow; row++)
+  {
+    uint16_t *pixel = band + (row - topRow) * columnCount;
+    for (int x = leftColumn; x <= rightColumn; x++)
+    {
+      uint16_t color = button.faceColor;
+      if (button.frameFlg && ((x == button.x) || (row == button.y)))
+        color = button.frameColor;
+      else if ((x < leftCenterX) || (x > rightCenterX))
+      {
+        int halfHeight = halfHeights[(x < leftCenterX) ? leftCenterX - x : x - rightCenterX];
+        if ((halfHeight < 0) || (row < centerY - halfHeight) || (row > centerY + halfHeight + stretch - 1))
+          color = button.backgroundColor;
+      }
+      *pixel++ = color;
+    }
+  }
+
+  //
+  // the lines of text, each character's pixels are columns with a bit per row
+  //
+  for (int line = 0; line < 2; line++)
+  {
+    if (button.text[line] == NULL)
+      continue;
+
+    int textY = button.textY[line];
+    int characterHeight = pgm_read_byte(&button.font[FONT_TABLE_HEIGHT_IDX]);
+    if ((textY > bottomRow) || (textY + characterHeight - 1 < topRow))
+      continue;
+
+    int firstRow = max(textY, topRow);
+    int lastRow = min(textY + characterHeight - 1, bottomRow);
+    int extraSpaceBetweenChars = pgm_read_byte(&button.font[FONT_TABLE_PAD_AFTER_CHAR_IDX]);
+    int x = button.textX[line];
+
+    for (const char *s = button.text[line]; *s != 0; s++)
+    {
+      byte c = *s;
+      if ((c < 0x20) || (c > 0x7f))
+        continue;
+
+      const byte *tablePntr = button.font + pgm_read_word(button.font + FONT_TABLE_CHAR_LOOKUP_IDX + (((int)(c - 0x20)) << 1));
+      int characterWidth = pgm_read_byte(tablePntr++);
+
+      for (int column = 0; column < characterWidth; column++)
+      {
+        uint16_t columnOfPixels = (uint16_t) pgm_read_word(tablePntr);
+        tablePntr += 2;
+        if ((x + column < leftColumn) || (x + column > rightColumn))
+          continue;
+
+        uint16_t *pixel = band + (firstRow - topRow) * columnCount + (x + column - leftColumn);
+        for (int row = firstRow; row <= lastRow; row++)
+        {
+          if ((row - textY < 16) && ((columnOfPixels >> (row - textY)) & 0x0001))
+            *pixel = button.textColor;
+          pixel += columnCount;
+        }
+      }
+      x += characterWidth + extraSpaceBetweenChars;
+    }
+  }
+
+  //
+  // the arrow, with the same pixels as Adafruit's fillTriangle()
+  //
+  if (button.arrowFlg)
+  {
+    const int *arrowX = button.arrowX;
+    const int *arrowY = button.arrowY;
+    int firstRow = max(arrowY[0], topRow);
+    int lastRow = min(arrowY[2], bottomRow);
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+      int left, right;
+      if (arrowY[0] == arrowY[2])
+      {
+        left = min(arrowX[0], min(arrowX[1], arrowX[2]));
+        right = max(arrowX[0], max(arrowX[1], arrowX[2]));
+      }
+      else
+        triangleRowSpan(arrowX, arrowY, row, &left, &right);
+      left = max(left, leftColumn);
+      right = min(right, rightColumn);
+
+      uint16_t *pixel = band + (row - topRow) * columnCount + (left - leftColumn);
+      for (int x = left; x <= right; x++)
+        *pixel++ = button.symbolColor;
+    }
+  }
+
+  //
+  // the bars
+  //
+  for (int bar = 0; bar < button.barCount; bar++)
+  {
+    int barTop = button.barY + bar * button.barSpacing;
+    int firstRow = max(barTop, topRow);
+    int lastRow = min(barTop + button.barHeight - 1, bottomRow);
+    int left = max(button.barX, leftColumn);
+    int right = min(button.barX + button.barWidth - 1, rightColumn);
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+      uint16_t *pixel = band + (row - topRow) * columnCount + (left - leftColumn);
+      for (int x = left; x <= right; x++)
+        *pixel++ = button.symbolColor;
+    }
+  }
+}
+
+
+
+//
+// draw a button with the compositor.  Each band of rows is built in a buffer 
+// with the face, frame, text, arrow and bars already drawn over each other, then
+// sent to the display.  The whole button is one address window with each pixel 
+// sent once, instead of a window for the face, each line of the frame, each 
+// column of each character and each row of the arrow.
+//
+// Only a button that is all on the screen and inside of the clip, with all of its
+// text, arrow and bars inside of it, is drawn this way.  Commands queued for the
+// render loop aren't composited either.
+//  Enter:  button = the button to draw, the font and font color must already be
+//            set to the button's font and text color
+//  Exit:   true returned if the button was drawn, false if it needs to be drawn
+//            with the LCD functions
+//
+boolean TouchUserInterfaceForArduino::drawCompositeButton(BUTTON_COMPOSITE &button)
+{
+  int rightX = button.x + button.width - 1;
+  int bottomY = button.y + button.height - 1;
+
+  if ((renderQueue != NULL) || (button.width <= 0) || (button.height <= 0))
+    return(false);
+
+  //
+  // check that the button is on the screen and inside of the clip
+  //
+  const CLIP_RECT &clip = clipStack[min(clipStackDepth, CLIP_STACK_DEPTH)];
+  if ((button.x < max((int) clip.leftX, 0)) || (rightX > min((int) clip.rightX, lcdWidth - 1)) ||
+      (button.y < max((int) clip.topY, 0)) || (bottomY > min((int) clip.bottomY, lcdHeight - 1)))
+    return(false);
+
+  //
+  // corners are limited to half of the button, the same as Adafruit's fillRoundRect()
+  //
+  int maxRadius = min(button.width, button.height) / 2;
+  if (button.radius > maxRadius)
+    button.radius = maxRadius;
+  if ((button.radius < 0) || (button.radius > FILLED_SHAPE_MAX_RADIUS))
+    return(false);
+
+  //
+  // check that the text, arrow and bars are inside of the button
+  //
+  for (int line = 0; line < 2; line++)
+  {
+    if (button.text[line] == NULL)
+      continue;
+    int characterHeight = pgm_read_byte(&button.font[FONT_TABLE_HEIGHT_IDX]);
+    int textWidth = compositeTextWidth(button.font, button.text[line]);
+    if ((button.textX[line] < button.x) || (button.textX[line] + textWidth - 1 > rightX) || 
+        (button.textY[line] < button.y) || (button.textY[line] + characterHeight - 1 > bottomY))
+      return(false);
+  }
+
+  if (button.arrowFlg)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      if ((button.arrowX[i] < button.x) || (button.arrowX[i] > rightX) || 
+          (button.arrowY[i] < button.y) || (button.arrowY[i] > bottomY))
+        return(false);
+    }
+
+    if (button.arrowY[0] > button.arrowY[1])
+      swapTriangleCorners(button.arrowX, button.arrowY, 0, 1);
+    if (button.arrowY[1] > button.arrowY[2])
+      swapTriangleCorners(button.arrowX, button.arrowY, 1, 2);
+    if (button.arrowY[0] > button.arrowY[1])
+      swapTriangleCorners(button.arrowX, button.arrowY, 0, 1);
+  }
+
+  if ((button.barCount > 0) && 
+      ((button.barX < button.x) || (button.barX + button.barWidth - 1 > rightX) || 
+       (button.barY < button.y) || (button.barY + (button.barCount - 1) * button.barSpacing + button.barHeight - 1 > bottomY)))
+    return(false);
+
+  //
+  // draw the button a band of rows at a time through one address window, or a 
+  // piece of a row at a time when a row doesn't fit in the band
+  //
+  {
+    LCD_BUSY_TIMER();
+    LCD_BUS_LOCK();
+    PROFILE_PIXELS((long) button.width * button.height);
+
+    int16_t halfHeights[FILLED_SHAPE_MAX_RADIUS + 1];
+    findCornerHalfHeights(button.radius, halfHeights);
+
+    uint16_t band[BUTTON_BAND_BUFFER_PIXELS];
+    int bandRows = max(BUTTON_BAND_BUFFER_PIXELS / button.width, 1);
+    int bandColumns = min(button.width, BUTTON_BAND_BUFFER_PIXELS);
+
+    lcd->startWrite();
+    lcd->setAddrWindow(button.x, button.y, button.width, button.height);
+    for (int row = button.y; row <= bottomY; row += bandRows)
+    {
+      int rowCount = min(bandRows, bottomY - row + 1);
+      for (int column = button.x; column <= rightX; column += bandColumns)
+      {
+        int columnCount = min(bandColumns, rightX - column + 1);
+        compositeButtonRows(button, halfHeights, row, rowCount, column, columnCount, band);
+        lcd->writePixels(band, (uint32_t) rowCount * columnCount);
+      }
+    }
+    lcd->endWrite();
+  }
+
+  //
+  // leave the cursor after the last line of text, where printing it would have,
+  // the text is on the screen so it never stops at the right edge
+  //
+  int lastLine = (button.text[1] != NULL) ? 1 : 0;
+  if (button.text[lastLine] != NULL)
+  {
+    drawContext.cursorX = button.textX[lastLine] + compositeTextWidth(button.font, button.text[lastLine]);
+    drawContext.cursorY = button.textY[lastLine];
+  }
+  return(true);
+}
+
+
+
+
+//
+// draw an image
+//  Enter:  x, y = coords of upper left corner on LCD where the image will be displayed
+//          width, height =  size of the image, this must be the same as the image data
+//          image -> image data, 2 bytes/pixel in the RGB565 format stored in PROGMEM
+// Note: use this utility to convert an image to C sourse code:
+//       www.rinkydinkelectronics.com/_t_doimageconverter565.php
+//
+void TouchUserInterfaceForArduino::lcdDrawImage(int x, int y, int width, int height, const uint16_t *image)
+{
+  PROFILE_FUNCTION(PROFILE_LCD_DRAW_IMAGE);
+  if (isClippedOut(x, y, x + width - 1, y + height - 1))
+    return;
+  LCD_BUSY_TIMER();
+  LCD_BUS_LOCK();
+  PROFILE_PIXELS((long) width * height);
+  if (renderQueue != NULL)
+    queueRenderCommand(RENDER_DRAW_IMAGE, 0, image, x, y, width, height);
+  else
+    lcd->drawRGBBitmap(x, y, image, width, height);
+}
+
+
+
+//
+// set the text font for the "print" functions
+//  Enter:  font -> the font typeface to load
+//
+void TouchUserInterfaceForArduino::lcdSetFont(const byte *font)
+{
+  drawContext.font = font;
+}
+
+
+
+//
+// set the foreground color for the "print" functions
+//  Enter:  color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdSetFontColor(uint16_t color)
+{
+  drawContext.fontColor = color;
+}
+
+
+
+//
+// print a string to the LCD display
+//  Enter:  s -> a null terminated string 
+//
+void TouchUserInterfaceForArduino::lcdPrint(char *s)
+{
+  lcdPrint(drawContext, s);
+}
+
+void TouchUserInterfaceForArduino::lcdPrint(const char *s)
+{
+  lcdPrint(drawContext, s);
+}
+
+
+
+//
+// print a string to the LCD display, at the cursor of a draw context
+//  Enter:  context = cursor, font and color to print with, the cursor is advanced
+//          s -> a null terminated string 
+//
+void TouchUserInterfaceForArduino::lcdPrint(DRAW_CONTEXT &context, const char *s)
+{
+  int index = 0;
+  char c;
+
+  while(true)
+  {
+    c = s[index++];
+    if (c == 0)
+      break;
+    lcdPrintCharacter(context, c);
+  }
+}
+
+
+
+//
+// print a signed int at location of the cursor
+//  Enter:  n = signed number to print 
+//
+void TouchUserInterfaceForArduino::lcdPrint(int n)
+{
+  char stringBuffer[UI_NUMBER_BUFFER_LENGTH];
+  
+  uiFormatInt(stringBuffer, n);
+  lcdPrint(stringBuffer);
+}
+
+
+
+//
+// print a float or double at location of the cursor.  Numbers beyond +/-4294967040
+// are printed as "ovf" (earlier versions of the library printed all of their digits).
+//  Enter:  n = signed number to print 
+//          digitsRightOfDecimal = number of digits to display right of decimal point (optional)
+//
+void TouchUserInterfaceForArduino::lcdPrint(double n, int digitsRightOfDecimal)
+{
+  char stringBuffer[UI_NUMBER_BUFFER_LENGTH];
+
+  uiFormatFloat(stringBuffer, n, digitsRightOfDecimal);
+  lcdPrint(stringBuffer);
+}
+
+
+
+//
+// print a string to the LCD, right justified at the cursor
+//  Enter:  s -> string to print 
+//
+void TouchUserInterfaceForArduino::lcdPrintRightJustified(char *s)
+{
+  lcdPrintRightJustified(drawContext, s);
+}
+
+void TouchUserInterfaceForArduino::lcdPrintRightJustified(const char *s)
+{
+  lcdPrintRightJustified(drawContext, s);
+}
+
+
+
+//
+// print a string to the LCD, right justified at the cursor of a draw context
+//  Enter:  context = cursor, font and color to print with, the cursor is advanced
+//          s -> string to print 
+//
+void TouchUserInterfaceForArduino::lcdPrintRightJustified(DRAW_CONTEXT &context, const char *s)
+{
+  int stringWidth = lcdStringWidthInPixels(context, s);   // get the width of the string to print
+  int cursorX = context.cursorX - stringWidth;            // determine new X coord for cursor to right justify
+
+  if (cursorX < 0)                                        // set the new cursor position
+    cursorX = 0;
+  context.cursorX = cursorX;
+  
+  lcdPrint(context, s);                                   // print the string
+}
+
+
+
+//
+// print a signed int on the LCD, right justify at the cursor 
+//  Enter:  n = signed number to print 
+//
+void TouchUserInterfaceForArduino::lcdPrintRightJustified(int n)
+{
+  char stringBuffer[UI_NUMBER_BUFFER_LENGTH];
+  
+  uiFormatInt(stringBuffer, n);
+  lcdPrintRightJustified(stringBuffer);
+}
+
+
+
+//
+// print a float on the LCD, right justify at the cursor, numbers too big to format
+// are printed as "ovf" the same as by lcdPrint()
+//  Enter:  n = signed number to print 
+//          digitsRightOfDecimal = number of digits to display right of decimal point (optional)
+//
+void TouchUserInterfaceForArduino::lcdPrintRightJustified(double n, int digitsRightOfDecimal)
+{
+  char stringBuffer[UI_NUMBER_BUFFER_LENGTH];
+
+  uiFormatFloat(stringBuffer, n, digitsRightOfDecimal);
+  lcdPrintRightJustified(stringBuffer);
+}
+
+
+
+//
+// print a string to the LCD, centered side-to-side at the cursor 
+//  Enter:  s -> string to print 
+//
+void TouchUserInterfaceForArduino::lcdPrintCentered(char *s)
+{
+  lcdPrintCentered(drawContext, s);
+}
+
+void TouchUserInterfaceForArduino::lcdPrintCentered(const char *s)
+{
+  lcdPrintCentered(drawContext, s);
+}
+
+
+
+//
+// print a string to the LCD, centered side-to-side at the cursor of a draw context
+//  Enter:  context = cursor, font and color to print with, the cursor is advanced
+//          s -> string to print 
+//
+void TouchUserInterfaceForArduino::lcdPrintCentered(DRAW_CONTEXT &context, const char *s)
+{
+  int stringWidth = lcdStringWidthInPixels(context, s);   // get the width of the string to print
+  int cursorX = context.cursorX - stringWidth/2;          // determine new X coord for cursor to center
+
+  if (cursorX < 0)                                        // set the new cursor position
+    cursorX = 0;
+  context.cursorX = cursorX;
+  
+  lcdPrint(context, s);                                   // print the string
+}
+
+
+
+//
+// print a signed int to the LCD, centered side-to-side at the cursor
+//  Enter:  n = signed number to print 
+//
+void TouchUserInterfaceForArduino::lcdPrintCentered(int n)
+{
+  char stringBuffer[UI_NUMBER_BUFFER_LENGTH];
+  
+  uiFormatInt(stringBuffer, n);
+  lcdPrintCentered(stringBuffer);
+}
+
+
+
+//
+// print a float to the LCD, centered side-to-side at the cursor, numbers too big 
+// to format are printed as "ovf" the same as by lcdPrint()
+//  Enter:  n = signed number to print 
+//          digitsRightOfDecimal = number of digits to display right of decimal point (optional)
+//
+void TouchUserInterfaceForArduino::lcdPrintCentered(double n, int digitsRightOfDecimal)
+{
+  char stringBuffer[UI_NUMBER_BUFFER_LENGTH];
+
+  uiFormatFloat(stringBuffer, n, digitsRightOfDecimal);
+  lcdPrintCentered(stringBuffer);
+}
+
+
+
+//
+// print one ASCII charater to the LCD, at location of the cursor
+//  Enter:  c = character to display
+//
+void TouchUserInterfaceForArduino::lcdPrintCharacter(byte c)
+{
+  lcdPrintCharacter(drawContext, c);
+}
+
+
+
+//
+// print one ASCII charater to the LCD, at the cursor of a draw context
+//  Enter:  context = cursor, font and color to print with, the cursor is advanced
+//          c = character to display
+//
+void TouchUserInterfaceForArduino::lcdPrintCharacter(DRAW_CONTEXT &context, byte c)
+{
+  PROFILE_FUNCTION(PROFILE_LCD_PRINT_CHARACTER);
+  LCD_BUSY_TIMER();
+  
+  //
+  // make sure char is in ASCII range
+  //
+  if ((c < 0x20) || (c > 0x7f))
+    return;
+
+  int extraSpaceBetweenChars = pgm_read_byte(&context.font[FONT_TABLE_PAD_AFTER_CHAR_IDX]);
+  int characterWidth = lcdCharacterWidth(context, c) - extraSpaceBetweenChars;
+  int characterHeight = pgm_read_byte(&context.font[FONT_TABLE_HEIGHT_IDX]);
+
+  //
+  // draw the character, or queue it for the render loop, unless it's clipped out
+  //
+  if (!isClippedOut(context.cursorX, context.cursorY, 
+    context.cursorX + characterWidth - 1, context.cursorY + characterHeight - 1))
+  {
+    LCD_BUS_LOCK();
+    if (renderQueue != NULL)
+      queueRenderCommand(RENDER_DRAW_CHARACTER, context.fontColor, context.font, context.cursorX, context.cursorY, c);
+    else
+      lcdDrawCharacterPixels(context.cursorX, context.cursorY, c, context.font, context.fontColor);
+  }
+
+  //
+  // advance the cursor past the character, stopping at the right edge of the LCD
+  //
+
+  if ((characterWidth > 0) && (context.cursorX + characterWidth >= lcdWidth))
+  {
+    if (context.cursorX < lcdWidth - 1)
+      context.cursorX = lcdWidth - 1;
+    return;
+  }
+
+  context.cursorX += characterWidth + extraSpaceBetweenChars;
+}
+
+
+
+//
+// draw the pixels of one ASCII charater, without moving the cursor
+//  Enter:  x, y = coords of the character's upper left corner
+//          c = character to display, 0x20 to 0x7f
+//          font -> the font typeface
+//          color = 16 bit color, bit format: rrrrrggggggbbbbb
+//
+void TouchUserInterfaceForArduino::lcdDrawCharacterPixels(int x, int y, byte c, const byte *font, uint16_t color)
+{
+  const byte *tablePntr;
+  uint16_t columnOfPixels;
+
+  //
+  // get a pointer to the pixel data in the font for the character
+  //
+  int characterHeight = pgm_read_byte(&font[FONT_TABLE_HEIGHT_IDX]);
+  int indexToCharacterIndex = FONT_TABLE_CHAR_LOOKUP_IDX + (((int)(c - 0x20)) << 1);
+  tablePntr = font + indexToCharacterIndex;
+  int indexToPixels = pgm_read_word(tablePntr);
+  tablePntr = font + indexToPixels;
+  
+  //
+  // determine the number of columns for the character
+  //
+  int characterWidth = pgm_read_byte(tablePntr++);
+
+  //
+  // loop through the font character collecting & writing each column of pixel data
+  //
+  for (int column = 0; column < characterWidth; column++)
+  {     
+    columnOfPixels = (uint16_t) pgm_read_word(tablePntr);
+    tablePntr += 2;
+
+    boolean foundTop = false;
+    int row = 0;
+    int rowTop = 0;
+    int colLength = 0;
+    while(row < characterHeight)
+    {      
+      if (columnOfPixels & 0x0001)
+      {
+        if (!foundTop)
+        {
+          foundTop = true;
+          rowTop = row;
+          colLength = 1;
+        }
+        else
+          colLength++;
+      }
+      else
+      {
+        if (foundTop)
+        {
+          lcd->drawFastVLine(x, y+rowTop, colLength, color);      
+          PROFILE_PIXELS(colLength);
+          foundTop = false;
+        }
+      }
+      columnOfPixels = columnOfPixels >> 1;
+      row++;
+    }
+
+    if (foundTop)
+    {
+      lcd->drawFastVLine(x, y+rowTop, colLength, color);
+      PROFILE_PIXELS(colLength);
+    }
+ 
+    //
+    // advance to next column of pixels, make sure that we haven't gone too far to the left
+    // 
+    if (x >= lcdWidth - 1)
+      return;
+    x++;
+  }
+}
+
+
+
+////
+//// print one ASCII charater to the LCD, at location of the cursor
+////  Enter:  c = character to display
+////
+//void TouchUserInterfaceForArduino::lcdPrintCharacter(byte c)
+//{
 //  const byte *tablePntr;
 //  uint16_t columnOfPixels;
 //  
@@ -4320,616 +6803,1828 @@ void TouchUserInterfaceForArduino::lcdPrintCharacter(byte c)
 //  if ((c < 0x20) || (c > 0x7f))
 //    return;
 //
-//  //
-//  // get info about the font
-//  //
-//  int characterHeight = pgm_read_byte(&currentFont[FONT_TABLE_HEIGHT_IDX]);
-//  int extraSpaceBetweenChars = pgm_read_byte(&currentFont[FONT_TABLE_PAD_AFTER_CHAR_IDX]);
-//  
+//  //
+//  // get info about the font
+//  //
+//  int characterHeight = pgm_read_byte(&currentFont[FONT_TABLE_HEIGHT_IDX]);
+//  int extraSpaceBetweenChars = pgm_read_byte(&currentFont[FONT_TABLE_PAD_AFTER_CHAR_IDX]);
+//  
+//
+//  //
+//  // get a pointer to the pixel data in the font for the character
+//  //
+//  int indexToCharacterIndex = FONT_TABLE_CHAR_LOOKUP_IDX + (((int)(c - 0x20)) << 1);
+//  tablePntr = currentFont + indexToCharacterIndex;
+//  int indexToPixels = pgm_read_word(tablePntr);
+//  tablePntr = currentFont + indexToPixels;
+//  
+//  //
+//  // determine the number of columns for the character
+//  //
+//  int characterWidth = pgm_read_byte(tablePntr++);
+//
+//  //
+//  // loop through the font character collecting & writing each column of pixel data
+//  //
+//  for (int column = 0; column < characterWidth; column++)
+//  {     
+//    columnOfPixels = (uint16_t) pgm_read_word(tablePntr);
+//    tablePntr += 2;
+//  
+//      for (int row = 0; row < characterHeight; row++)
+//      {
+//        if (columnOfPixels & 0x0001)
+//          lcd->drawPixel(textCursorX, textCursorY+row, fontColor);
+//        columnOfPixels = columnOfPixels >> 1;
+//      }
+//
+// 
+//    //
+//    // advance to next column of pixels, make sure that we haven't gone too far to the left
+//    // 
+//    if (textCursorX >= lcdWidth - 1)
+//      return;
+//    textCursorX++;
+//  }
+//
+//  textCursorX += extraSpaceBetweenChars;
+//}
+
+
+
+//
+// get the width of a string in pixels
+//
+int TouchUserInterfaceForArduino::lcdStringWidthInPixels(char *s)
+{
+  return(lcdStringWidthInPixels(drawContext, s));
+}
+
+int TouchUserInterfaceForArduino::lcdStringWidthInPixels(const char *s)
+{
+  return(lcdStringWidthInPixels(drawContext, s));
+}
+
+
+
+//
+// get the width of a string in pixels, in the font of a draw context
+//
+int TouchUserInterfaceForArduino::lcdStringWidthInPixels(DRAW_CONTEXT &context, const char *s)
+{
+  int stringWidthInPixels = 0;
+  int index = 0;
+  char c;
+
+  while(true)
+  {
+    c = s[index++];
+    if (c == 0)
+      return(stringWidthInPixels);
+    stringWidthInPixels += lcdCharacterWidth(context, c);
+  }
+}
+
+
+
+//
+// get the width of a character from the selected font
+//  Enter:  c = character to measure
+//  Exit:   character's width in pixels
+//
+int TouchUserInterfaceForArduino::lcdCharacterWidth(byte c)
+{
+  return(lcdCharacterWidth(drawContext, c));
+}
+
+
+
+//
+// get the width of a character from the font of a draw context
+//  Enter:  context = the draw context, only its font is used
+//          c = character to measure
+//  Exit:   character's width in pixels, 0 for one that's not printed (not in the
+//            ASCII range)
+//
+int TouchUserInterfaceForArduino::lcdCharacterWidth(DRAW_CONTEXT &context, byte c)
+{
+  //
+  // the font only has the printable characters, the others aren't printed
+  //
+  if ((c < 0x20) || (c > 0x7f))
+    return(0);
+
+  //
+  // get a pointer to the pixel data in the font for the character
+  //
+  int indexToCharacterIndex = FONT_TABLE_CHAR_LOOKUP_IDX + (((int)(c - 0x20)) << 1);
+  const byte *tablePntr = context.font + indexToCharacterIndex;
+  int indexToPixels = pgm_read_word(tablePntr);
+  tablePntr = context.font + indexToPixels;
+  
+  //
+  // determine the number of columns for the character
+  //
+  byte characterWidth = pgm_read_byte(tablePntr) + pgm_read_byte(context.font + FONT_TABLE_PAD_AFTER_CHAR_IDX);
+  return(characterWidth);
+}
+
+
+
+//
+// get the height of the selected font in pixels, including decenders
+//
+int TouchUserInterfaceForArduino::lcdGetFontHeightWithDecenders(void)
+{
+  return(pgm_read_byte(&drawContext.font[FONT_TABLE_HEIGHT_IDX]));
+}
+
+
+
+//
+// get the height of the selected font in pixels, excluding decenders
+//
+int TouchUserInterfaceForArduino::lcdGetFontHeightWithoutDecenders(void)
+{
+  return(pgm_read_byte(&drawContext.font[FONT_TABLE_HEIGHT_IDX]) -  pgm_read_byte(&drawContext.font[FONT_TABLE_DECENDERS_HEIGHT_IDX]));
+}
+
+
+
+//
+// get the height of the selected font in pixels, including decenders & line spacing
+//
+int TouchUserInterfaceForArduino::lcdGetFontHeightWithDecentersAndLineSpacing(void)
+{
+  return(pgm_read_byte(&drawContext.font[FONT_TABLE_LINE_SPACING_IDX]));
+}
+
+
+
+//
+// set the cursor coords in pixels
+//  Enter:  x  0 = left most pixel
+//          y  0 = left most pixel
+//
+void TouchUserInterfaceForArduino::lcdSetCursorXY(int x, int y)
+{
+  if ((x < 0) || (x >= lcdWidth)) return;
+  if ((y < 0) || (y >= lcdHeight)) return;
+  
+  drawContext.cursorX = x;
+  drawContext.cursorY = y;
+}
+
+
+
+//
+// get the cursor coords in pixels
+//  Enter:  x -> storage to return X,  0 = left most pixel
+//          y -> storage to return Y,  0 = left most pixel
+//
+void TouchUserInterfaceForArduino::lcdGetCursorXY(int *x, int *y)
+{
+  *x = drawContext.cursorX;
+  *y = drawContext.cursorY;
+}
+
+
+
+//
+// make a RGB565 color
+//  Enter:  red (0 to 31)
+//          green (0 to 63) Note: green value 0x20 has same intensity as blue value 0x10
+//          blue (0 to 31)
+//  Exit:   16 bit color returned, bit format: rrrrrggggggbbbbb
+//
+uint16_t TouchUserInterfaceForArduino::lcdMakeColor(int red, int green, int blue)
+{
+  return((red << 11) + (green << 5) + (blue));
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                 Profiler functions
+// ---------------------------------------------------------------------------------
+
+//
+// The draw-call profiler counts the calls, pixels drawn and time spent in each LCD 
+// primitive, getTouchEvents(), and the functions that draw and check widgets.  It's 
+// only built in when TOUCH_UI_PROFILER is defined (see TouchUserInterfaceForArduino.h).
+// Without it these functions do nothing, and the counting compiles to nothing.
+//
+// A widget's pixels and time include the primitives it calls, so they add up to more
+// than the total.  To profile each frame, call resetProfileStats() after 
+// getTouchEvents() at the top of the loop, then getProfileStats() before the next 
+// call to getTouchEvents().
+//
+
+#ifdef TOUCH_UI_PROFILER
+const char *const profileCounterNames[PROFILE_COUNTER_COUNT] = {
+  "lcdClearScreen", "lcdDrawPixel", "lcdDrawLine", "lcdDrawHorizontalLine", 
+  "lcdDrawVerticalLine", "lcdDrawRectangle", "lcdDrawRoundedRectangle", "lcdDrawTriangle",
+  "lcdDrawCircle", "lcdDrawFilledRectangle", "lcdDrawFilledRoundedRectangle", 
+  "lcdDrawFilledTriangle", "lcdDrawFilledCircle", "lcdDrawImage", "lcdPrintCharacter", 
+  "getTouchEvents", "drawMenu", "drawTitleBar", "clearDisplaySpace", "drawButton", 
+  "drawImageButton", "drawNumberBox", "drawSelectionBox", "drawSlider", 
+  "checkForTitleBarButton", "checkForButton", "checkForImageButton", 
+  "checkForNumberBox", "checkForSelectionBox", "checkForSlider"};
+#endif
+
+
+
+//
+// get the draw-call profiler's counters, since it was last reset
+//  Enter:  stats = storage to return the statistics (all 0 if the profiler isn't built in)
+//
+void TouchUserInterfaceForArduino::getProfileStats(PROFILE_STATS &stats)
+{
+  memset(&stats, 0, sizeof(stats));
+
+  #ifdef TOUCH_UI_PROFILER
+    stats.elapsedMicros = micros() - profileResetTime;
+    memcpy(stats.counters, profileCounters, sizeof(stats.counters));
+  #endif
+}
+
+
+
+//
+// set the draw-call profiler's counters back to 0
+//
+void TouchUserInterfaceForArduino::resetProfileStats(void)
+{
+  #ifdef TOUCH_UI_PROFILER
+    memset(profileCounters, 0, sizeof(profileCounters));
+    profileResetTime = micros();
+  #endif
+}
+
+
+
+//
+// print the draw-call profiler's counters, one line for each function that was called
+//  Enter:  port = where to print, ie: Serial
+//
+void TouchUserInterfaceForArduino::printProfileStats(Print &port)
+{
+  #ifdef TOUCH_UI_PROFILER
+    PROFILE_STATS stats;
+    getProfileStats(stats);
+
+    port.print("Profile of ");
+    port.print(stats.elapsedMicros);
+    port.println(" us: function, calls, pixels, us");
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; i++)
+    {
+      if (stats.counters[i].calls == 0)
+        continue;
+      port.print(profileCounterNames[i]);
+      port.print(", ");
+      port.print(stats.counters[i].calls);
+      port.print(", ");
+      port.print(stats.counters[i].pixels);
+      port.print(", ");
+      port.println(stats.counters[i].micros);
+    }
+  #else
+    port.println("Profiler not built in, define TOUCH_UI_PROFILER");
+  #endif
+}
+
+
+// ---------------------------------------------------------------------------------
+//                           Performance overlay functions
+// ---------------------------------------------------------------------------------
+
+//
+// The performance overlay shows how well the UI is keeping up, in the right corner
+// of the title bar, so problems can be seen on a unit without a debugger:
+//    lps     - loops per second, the number of times getTouchEvents() is called
+//    ms      - the worst latency, the longest time from getTouchEvents() reporting a
+//              touch event until it's called again (after the screen has been redrawn)
+//    % lcd   - the percentage of the time spent in the LCD functions, sending to the 
+//              display over SPI
+//
+// It's updated once a second from getTouchEvents().  Only values that have changed 
+// are redrawn, and the time spent drawing them isn't counted.
+//
+
+const unsigned long PERFORMANCE_OVERLAY_UPDATE_PERIOD = 1000;
+const int PERFORMANCE_OVERLAY_LOOPS = 0;
+const int PERFORMANCE_OVERLAY_LATENCY = 1;
+const int PERFORMANCE_OVERLAY_LCD_BUSY = 2;
+
+
+
+//
+// show the performance overlay on the title bar
+//  Enter:  font -> font for the overlay, a small one such as UI_Font_9
+//
+void TouchUserInterfaceForArduino::showPerformanceOverlay(const byte *font)
+{
+  performanceOverlayFont = font;
+  performanceOverlayLoopCount = 0;
+  performanceOverlayWorstLatency = 0;
+  lcdBusyMicros = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    performanceOverlayValues[i] = -1;
+    performanceOverlayShownValues[i] = -1;
+  }
+
+  performanceOverlayPeriodStartTime = micros();
+  performanceOverlayLastCallTime = performanceOverlayPeriodStartTime;
+  lcdBusyTimingFlg = true;
+}
+
+
+
+//
+// stop showing the performance overlay, it's removed the next time the title bar is
+// drawn
+//
+void TouchUserInterfaceForArduino::hidePerformanceOverlay(void)
+{
+  performanceOverlayFont = NULL;
+  lcdBusyTimingFlg = false;
+}
+
+
+
+//
+// measure the UI's performance, this is called at the top of getTouchEvents() while
+// the overlay is shown.  Once each update period the values are computed and drawn.
 //
-//  //
-//  // get a pointer to the pixel data in the font for the character
-//  //
-//  int indexToCharacterIndex = FONT_TABLE_CHAR_LOOKUP_IDX + (((int)(c - 0x20)) << 1);
-//  tablePntr = currentFont + indexToCharacterIndex;
-//  int indexToPixels = pgm_read_word(tablePntr);
-//  tablePntr = currentFont + indexToPixels;
-//  
-//  //
-//  // determine the number of columns for the character
-//  //
-//  int characterWidth = pgm_read_byte(tablePntr++);
+void TouchUserInterfaceForArduino::updatePerformanceOverlay(void)
+{
+  unsigned long currentTime = micros();
+
+  //
+  // count the loop, and if the last call reported an event, how long it took to 
+  // get back here
+  //
+  performanceOverlayLoopCount++;
+  if (touchEventType != TOUCH_NO_EVENT)
+  {
+    unsigned long latency = currentTime - performanceOverlayLastCallTime;
+    if (latency > performanceOverlayWorstLatency)
+      performanceOverlayWorstLatency = latency;
+  }
+  performanceOverlayLastCallTime = currentTime;
+
+  //
+  // check if time to update the values
+  //
+  unsigned long periodMicros = currentTime - performanceOverlayPeriodStartTime;
+  if (periodMicros < PERFORMANCE_OVERLAY_UPDATE_PERIOD * 1000UL)
+    return;
+
+  performanceOverlayValues[PERFORMANCE_OVERLAY_LOOPS] = 
+    min((long) ((performanceOverlayLoopCount * 1000000.0) / periodMicros), 9999L);
+  performanceOverlayValues[PERFORMANCE_OVERLAY_LATENCY] = 
+    min((long) ((performanceOverlayWorstLatency + 500) / 1000), 999L);
+  performanceOverlayValues[PERFORMANCE_OVERLAY_LCD_BUSY] = 
+    min((long) ((lcdBusyMicros * 100.0) / periodMicros), 100L);
+
+  drawPerformanceOverlay(false);
+
+  //
+  // start the next period after drawing, so the drawing isn't measured
+  //
+  performanceOverlayLoopCount = 0;
+  performanceOverlayWorstLatency = 0;
+  lcdBusyMicros = 0;
+  performanceOverlayPeriodStartTime = micros();
+  performanceOverlayLastCallTime = performanceOverlayPeriodStartTime;
+}
+
+
+
+//
+// draw the performance overlay's values in the right corner of the title bar
+//  Enter:  redrawAllFlg = true to draw all the values, false to only draw those
+//            that have changed
+//
+void TouchUserInterfaceForArduino::drawPerformanceOverlay(boolean redrawAllFlg)
+{
+  //
+  // save the text settings, the app may be in the middle of printing
+  //
+  DRAW_CONTEXT savedDrawContext = drawContext;
+  lcdBusyTimingFlg = false;
+
+  lcdSetFont(performanceOverlayFont);
+  lcdSetFontColor(titleBarTextColor);
+  int lineHeight = lcdGetFontHeightWithDecenders();
+  int rightX = lcdWidth - 4;
+  int topLineY = max(titleBarHeight/2 - lineHeight - 1, 0);
+  int bottomLineY = titleBarHeight/2 + 1;
+  int latencyRightX = rightX - lcdStringWidthInPixels("100% lcd") - 6;
+
+  drawPerformanceOverlayValue(PERFORMANCE_OVERLAY_LOOPS, " lps", "9999 lps", rightX, topLineY, redrawAllFlg);
+  drawPerformanceOverlayValue(PERFORMANCE_OVERLAY_LATENCY, " ms", "999 ms", latencyRightX, bottomLineY, redrawAllFlg);
+  drawPerformanceOverlayValue(PERFORMANCE_OVERLAY_LCD_BUSY, "% lcd", "100% lcd", rightX, bottomLineY, redrawAllFlg);
+
+  drawContext = savedDrawContext;
+  lcdBusyTimingFlg = true;
+}
+
+
+
+//
+// draw one of the performance overlay's values, right justified in a box just wide
+// enough for its largest value
+//  Enter:  valueIdx = PERFORMANCE_OVERLAY_LOOPS, _LATENCY or _LCD_BUSY
+//          units -> text printed after the value
+//          widestText -> the value's widest text, setting the size of its box
+//          rightX, topY = coords of the box's upper right corner
+//          redrawAllFlg = true to draw the value even if it hasn't changed
+//
+void TouchUserInterfaceForArduino::drawPerformanceOverlayValue(int valueIdx, const char *units, 
+  const char *widestText, int rightX, int topY, boolean redrawAllFlg)
+{
+  int value = performanceOverlayValues[valueIdx];
+  if (!redrawAllFlg && (value == performanceOverlayShownValues[valueIdx]))
+    return;
+  performanceOverlayShownValues[valueIdx] = value;
+
+  //
+  // the units are one of the short strings above, ie: "% lcd"
+  //
+  char text[UI_NUMBER_BUFFER_LENGTH + 8];
+  if (value < 0)
+    strcpy(text, "--");
+  else
+    uiFormatInt(text, value);
+  strcat(text, units);
+
+  int boxWidth = lcdStringWidthInPixels(widestText);
+  lcdDrawFilledRectangle(rightX - boxWidth, topY, boxWidth, lcdGetFontHeightWithDecenders(), titleBarColor);
+  lcdSetCursorXY(rightX, topY);
+  lcdPrintRightJustified(text);
+}
+
+
+// ---------------------------------------------------------------------------------
+//                                 Tracing functions
+// ---------------------------------------------------------------------------------
+
+//
+// A trace records when UI operations begin and end (drawing menus and widgets, 
+// sampling the touch screen, saving configuration values, menu commands and 
+// callbacks, and the numeric keypad) with their times in microseconds.  Events go 
+// into a ring buffer supplied by the app; when it's full the oldest are replaced.  
+// The app can add its own operations with traceBegin() and traceEnd().
+//
+// printTrace() prints the buffer, extras/host/trace_to_chrome.py converts what's
+// printed to a JSON file for Chrome's about:tracing (or ui.perfetto.dev), showing 
+// the operations on a timeline.  Hitches show as long operations or gaps.
+//
+
+const char *const traceNames[TRACE_ID_COUNT] = {
+  "drawMenu", "drawTitleBar", "clearDisplaySpace", "drawButton", "drawImageButton",
+  "drawNumberBox", "drawSelectionBox", "drawSlider", "touchSample", 
+  "configurationCommit", "menuCommand", "menuCallback", "numericKeyPad"};
+
+
+
+//
+// start tracing, any events already in the buffer are discarded
+//  Enter:  eventBuffer -> storage for the events
+//          bufferSize = number of events the buffer holds
+//
+void TouchUserInterfaceForArduino::startTrace(TRACE_EVENT *eventBuffer, int bufferSize)
+{
+  if (bufferSize <= 0)
+    return;
+
+  traceEvents = eventBuffer;
+  traceBufferSize = bufferSize;
+  traceNextIdx = 0;
+  traceEventCount = 0;
+  traceRunningFlg = true;
+}
+
+
+
+//
+// stop tracing, the events stay in the buffer to be printed
+//
+void TouchUserInterfaceForArduino::stopTrace(void)
+{
+  traceRunningFlg = false;
+}
+
+
+
+//
+// add the beginning of one of the app's operations to the trace
+//  Enter:  traceId = TRACE_USER + n, n being 0 to 223
+//
+void TouchUserInterfaceForArduino::traceBegin(byte traceId)
+{
+  addTraceEvent(traceId, TRACE_EVENT_BEGIN);
+}
+
+
+
+//
+// add the end of one of the app's operations to the trace
+//  Enter:  traceId = the value given to traceBegin()
+//
+void TouchUserInterfaceForArduino::traceEnd(byte traceId)
+{
+  addTraceEvent(traceId, TRACE_EVENT_END);
+}
+
+
+
+//
+// print the events in the trace buffer, oldest first, for trace_to_chrome.py.  
+// Tracing is paused while printing.
+//  Enter:  port = where to print, ie: Serial
+//
+void TouchUserInterfaceForArduino::printTrace(Print &port)
+{
+  if (traceEvents == NULL)
+    return;
+
+  boolean savedRunningFlg = traceRunningFlg;
+  traceRunningFlg = false;
+
+  int count = (traceEventCount < traceBufferSize) ? (int) traceEventCount : traceBufferSize;
+  int idx = (traceEventCount < traceBufferSize) ? 0 : traceNextIdx;
+
+  port.print("TRACE START ");
+  port.println(traceEventCount);
+  for (int i = 0; i < count; i++)
+  {
+    TRACE_EVENT &event = traceEvents[idx];
+    port.print(event.time);
+    port.print(event.eventType == TRACE_EVENT_BEGIN ? " B " : " E ");
+    if (event.traceId < TRACE_ID_COUNT)
+      port.println(traceNames[event.traceId]);
+    else
+    {
+      port.print("user");
+      port.println((int) (event.traceId - TRACE_USER));
+    }
+
+    idx++;
+    if (idx >= traceBufferSize)
+      idx = 0;
+  }
+  port.println("TRACE END");
+
+  traceRunningFlg = savedRunningFlg;
+}
+
+
+// ---------------------------------------------------------------------------------
+//                             Stack measuring functions
+// ---------------------------------------------------------------------------------
+
+//
+// To find how much stack the UI needs, startStackMeasurement() "paints" the unused
+// stack below it with a pattern.  Stack that's been used no longer has the pattern, 
+// so the deepest byte without it is the high-water mark.  Depths are measured from
+// where startStackMeasurement() was called, and the stack is assumed to grow down
+// (as it does on ARM, ESP32 and RISC-V processors).
+//
+// The operations that are traced (see Tracing functions above) also record the 
+// deepest the stack was when they started, and if the high-water mark moved while 
+// they ran, how deep it went.  These show which path needs the most stack, ie: a 
+// menu command calling the numeric keypad.
+//
+// Measuring slows drawing, each operation searches the painted stack for the 
+// high-water mark.
+//
+
+const int STACK_PAINT_GAP = 256;
+
+
+
+//
+// paint the stack below this function's frame with the pattern, interrupts are off
+// so an ISR's frame isn't painted over
+//  Enter:  paintBytes = number of bytes to paint
+//
+static void __attribute__((noinline)) paintStack(int paintBytes)
+{
+  volatile byte marker = 0;
+  volatile byte *p = &marker - STACK_PAINT_GAP;
+
+  noInterrupts();
+  for (int i = 0; i < paintBytes; i++)
+    *--p = STACK_PAINT_PATTERN;
+  interrupts();
+
+  stackPaintBottom = p;
+  stackHighWaterMark = p + paintBytes;
+}
+
+
+
+//
+// start measuring how deep the stack goes, call this from setup() or the top of 
+// loop(), before the UI is used
+//  Enter:  paintBytes = bytes of stack to paint, this MUST be less than the free 
+//            stack below the caller (ie: less than the RTOS task's stack size)
+//
+void TouchUserInterfaceForArduino::startStackMeasurement(int paintBytes)
+{
+  volatile byte marker = 0;
+  stackReference = (byte *) &marker;
+
+  paintStack(paintBytes);
+
+  for (int i = 0; i < TRACE_ID_COUNT; i++)
+  {
+    stackEntryDepths[i] = 0;
+    stackHighWaterDepths[i] = 0;
+  }
+  stackMeasuringFlg = true;
+}
+
+
+
+//
+// get the deepest the stack has gone since startStackMeasurement() was called
+//  Exit:   bytes of stack used below where startStackMeasurement() was called, if 
+//            this is at least the painted depth the stack may have gone deeper
+//
+int TouchUserInterfaceForArduino::getStackHighWater(void)
+{
+  if (!stackMeasuringFlg)
+    return(0);
+
+  updateStackHighWater();
+  return(stackReference - (byte *) stackHighWaterMark);
+}
+
+
+
+//
+// print the stack high-water mark, and for each operation that has run the deepest
+// the stack was when it started and the high-water mark it reached
+//  Enter:  port = where to print, ie: Serial
+//
+void TouchUserInterfaceForArduino::printStackReport(Print &port)
+{
+  if (!stackMeasuringFlg)
+    return;
+
+  int painted = stackReference - (byte *) stackPaintBottom;
+  int highWater = getStackHighWater();
+
+  port.print("Stack high-water ");
+  port.print(highWater);
+  port.print(" bytes of ");
+  port.print(painted);
+  port.println(highWater >= painted ? " painted, OVERFLOWED the painted stack" : " painted");
+  port.println("operation, depth at start, high-water reached in it");
+  for (int i = 0; i < TRACE_ID_COUNT; i++)
+  {
+    if (stackEntryDepths[i] == 0)
+      continue;
+    port.print(traceNames[i]);
+    port.print(", ");
+    port.print(stackEntryDepths[i]);
+    port.print(", ");
+    if (stackHighWaterDepths[i] == 0)
+      port.println("-");
+    else
+      port.println(stackHighWaterDepths[i]);
+  }
+}
+
+
+// ---------------------------------------------------------------------------------
+//                              Render queue functions
+// ---------------------------------------------------------------------------------
+
+//
+// Drawing on an SPI display is slow, redrawing a screen can take tens of 
+// milliseconds.  On a processor with two cores, the render queue moves that time
+// off the app's core: while it's running, the LCD functions (and so the widgets 
+// that draw with them) only add a small command to the queue, then a render loop on
+// the other core draws the commands.  There is one producer (the app's core) and
+// one consumer (the render loop), so the queue needs no locks.
+//
+// On the RP2040, call renderQueuedCommands() from loop1(), which runs on core 1:
+//      void loop1() { ui.renderQueuedCommands(); }
+// On the ESP32, startRenderTask() starts a task pinned to the other core.
+//
+// If the queue fills, drawing waits for the render loop to catch up.  The touch 
+// screen is on the same SPI bus, so reading it waits for the command being drawn.
+//
+
+
+
+//
+// start queuing drawing for the render loop
+//  Enter:  commandBuffer -> buffer for the queue (about 20 bytes per command), it 
+//            must stay allocated while the queue is running
+//          bufferSize = number of commands in the buffer, ie: 256
+//
+void TouchUserInterfaceForArduino::startRenderQueue(RENDER_COMMAND *commandBuffer, int bufferSize)
+{
+  stopRenderQueue();
+
+  renderQueueSize = bufferSize;
+  renderQueueHead = 0;
+  renderQueueTail = 0;
+  __sync_synchronize();
+  renderQueue = commandBuffer;
+}
+
+
+
+//
+// stop queuing, once the render loop has drawn what's queued the LCD functions 
+// draw directly again
+//
+void TouchUserInterfaceForArduino::stopRenderQueue(void)
+{
+  waitForRenderQueue();
+  renderQueue = NULL;
+  __sync_synchronize();
+}
+
+
+
+//
+// draw the commands in the render queue, this is the render loop, call it over and
+// over from the other core
+//  Exit:   true returned if anything was drawn, false if the queue was empty
+//
+boolean TouchUserInterfaceForArduino::renderQueuedCommands(void)
+{
+  RENDER_COMMAND *queue = renderQueue;
+  if ((queue == NULL) || (renderQueueTail == renderQueueHead))
+    return(false);
+
+  while (renderQueueTail != renderQueueHead)
+  {
+    __sync_synchronize();
+    const RENDER_COMMAND &command = queue[renderQueueTail];
+    const int16_t *a = command.args;
+
+    lockSPIBus(SPI_BUS_RENDER);
+    switch(command.opcode)
+    {
+      case RENDER_CLEAR_SCREEN:
+        lcd->fillScreen(command.color);
+        break;
+      case RENDER_DRAW_PIXEL:
+        lcd->drawPixel(a[0], a[1], command.color);
+        break;
+      case RENDER_DRAW_LINE:
+        lcd->drawLine(a[0], a[1], a[2], a[3], command.color);
+        break;
+      case RENDER_DRAW_HORIZONTAL_LINE:
+        lcd->drawFastHLine(a[0], a[1], a[2], command.color);
+        break;
+      case RENDER_DRAW_VERTICAL_LINE:
+        lcd->drawFastVLine(a[0], a[1], a[2], command.color);
+        break;
+      case RENDER_DRAW_RECTANGLE:
+        lcd->drawRect(a[0], a[1], a[2], a[3], command.color);
+        break;
+      case RENDER_DRAW_ROUNDED_RECTANGLE:
+        lcd->drawRoundRect(a[0], a[1], a[2], a[3], a[4], command.color);
+        break;
+      case RENDER_DRAW_TRIANGLE:
+        lcd->drawTriangle(a[0], a[1], a[2], a[3], a[4], a[5], command.color);
+        break;
+      case RENDER_DRAW_CIRCLE:
+        lcd->drawCircle(a[0], a[1], a[2], command.color);
+        break;
+      case RENDER_DRAW_FILLED_RECTANGLE:
+        lcd->fillRect(a[0], a[1], a[2], a[3], command.color);
+        break;
+      case RENDER_DRAW_FILLED_ROUNDED_RECTANGLE:
+        lcdDrawFilledRoundedRectanglePixels(a[0], a[1], a[2], a[3], a[4], command.color);
+        break;
+      case RENDER_DRAW_FILLED_TRIANGLE:
+        lcdDrawFilledTrianglePixels(a[0], a[1], a[2], a[3], a[4], a[5], command.color);
+        break;
+      case RENDER_DRAW_FILLED_CIRCLE:
+        lcdDrawFilledCirclePixels(a[0], a[1], a[2], command.color);
+        break;
+      case RENDER_DRAW_IMAGE:
+        lcd->drawRGBBitmap(a[0], a[1], (const uint16_t *) command.pntr, a[2], a[3]);
+        break;
+      case RENDER_DRAW_CHARACTER:
+        lcdDrawCharacterPixels(a[0], a[1], a[2], (const byte *) command.pntr, command.color);
+        break;
+      case RENDER_SET_CLIP:
+        drawClip.leftX = a[0];
+        drawClip.topY = a[1];
+        drawClip.rightX = a[2];
+        drawClip.bottomY = a[3];
+        break;
+    }
+    unlockSPIBus(SPI_BUS_RENDER);
+
+    int nextTail = renderQueueTail + 1;
+    if (nextTail >= renderQueueSize)
+      nextTail = 0;
+    __sync_synchronize();
+    renderQueueTail = nextTail;
+  }
+  return(true);
+}
+
+
+
+//
+// wait until the render loop has drawn everything queued, ie: before reading the
+// LCD or changing its orientation
+//
+void TouchUserInterfaceForArduino::waitForRenderQueue(void)
+{
+  if (renderQueue == NULL)
+    return;
+
+  while (renderQueueTail != renderQueueHead)
+    yield();
+}
+
+
+
+#if defined(ARDUINO_ARCH_ESP32)
+//
+// the ESP32's render loop, one task draws for every display that's started it (the
+// SPI bus lock has one render side).  It sleeps a tick when there's nothing to draw
+// so the idle task on its core can run.
+//
+const int MAX_RENDER_TASK_DISPLAYS = 4;
+
+static TouchUserInterfaceForArduino *volatile renderTaskDisplays[MAX_RENDER_TASK_DISPLAYS];
+static volatile int renderTaskDisplayCount = 0;
+
+static void renderTask(void *parameter)
+{
+  while(true)
+  {
+    boolean drewFlg = false;
+    for (int i = 0; i < renderTaskDisplayCount; i++)
+    {
+      if (renderTaskDisplays[i]->renderQueuedCommands())
+        drewFlg = true;
+    }
+
+    if (!drewFlg)
+      vTaskDelay(1);
+  }
+}
+
+
+
+//
+// start queuing drawing, with the render loop in a task on the other core
+//  Enter:  commandBuffer -> buffer for the queue, it must stay allocated
+//          bufferSize = number of commands in the buffer, ie: 256
+//          core = core to draw on, the Arduino loop() runs on core 1 so use 0, the 
+//            task is shared by all displays so only the first call's core is used
+//
+void TouchUserInterfaceForArduino::startRenderTask(RENDER_COMMAND *commandBuffer, int bufferSize, int core)
+{
+  static TaskHandle_t renderTaskHandle = NULL;
+
+  startRenderQueue(commandBuffer, bufferSize);
+
+  //
+  // add this display to the ones the task draws for
+  //
+  boolean foundFlg = false;
+  for (int i = 0; i < renderTaskDisplayCount; i++)
+  {
+    if (renderTaskDisplays[i] == this)
+      foundFlg = true;
+  }
+  if (!foundFlg && (renderTaskDisplayCount < MAX_RENDER_TASK_DISPLAYS))
+  {
+    renderTaskDisplays[renderTaskDisplayCount] = this;
+    __sync_synchronize();
+    renderTaskDisplayCount++;
+  }
+
+  if (renderTaskHandle == NULL)
+    xTaskCreatePinnedToCore(renderTask, "renderTask", 4096, NULL, 1, &renderTaskHandle, core);
+}
+#endif
+
+
+// ---------------------------------------------------------------------------------
+//                           Thread safe drawing functions
+// ---------------------------------------------------------------------------------
+
 //
-//  //
-//  // loop through the font character collecting & writing each column of pixel data
-//  //
-//  for (int column = 0; column < characterWidth; column++)
-//  {     
-//    columnOfPixels = (uint16_t) pgm_read_word(tablePntr);
-//    tablePntr += 2;
-//  
-//      for (int row = 0; row < characterHeight; row++)
-//      {
-//        if (columnOfPixels & 0x0001)
-//          lcd->drawPixel(textCursorX, textCursorY+row, fontColor);
-//        columnOfPixels = columnOfPixels >> 1;
-//      }
+// With an RTOS, tasks other than the UI's can draw, ie: to update a status value.
+// Two things make this safe:
 //
-// 
-//    //
-//    // advance to next column of pixels, make sure that we haven't gone too far to the left
-//    // 
-//    if (textCursorX >= lcdWidth - 1)
-//      return;
-//    textCursorX++;
-//  }
+// The print functions that take a DRAW_CONTEXT use its cursor, font and color 
+// rather than the ones shared by the UI, so each task keeps its own.
+//
+// The LCD and touch screen drivers aren't reentrant, so each LCD function, each
+// character printed and each touch screen read holds a bus lock while talking to 
+// them.  The lock is only held for the transfer, tasks don't wait on each other's 
+// string formatting or layout.
+//
+// The menus, widgets and touch events still belong to one task, the UI's task.
 //
-//  textCursorX += extraSpaceBetweenChars;
-//}
 
 
 
 //
-// get the width of a string in pixels
+// set the functions that lock and unlock the SPI bus, for drawing from more than 
+// one task
+//  Enter:  lockFunction -> function that waits for and takes the lock, ie: one 
+//            calling xSemaphoreTakeRecursive()
+//          unlockFunction -> function that gives the lock back
 //
-int TouchUserInterfaceForArduino::lcdStringWidthInPixels(char *s)
+void TouchUserInterfaceForArduino::setBusLockFunctions(void (*lockFunction)(void), void (*unlockFunction)(void))
 {
-  int stringWidthInPixels = 0;
-  int index = 0;
-  char c;
+  busUnlockFunction = NULL;
+  __sync_synchronize();
+  busLockFunction = lockFunction;
+  __sync_synchronize();
+  busUnlockFunction = unlockFunction;
+}
 
-  while(true)
-  {
-    c = s[index++];
-    if (c == 0)
-      return(stringWidthInPixels);
-    stringWidthInPixels += lcdCharacterWidth(c);
-  }
+
+
+#if defined(ARDUINO_ARCH_ESP32)
+//
+// the ESP32's bus lock, a FreeRTOS recursive mutex
+//
+static SemaphoreHandle_t busMutex = NULL;
+
+static void lockBusMutex(void)
+{
+  xSemaphoreTakeRecursive(busMutex, portMAX_DELAY);
 }
 
-int TouchUserInterfaceForArduino::lcdStringWidthInPixels(const char *s)
+static void unlockBusMutex(void)
 {
-  return(lcdStringWidthInPixels((char*)s));
+  xSemaphoreGiveRecursive(busMutex);
 }
 
 
 
 //
-// get the width of a character from the selected font
-//  Enter:  c = character to measure
-//  Exit:   character's width in pixels
+// make drawing safe from more than one FreeRTOS task, call this from setup() 
+// after ui.begin() and before starting the other tasks
 //
-int TouchUserInterfaceForArduino::lcdCharacterWidth(byte c)
+void TouchUserInterfaceForArduino::enableThreadSafeDrawing(void)
 {
-  //
-  // get a pointer to the pixel data in the font for the character
-  //
-  int indexToCharacterIndex = FONT_TABLE_CHAR_LOOKUP_IDX + (((int)(c - 0x20)) << 1);
-  const byte *tablePntr = currentFont + indexToCharacterIndex;
-  int indexToPixels = pgm_read_word(tablePntr);
-  tablePntr = currentFont + indexToPixels;
+  if (busMutex == NULL)
+    busMutex = xSemaphoreCreateRecursiveMutex();
+  setBusLockFunctions(lockBusMutex, unlockBusMutex);
+}
+#endif
+
+
+// ---------------------------------------------------------------------------------
+//                                   EEPROM functions
+// ---------------------------------------------------------------------------------
+
+//
+// Configuration values are kept in a RAM copy of the EEPROM that's loaded once by 
+// begin().  Reads are served from the copy, writes only change the copy and mark it 
+// dirty.  The copy is written back to the EEPROM after the UI has been idle (no 
+// touches and no new values written) for the commit delay, or when 
+// flushConfiguration() is called.  Only bytes that have changed are written.
+//
+// Writing a byte to a real EEPROM takes about 3.3ms, so when idle these are written
+// one byte per call to getTouchEvents() keeping the UI responsive.  When the EEPROM 
+// is emulated in flash, commit() writes a whole flash sector at once, so that is 
+// only done after the commit delay has passed with nothing happening.
+//
+// So that losing power while saving can't leave the values half written, the EEPROM
+// holds two copies ("slots").  Slot A is at EEPROM address 0, slot B follows it, and
+// after them are the slots' headers.  A header holds a generation count, the number 
+// of bytes in use, and a CRC of the header and the data.  Changes are saved to the 
+// inactive slot (the one with the older copy), and its header is written last.  The
+// new header makes it the active slot, until then the other slot is still valid.  At
+// power up the slot with the newest generation and a good CRC is loaded.  If neither
+// slot is valid, slot A's data is loaded as is.  This is how values saved before the
+// slots were added are read, they're then saved to slot B first.
+//
+// Note: on the RP2040 the emulated EEPROM is one 4K sector of flash that commit() 
+// erases and rewrites, so both slots live in the same sector.  The two slots protect
+// against losing power while the sector is being programmed, but not while it is 
+// being erased.
+//
+// The Pi Pico RP2040 does not come with an EEPROM so one is simulate by using a 4K 
+// chunk of flash.  Note this simulated EEPROM only supports the number of writes as 
+// supported by the onboard flash chip (not the 100K or so of a real EEPROM). Therefore, 
+// do not frequently update the EEPROM or you may wear out the flash.  The ESP32 also
+// emulates its EEPROM in flash.  On these processors the EEPROM library must be 
+// opened with begin(), and changes are saved by calling commit().
+//
+#if defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_ARCH_ESP32)
+  #define EEPROM_IS_EMULATED_IN_FLASH
+#endif
+
+
+
+//
+// write a configuration byte (8 bit) to the EEPROM
+//  Enter:  EEPromAddress = address in EEPROM to write 
+//          value = 8 bit value to write to EEPROM
+//          note: 2 bytes of EEPROM space are used 
+//
+void TouchUserInterfaceForArduino::writeConfigurationByte(int EEPromAddress, byte value)
+{
+  writeConfigurationValue(EEPromAddress, (byte*) (&value), sizeof(value));
+}
+
+
+
+//
+// read a configuration byte (8 bit) from the EEPROM
+//  Enter:  EEPromAddress = address in EEPROM to read from 
+//          defaultValue = default value to return if value has never been 
+//            written to the EEPROM
+//          note: 2 bytes of EEPROM space are used 
+//  Exit:   byte value from EEPROM (or default value) returned
+//
+byte TouchUserInterfaceForArduino::readConfigurationByte(int EEPromAddress, byte defaultValue)
+{
+  byte value;
   
-  //
-  // determine the number of columns for the character
-  //
-  byte characterWidth = pgm_read_byte(tablePntr) + pgm_read_byte(currentFont + FONT_TABLE_PAD_AFTER_CHAR_IDX);
-  return(characterWidth);
+  if (!readConfigurationValue(EEPromAddress, (byte*) (&value), sizeof(value)))
+    return(defaultValue);
+	
+  return(value);
 }
 
 
 
 //
-// get the height of the selected font in pixels, including decenders
+// write a configuration short (16 bit) to the EEPROM
+//  Enter:  EEPromAddress = address in EEPROM to write 
+//          value = 16 bit value to write to EEPROM
+//          note: 3 bytes of EEPROM space are used 
 //
-int TouchUserInterfaceForArduino::lcdGetFontHeightWithDecenders(void)
+void TouchUserInterfaceForArduino::writeConfigurationShort(int EEPromAddress, short value)
 {
-  return(pgm_read_byte(&currentFont[FONT_TABLE_HEIGHT_IDX]));
+  writeConfigurationValue(EEPromAddress, (byte*) (&value), sizeof(value));
 }
 
 
 
 //
-// get the height of the selected font in pixels, excluding decenders
+// read a configuration short (16 bit) from the EEPROM
+//  Enter:  EEPromAddress = address in EEPROM to read from 
+//          defaultValue = default value to return if value has never been 
+//            written to the EEPROM
+//          note: 3 bytes of EEPROM space are used 
+//  Exit:   short value from EEPROM (or default value) returned
 //
-int TouchUserInterfaceForArduino::lcdGetFontHeightWithoutDecenders(void)
+short TouchUserInterfaceForArduino::readConfigurationShort(int EEPromAddress, short defaultValue)
 {
-  return(pgm_read_byte(&currentFont[FONT_TABLE_HEIGHT_IDX]) -  pgm_read_byte(&currentFont[FONT_TABLE_DECENDERS_HEIGHT_IDX]));
+  short value;
+  
+  if (!readConfigurationValue(EEPromAddress, (byte*) (&value), sizeof(value)))
+    return(defaultValue);
+
+  return(value);
 }
 
 
 
 //
-// get the height of the selected font in pixels, including decenders & line spacing
+// write a configuration int (32 bit) to the EEPROM
+//  Enter:  EEPromAddress = address in EEPROM to write 
+//          value = 32 bit value to write to EEPROM
+//          note: 5 bytes of EEPROM space are used 
 //
-int TouchUserInterfaceForArduino::lcdGetFontHeightWithDecentersAndLineSpacing(void)
+void TouchUserInterfaceForArduino::writeConfigurationInt(int EEPromAddress, int value)
 {
-  return(pgm_read_byte(&currentFont[FONT_TABLE_LINE_SPACING_IDX]));
+  writeConfigurationValue(EEPromAddress, (byte*) (&value), sizeof(value));
 }
 
 
 
 //
-// set the cursor coords in pixels
-//  Enter:  x  0 = left most pixel
-//          y  0 = left most pixel
+// read a configuration int (32 bit) from the EEPROM
+//  Enter:  EEPromAddress = address in EEPROM to read from 
+//          defaultValue = default value to return if value has never been 
+//            written to the EEPROM
+//          note: 5 bytes of EEPROM space are used 
+//  Exit:   long value from EEPROM (or default value) returned
 //
-void TouchUserInterfaceForArduino::lcdSetCursorXY(int x, int y)
+int TouchUserInterfaceForArduino::readConfigurationInt(int EEPromAddress, int defaultValue)
 {
-  if ((x < 0) || (x >= lcdWidth)) return;
-  if ((y < 0) || (y >= lcdHeight)) return;
+  int value;
   
-  textCursorX = x;
-  textCursorY = y;
+  if (!readConfigurationValue(EEPromAddress, (byte*) (&value), sizeof(value)))
+    return(defaultValue);
+
+  return(value);
 }
 
 
 
 //
-// get the cursor coords in pixels
-//  Enter:  x -> storage to return X,  0 = left most pixel
-//          y -> storage to return Y,  0 = left most pixel
+// write a configuration float (32 bit) to the EEPROM
+//  Enter:  EEPromAddress = address in EEPROM to write 
+//          value = 32 bit float to write to EEPROM
+//          note: 5 bytes of EEPROM space are used 
 //
-void TouchUserInterfaceForArduino::lcdGetCursorXY(int *x, int *y)
+void TouchUserInterfaceForArduino::writeConfigurationFloat(int EEPromAddress, float value)
 {
-  *x = textCursorX;
-  *y = textCursorY;
+  writeConfigurationValue(EEPromAddress, (byte*) (&value), sizeof(value));
 }
 
 
 
 //
-// make a RGB565 color
-//  Enter:  red (0 to 31)
-//          green (0 to 63) Note: green value 0x20 has same intensity as blue value 0x10
-//          blue (0 to 31)
-//  Exit:   16 bit color returned, bit format: rrrrrggggggbbbbb
+// read a configuration float (32 bit) from the EEPROM
+//  Enter:  EEPromAddress = address in EEPROM to read from 
+//          defaultValue = default value to return if value has never been 
+//            written to the EEPROM
+//          note: 5 bytes of EEPROM space are used 
+//  Exit:   float value from EEPROM (or default value) returned
 //
-uint16_t TouchUserInterfaceForArduino::lcdMakeColor(int red, int green, int blue)
+float TouchUserInterfaceForArduino::readConfigurationFloat(int EEPromAddress, float defaultValue)
 {
-  return((red << 11) + (green << 5) + (blue));
+  float value;
+  
+  if (!readConfigurationValue(EEPromAddress, (byte*) (&value), sizeof(value)))
+    return(defaultValue);
+
+  return(value);
 }
 
 
-// ---------------------------------------------------------------------------------
-//                                   EEPROM functions
-// ---------------------------------------------------------------------------------
 
 //
-// The Pi Pico RP2040 does not come with an EEPROM so one is simulate by using a 4K 
-// chunk of flash.  Note this simulated EEPROM only supports the number of writes as 
-// supported by the onboard flash chip (not the 100K or so of a real EEPROM). Therefore, 
-// do not frequently update the EEPROM or you may wear out the flash.
+// load a block of configuration values described by a schema into the app's struct,
+// all fields are read together and checked with a CRC.  If the block was saved by an
+// older version of the schema, fields added since get their default values, the 
+// schema's migrate function is called, and the block is saved in the new version.
+//  Enter:  schema = the schema describing the fields and where they are saved
+//          configStruct -> the app's struct to fill in
+//  Exit:   true returned if saved values were loaded, false if the block has never
+//            been saved or is corrupt (all fields are set to their defaults)
 //
-#if defined(ARDUINO_ARCH_RP2040)
+boolean TouchUserInterfaceForArduino::loadConfiguration(const CONFIG_SCHEMA &schema, void *configStruct)
+{
+  byte *structPntr = (byte*) configStruct;
+  int blockAddress = schema.EEPromAddress;
+  
+  //
+  // start with the default values, any field that isn't loaded keeps its default
+  //
+  setConfigurationDefaults(schema, configStruct);
+
+  if ((blockAddress < 0) || (blockAddress + getConfigurationSize(schema) > CONFIGURATION_SIZE))
+    return(false);
+
+  loadConfigurationShadow();
+
+  //
+  // check the header: version, length of the data, and CRC
+  //
+  byte savedVersion = configurationShadow[blockAddress];
+  int dataLength = configurationShadow[blockAddress + 1] + (configurationShadow[blockAddress + 2] << 8);
+  uint16_t savedCRC = configurationShadow[blockAddress + 3] + (configurationShadow[blockAddress + 4] << 8);
+  int dataAddress = blockAddress + CONFIG_HEADER_SIZE;
+
+  if ((savedVersion == 0xff) || (savedVersion > schema.version))
+    return(false);
+
+  if (dataAddress + dataLength > CONFIGURATION_SIZE)
+    return(false);
+
+  uint16_t crc = configurationCRC(&configurationShadow[blockAddress], 3, 0xffff);
+  crc = configurationCRC(&configurationShadow[dataAddress], dataLength, crc);
+  if (crc != savedCRC)
+    return(false);
+
+  //
+  // copy the fields that existed in the saved version, skipping values out of range
+  //
+  int address = dataAddress;
+  for (const CONFIG_FIELD *field = schema.fields; field->fieldType != CONFIG_FIELD_TYPE_END_OF_FIELDS; field++)
+  {
+    if (field->versionAdded > savedVersion)
+      continue;
+
+    int fieldSize = configFieldSize(field->fieldType);
+    if (address + fieldSize > dataAddress + dataLength)
+      break;
+
+    if (configFieldInRange(field, &configurationShadow[address]))
+      memcpy(structPntr + field->structOffset, &configurationShadow[address], fieldSize);
+
+    address += fieldSize;
+  }
+
+  //
+  // bring a block saved by an older version up to date
+  //
+  if (savedVersion != schema.version)
+  {
+    if (schema.migrateFunction != NULL)
+      schema.migrateFunction(savedVersion, configStruct);
+    saveConfiguration(schema, configStruct);
+  }
+
+  return(true);
+}
 
-int const EEPROM_SIZE = 1024;
-boolean EEPROMOpenFlg = false;
 
 
 //
-// write a configuration byte (8 bit) to the Pi Pico's simulated EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to write 
-//          value = 8 bit value to write to EEPROM
-//          note: 2 bytes of EEPROM space are used 
+// save the app's struct as a block of configuration values described by a schema
+//  Enter:  schema = the schema describing the fields and where they are saved
+//          configStruct -> the app's struct holding the values
 //
-void TouchUserInterfaceForArduino::writeConfigurationByte(int EEPromAddress, byte value)
+void TouchUserInterfaceForArduino::saveConfiguration(const CONFIG_SCHEMA &schema, const void *configStruct)
 {
-  if (!EEPROMOpenFlg) 
+  const byte *structPntr = (const byte*) configStruct;
+  int blockAddress = schema.EEPromAddress;
+  int dataAddress = blockAddress + CONFIG_HEADER_SIZE;
+  byte header[CONFIG_HEADER_SIZE];
+
+  if ((blockAddress < 0) || (blockAddress + getConfigurationSize(schema) > CONFIGURATION_SIZE))
+    return;
+
+  //
+  // pack the fields one after another
+  //
+  int address = dataAddress;
+  for (const CONFIG_FIELD *field = schema.fields; field->fieldType != CONFIG_FIELD_TYPE_END_OF_FIELDS; field++)
   {
-    EEPROM.begin(EEPROM_SIZE);
-    EEPROMOpenFlg = true;
+    int fieldSize = configFieldSize(field->fieldType);
+    setConfigurationBytes(address, structPntr + field->structOffset, fieldSize);
+    address += fieldSize;
   }
-  
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    EEPROM.write(EEPromAddress, 0);
-  
-  EEPROM.write(EEPromAddress + 1, value);
 
-  EEPROM.commit();
-  EEPROMOpenFlg = false;
+  //
+  // write the header with the version and length of the data, then the CRC of 
+  // the header and data
+  //
+  int dataLength = address - dataAddress;
+  header[0] = schema.version;
+  header[1] = dataLength & 0xff;
+  header[2] = dataLength >> 8;
+  setConfigurationBytes(blockAddress, header, 3);
+
+  uint16_t crc = configurationCRC(&configurationShadow[blockAddress], 3, 0xffff);
+  crc = configurationCRC(&configurationShadow[dataAddress], dataLength, crc);
+  header[3] = crc & 0xff;
+  header[4] = crc >> 8;
+  setConfigurationBytes(blockAddress + 3, &header[3], 2);
 }
 
 
 
 //
-// read a configuration byte (8 bit) from the Pi Pico's simulated EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to read from 
-//          defaultValue = default value to return if value has never been 
-//            written to the EEPROM
-//          note: 2 bytes of EEPROM space are used 
-//  Exit:   byte value from EEPROM (or default value) returned
+// fill in the app's struct with the default values from a schema
+//  Enter:  schema = the schema describing the fields
+//          configStruct -> the app's struct to fill in
 //
-byte TouchUserInterfaceForArduino::readConfigurationByte(int EEPromAddress, byte defaultValue)
+void TouchUserInterfaceForArduino::setConfigurationDefaults(const CONFIG_SCHEMA &schema, void *configStruct)
 {
-  if (!EEPROMOpenFlg) 
+  byte *structPntr = (byte*) configStruct;
+
+  for (const CONFIG_FIELD *field = schema.fields; field->fieldType != CONFIG_FIELD_TYPE_END_OF_FIELDS; field++)
   {
-    EEPROM.begin(EEPROM_SIZE);
-    EEPROMOpenFlg = true;
+    byte *fieldPntr = structPntr + field->structOffset;
+
+    switch(field->fieldType)
+    {
+      case CONFIG_FIELD_TYPE_BYTE:
+        *(byte*) fieldPntr = (byte) field->defaultValue;
+        break;
+      case CONFIG_FIELD_TYPE_SHORT:
+        *(short*) fieldPntr = (short) field->defaultValue;
+        break;
+      case CONFIG_FIELD_TYPE_INT:
+        *(int*) fieldPntr = (int) field->defaultValue;
+        break;
+      case CONFIG_FIELD_TYPE_FLOAT:
+        *(float*) fieldPntr = (float) field->defaultValue;
+        break;
+    }
   }
+}
+
+
+
+//
+// get the number of bytes of EEPROM used by a schema's block of configuration values
+//  Enter:  schema = the schema describing the fields
+//  Exit:   number of bytes returned
+//
+int TouchUserInterfaceForArduino::getConfigurationSize(const CONFIG_SCHEMA &schema)
+{
+  int size = CONFIG_HEADER_SIZE;
+
+  for (const CONFIG_FIELD *field = schema.fields; field->fieldType != CONFIG_FIELD_TYPE_END_OF_FIELDS; field++)
+    size += configFieldSize(field->fieldType);
+
+  return(size);
+}
+
+
+
+//
+// write any configuration values that have changed to the EEPROM now, call this 
+// before powering down or resetting if values may have been written recently
+//
+void TouchUserInterfaceForArduino::flushConfiguration(void)
+{
+  if (!configurationDirtyFlg)
+    return;
 
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    return(defaultValue);
-  
-  return(EEPROM.read(EEPromAddress + 1));
+  TRACE_SCOPE(TRACE_CONFIGURATION_COMMIT);
+  unsigned long startTime = micros();
+
+  writeConfigurationCommitStep(false);
+
+  #if defined(EEPROM_IS_EMULATED_IN_FLASH)
+    EEPROM.commit();
+  #endif
+
+  recordConfigurationCommitTime(micros() - startTime, true);
 }
 
 
 
 //
-// write a configuration short (16 bit) to the Pi Pico's simulated EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to write 
-//          value = 16 bit value to write to EEPROM
-//          note: 3 bytes of EEPROM space are used 
+// set how long the UI must be idle before changed configuration values are written
+// to the EEPROM
+//  Enter:  idleMilliseconds = time with no touches and no values written, in ms
 //
-void TouchUserInterfaceForArduino::writeConfigurationShort(int EEPromAddress, short value)
+void TouchUserInterfaceForArduino::setConfigurationCommitDelay(unsigned long idleMilliseconds)
 {
-  byte *dataPntr;
+  configurationCommitDelay = idleMilliseconds;
+}
 
-  if (!EEPROMOpenFlg) 
-  {
-    EEPROM.begin(EEPROM_SIZE);
-    EEPROMOpenFlg = true;
-  }
-  
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    EEPROM.write(EEPromAddress, 0);
 
-  dataPntr = (byte*) (&value);
-  
-  EEPROM.write(EEPromAddress + 1, dataPntr[0]);
-  EEPROM.write(EEPromAddress + 2, dataPntr[1]);
 
-  EEPROM.commit();
-  EEPROMOpenFlg = false;
+//
+// get statistics about writing configuration values to the EEPROM, this is used to
+// measure how long the UI is held up saving values
+//  Enter:  stats = storage to return the statistics
+//
+void TouchUserInterfaceForArduino::getConfigurationCommitStats(CONFIGURATION_COMMIT_STATS &stats)
+{
+  stats = configurationCommitStats;
 }
 
 
 
 //
-// read a configuration short (16 bit) from the Pi Pico's simulated EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to read from 
-//          defaultValue = default value to return if value has never been 
-//            written to the EEPROM
-//          note: 3 bytes of EEPROM space are used 
-//  Exit:   short value from EEPROM (or default value) returned
+// save changed configuration values to the EEPROM once the UI has been idle for the
+// commit delay, this is called by getTouchEvents() when the screen isn't touched
 //
-short TouchUserInterfaceForArduino::readConfigurationShort(int EEPromAddress, short defaultValue)
+void TouchUserInterfaceForArduino::commitConfigurationWhenIdle(void)
 {
-  short value;
-  byte *dataPntr;
-  
-  if (!EEPROMOpenFlg) 
-  {
-    EEPROM.begin(EEPROM_SIZE);
-    EEPROMOpenFlg = true;
-  }
+  if (!configurationDirtyFlg)
+    return;
 
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    return(defaultValue);
+  if ((millis() - configurationIdleStartTime) < configurationCommitDelay)
+    return;
 
-  dataPntr = (byte*) (&value);
+  //
+  // flash must be committed all at once
+  //
+  #if defined(EEPROM_IS_EMULATED_IN_FLASH)
+    flushConfiguration();
+    return;
+  #endif
 
-  dataPntr[0] = EEPROM.read(EEPromAddress + 1);
-  dataPntr[1] = EEPROM.read(EEPromAddress + 2);  
-  return(value);
+  //
+  // write the next byte that has changed, one byte per call
+  //
+  TRACE_SCOPE(TRACE_CONFIGURATION_COMMIT);
+  unsigned long startTime = micros();
+  boolean commitCompleteFlg = writeConfigurationCommitStep(true);
+  recordConfigurationCommitTime(micros() - startTime, commitCompleteFlg);
 }
 
 
 
 //
-// write a configuration int (32 bit) to the Pi Pico's simulated EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to write 
-//          value = 32 bit value to write to EEPROM
-//          note: 5 bytes of EEPROM space are used 
+// write the RAM copy of the configuration values to the inactive slot in EEPROM,
+// then its header making it the active slot.  Only bytes that differ from what's 
+// in the slot are written.
+//  Enter:  oneByteFlg = true to return after writing one byte, false to write all
+//  Exit:   true returned when the commit is complete
 //
-void TouchUserInterfaceForArduino::writeConfigurationInt(int EEPromAddress, int value)
+boolean TouchUserInterfaceForArduino::writeConfigurationCommitStep(boolean oneByteFlg)
 {
-  byte *dataPntr;
-  
-  if (!EEPROMOpenFlg) 
+  int slot = (configurationActiveSlot == 1) ? 0 : 1;
+  int slotAddress = slot * CONFIGURATION_SIZE;
+  int headerAddress = CONFIGURATION_SLOT_HEADERS_ADDRESS + slot * CONFIGURATION_SLOT_HEADER_SIZE;
+
+  while (configurationDirtyFlg)
   {
-    EEPROM.begin(EEPROM_SIZE);
-    EEPROMOpenFlg = true;
-  }
-  
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    EEPROM.write(EEPromAddress, 0);
+    //
+    // copy the data into the slot
+    //
+    if (configurationCommitHeaderIdx < 0)
+    {
+      if (configurationCommitAddress < configurationUsedLength)
+      {
+        int address = configurationCommitAddress;
+        configurationCommitAddress++;
+        
+        if (EEPROM.read(slotAddress + address) != configurationShadow[address])
+        {
+          EEPROM.write(slotAddress + address, configurationShadow[address]);
+          configurationCommitStats.bytesWritten++;
+          if (oneByteFlg)
+            return(false);
+        }
+        continue;
+      }
 
-  dataPntr = (byte*) (&value);
-  
-  EEPROM.write(EEPromAddress + 1, dataPntr[0]);
-  EEPROM.write(EEPromAddress + 2, dataPntr[1]);
-  EEPROM.write(EEPromAddress + 3, dataPntr[2]);
-  EEPROM.write(EEPromAddress + 4, dataPntr[3]);
+      //
+      // all the data is in the slot, build its header
+      //
+      uint16_t generation = configurationGeneration + 1;
+      configurationCommitHeader[0] = generation & 0xff;
+      configurationCommitHeader[1] = generation >> 8;
+      configurationCommitHeader[2] = configurationUsedLength & 0xff;
+      configurationCommitHeader[3] = configurationUsedLength >> 8;
+      
+      uint16_t crc = configurationCRC(configurationCommitHeader, 4, 0xffff);
+      crc = configurationCRC(configurationShadow, configurationUsedLength, crc);
+      configurationCommitHeader[4] = crc & 0xff;
+      configurationCommitHeader[5] = crc >> 8;
+      configurationCommitHeaderIdx = 0;
+      continue;
+    }
+
+    //
+    // write the header
+    //
+    if (configurationCommitHeaderIdx < CONFIGURATION_SLOT_HEADER_SIZE)
+    {
+      int address = headerAddress + configurationCommitHeaderIdx;
+      byte value = configurationCommitHeader[configurationCommitHeaderIdx];
+      configurationCommitHeaderIdx++;
+
+      if (EEPROM.read(address) != value)
+      {
+        EEPROM.write(address, value);
+        configurationCommitStats.bytesWritten++;
+        if (oneByteFlg && (configurationCommitHeaderIdx < CONFIGURATION_SLOT_HEADER_SIZE))
+          return(false);
+      }
+      continue;
+    }
+
+    //
+    // the header is written, this slot is now the active one
+    //
+    configurationActiveSlot = slot;
+    configurationGeneration++;
+    configurationDirtyFlg = false;
+  }
 
-  EEPROM.commit();
-  EEPROMOpenFlg = false;
+  return(true);
 }
 
 
 
 //
-// read a configuration int (32 bit) from the Pi Pico's simulated EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to read from 
-//          defaultValue = default value to return if value has never been 
-//            written to the EEPROM
-//          note: 5 bytes of EEPROM space are used 
-//  Exit:   long value from EEPROM (or default value) returned
+// record the time spent writing configuration values to the EEPROM
+//  Enter:  stepMicros = time the UI was held up by this write step, in us
+//          commitCompleteFlg = true if all changes have now been written
 //
-int TouchUserInterfaceForArduino::readConfigurationInt(int EEPromAddress, int defaultValue)
+void TouchUserInterfaceForArduino::recordConfigurationCommitTime(unsigned long stepMicros, boolean commitCompleteFlg)
 {
-  int value;
-  byte *dataPntr;
-  
-  if (!EEPROMOpenFlg) 
-  {
-    EEPROM.begin(EEPROM_SIZE);
-    EEPROMOpenFlg = true;
-  }
+  configurationCommitMicros += stepMicros;
 
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    return(defaultValue);
+  if (stepMicros > configurationCommitStats.longestStallMicros)
+    configurationCommitStats.longestStallMicros = stepMicros;
 
-  dataPntr = (byte*) (&value);
+  if (!commitCompleteFlg)
+    return;
 
-  dataPntr[0] = EEPROM.read(EEPromAddress + 1);
-  dataPntr[1] = EEPROM.read(EEPromAddress + 2);
-  dataPntr[2] = EEPROM.read(EEPromAddress + 3);
-  dataPntr[3] = EEPROM.read(EEPromAddress + 4);
-  return(value);
+  configurationCommitStats.commitCount++;
+  configurationCommitStats.lastCommitMicros = configurationCommitMicros;
+  if (configurationCommitMicros > configurationCommitStats.longestCommitMicros)
+    configurationCommitStats.longestCommitMicros = configurationCommitMicros;
 }
 
 
 
 //
-// write a configuration float (32 bit) to the Pi Pico's simulated EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to write 
-//          value = 32 bit float to write to EEPROM
-//          note: 5 bytes of EEPROM space are used 
+// load the RAM copy of the configuration values from the EEPROM, this is done 
+// only once.  The newest slot is loaded if it's valid, otherwise the other slot.
 //
-void TouchUserInterfaceForArduino::writeConfigurationFloat(int EEPromAddress, float value)
+void TouchUserInterfaceForArduino::loadConfigurationShadow(void)
 {
-  byte *dataPntr;
+  byte header[2][CONFIGURATION_SLOT_HEADER_SIZE];
+  boolean possibleFlg[2];
   
-  if (!EEPROMOpenFlg) 
+  if (configurationShadowLoadedFlg)
+    return;
+
+  #if defined(EEPROM_IS_EMULATED_IN_FLASH)
+    EEPROM.begin(CONFIGURATION_EEPROM_SIZE);
+  #endif
+
+  //
+  // read the headers of both slots, an erased header has an impossible length
+  //
+  for (int slot = 0; slot < 2; slot++)
   {
-    EEPROM.begin(EEPROM_SIZE);
-    EEPROMOpenFlg = true;
+    for (int i = 0; i < CONFIGURATION_SLOT_HEADER_SIZE; i++)
+      header[slot][i] = EEPROM.read(CONFIGURATION_SLOT_HEADERS_ADDRESS + slot * CONFIGURATION_SLOT_HEADER_SIZE + i);
+
+    int usedLength = header[slot][2] + (header[slot][3] << 8);
+    possibleFlg[slot] = (usedLength <= CONFIGURATION_SIZE);
   }
-  
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    EEPROM.write(EEPromAddress, 0);
 
-  dataPntr = (byte*) (&value);
-  
-  EEPROM.write(EEPromAddress + 1, dataPntr[0]);
-  EEPROM.write(EEPromAddress + 2, dataPntr[1]);
-  EEPROM.write(EEPromAddress + 3, dataPntr[2]);
-  EEPROM.write(EEPromAddress + 4, dataPntr[3]);
+  //
+  // try the slot with the newest generation first
+  //
+  int slot = possibleFlg[1] ? 1 : 0;
+  if (possibleFlg[0] && possibleFlg[1])
+  {
+    uint16_t generation0 = header[0][0] + (header[0][1] << 8);
+    uint16_t generation1 = header[1][0] + (header[1][1] << 8);
+    slot = ((int16_t) (generation1 - generation0) > 0) ? 1 : 0;
+  }
+
+  configurationActiveSlot = -1;
+  for (int tries = 0; tries < 2; tries++, slot = 1 - slot)
+  {
+    if (possibleFlg[slot] && loadConfigurationSlot(slot, header[slot]))
+    {
+      configurationActiveSlot = slot;
+      break;
+    }
+  }
+
+  //
+  // if there is no valid slot, load slot A's data as is, values saved before there 
+  // were slots are found there 
+  //
+  if (configurationActiveSlot == -1)
+  {
+    configurationUsedLength = 0;
+    for (int address = 0; address < CONFIGURATION_SIZE; address++)
+    {
+      configurationShadow[address] = EEPROM.read(address);
+      if (configurationShadow[address] != 0xff)
+        configurationUsedLength = address + 1;
+    }
+    configurationGeneration = 0;
+  }
 
-  EEPROM.commit();
-  EEPROMOpenFlg = false;
+  configurationShadowLoadedFlg = true;
+  configurationDirtyFlg = false;
 }
 
 
 
 //
-// read a configuration float (32 bit) from the Pi Pico's simulated EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to read from 
-//          defaultValue = default value to return if value has never been 
-//            written to the EEPROM
-//          note: 5 bytes of EEPROM space are used 
-//  Exit:   float value from EEPROM (or default value) returned
+// load the RAM copy of the configuration values from one of the slots, checking 
+// the CRC as it's copied
+//  Enter:  slot = 0 for slot A, 1 for slot B
+//          header -> the slot's header
+//  Exit:   true returned if the slot is valid
 //
-float TouchUserInterfaceForArduino::readConfigurationFloat(int EEPromAddress, float defaultValue)
+boolean TouchUserInterfaceForArduino::loadConfigurationSlot(int slot, const byte *header)
 {
-  float value;
-  byte *dataPntr;
-  
-  if (!EEPROMOpenFlg) 
+  int slotAddress = slot * CONFIGURATION_SIZE;
+  int usedLength = header[2] + (header[3] << 8);
+  uint16_t savedCRC = header[4] + (header[5] << 8);
+
+  uint16_t crc = configurationCRC(header, 4, 0xffff);
+  for (int address = 0; address < usedLength; address++)
   {
-    EEPROM.begin(EEPROM_SIZE);
-    EEPROMOpenFlg = true;
+    configurationShadow[address] = EEPROM.read(slotAddress + address);
+    crc = configurationCRC(&configurationShadow[address], 1, crc);
   }
 
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    return(defaultValue);
+  if (crc != savedCRC)
+    return(false);
 
-  dataPntr = (byte*) (&value);
+  for (int address = usedLength; address < CONFIGURATION_SIZE; address++)
+    configurationShadow[address] = 0xff;
 
-  dataPntr[0] = EEPROM.read(EEPromAddress + 1);
-  dataPntr[1] = EEPROM.read(EEPromAddress + 2);
-  dataPntr[2] = EEPROM.read(EEPromAddress + 3);
-  dataPntr[3] = EEPROM.read(EEPromAddress + 4);
-  return(value);
+  configurationUsedLength = usedLength;
+  configurationGeneration = header[0] + (header[1] << 8);
+  return(true);
 }
-#endif
 
 
 
 //
-// these EEPROM functions are used by all processors except the RP2040
-//
-#if !defined(ARDUINO_ARCH_RP2040)
-
-//
-// write a configuration byte (8 bit) to the EEPROM
+// write a configuration value to the RAM copy of the EEPROM, a marker byte is 
+// stored first, followed by the value's bytes
 //  Enter:  EEPromAddress = address in EEPROM to write 
-//          value = 8 bit value to write to EEPROM
-//          note: 2 bytes of EEPROM space are used 
+//          dataPntr -> the value's bytes
+//          dataLength = number of bytes in the value
 //
-void TouchUserInterfaceForArduino::writeConfigurationByte(int EEPromAddress, byte value)
+void TouchUserInterfaceForArduino::writeConfigurationValue(int EEPromAddress, const byte *dataPntr, int dataLength)
 {
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    EEPROM.write(EEPromAddress, 0);
-	
-  EEPROM.write(EEPromAddress + 1, value);
-}
-
+  byte marker = 0;
 
+  if ((EEPromAddress < 0) || (EEPromAddress + dataLength >= CONFIGURATION_SIZE))
+    return;
 
-//
-// read a configuration byte (8 bit) from the EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to read from 
-//          defaultValue = default value to return if value has never been 
-//            written to the EEPROM
-//          note: 2 bytes of EEPROM space are used 
-//  Exit:   byte value from EEPROM (or default value) returned
-//
-byte TouchUserInterfaceForArduino::readConfigurationByte(int EEPromAddress, byte defaultValue)
-{
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    return(defaultValue);
-	
-    return(EEPROM.read(EEPromAddress + 1));
+  setConfigurationBytes(EEPromAddress, &marker, 1);
+  setConfigurationBytes(EEPromAddress + 1, dataPntr, dataLength);
 }
 
 
 
 //
-// write a configuration short (16 bit) to the EEPROM
+// copy bytes into the RAM copy of the EEPROM, marking what's changed so it will 
+// be written to the EEPROM
 //  Enter:  EEPromAddress = address in EEPROM to write 
-//          value = 16 bit value to write to EEPROM
-//          note: 3 bytes of EEPROM space are used 
+//          dataPntr -> the bytes to write
+//          dataLength = number of bytes
 //
-void TouchUserInterfaceForArduino::writeConfigurationShort(int EEPromAddress, short value)
+void TouchUserInterfaceForArduino::setConfigurationBytes(int EEPromAddress, const byte *dataPntr, int dataLength)
 {
-  byte *dataPntr;
+  boolean changedFlg = false;
+  int lastAddress = EEPromAddress + dataLength - 1;
 
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    EEPROM.write(EEPromAddress, 0);
+  if ((EEPromAddress < 0) || (dataLength <= 0) || (lastAddress >= CONFIGURATION_SIZE))
+    return;
 
-	dataPntr = (byte*) (&value);
-  
-  EEPROM.write(EEPromAddress + 1, dataPntr[0]);
-  EEPROM.write(EEPromAddress + 2, dataPntr[1]);
-}
+  loadConfigurationShadow();
 
+  //
+  // update the bytes, noting if anything is different
+  //
+  for (int i = 0; i < dataLength; i++)
+  {
+    if (configurationShadow[EEPromAddress + i] != dataPntr[i])
+    {
+      configurationShadow[EEPromAddress + i] = dataPntr[i];
+      changedFlg = true;
+    }
+  }
 
+  if (!changedFlg)
+    return;
 
-//
-// read a configuration short (16 bit) from the EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to read from 
-//          defaultValue = default value to return if value has never been 
-//            written to the EEPROM
-//          note: 3 bytes of EEPROM space are used 
-//  Exit:   short value from EEPROM (or default value) returned
-//
-short TouchUserInterfaceForArduino::readConfigurationShort(int EEPromAddress, short defaultValue)
-{
-  short value;
-  byte *dataPntr;
-  
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    return(defaultValue);
+  if (lastAddress >= configurationUsedLength)
+    configurationUsedLength = lastAddress + 1;
 
-  dataPntr = (byte*) (&value);
+  //
+  // start a new commit, the whole copy is compared with the inactive slot.  If a 
+  // commit is under way and the change is before the address it has reached, back 
+  // it up (this also discards a header that's partly written)
+  //
+  if (!configurationDirtyFlg)
+  {
+    configurationCommitAddress = 0;
+    configurationCommitHeaderIdx = -1;
+    configurationCommitMicros = 0;
+    configurationDirtyFlg = true;
+  }
+  else
+  {
+    if ((EEPromAddress < configurationCommitAddress) || (configurationCommitHeaderIdx >= 0))
+    {
+      if (EEPromAddress < configurationCommitAddress)
+        configurationCommitAddress = EEPromAddress;
+      configurationCommitHeaderIdx = -1;
+    }
+  }
 
-  dataPntr[0] = EEPROM.read(EEPromAddress + 1);
-  dataPntr[1] = EEPROM.read(EEPromAddress + 2);  
-  return(value);
+  configurationIdleStartTime = millis();
 }
 
 
 
 //
-// write a configuration int (32 bit) to the EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to write 
-//          value = 32 bit value to write to EEPROM
-//          note: 5 bytes of EEPROM space are used 
+// read a configuration value from the RAM copy of the EEPROM
+//  Enter:  EEPromAddress = address in EEPROM to read from 
+//          dataPntr -> storage to return the value's bytes
+//          dataLength = number of bytes in the value
+//  Exit:   true returned if the value has been written before, else false
 //
-void TouchUserInterfaceForArduino::writeConfigurationInt(int EEPromAddress, int value)
+boolean TouchUserInterfaceForArduino::readConfigurationValue(int EEPromAddress, byte *dataPntr, int dataLength)
 {
-  byte *dataPntr;
-  
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    EEPROM.write(EEPromAddress, 0);
+  if ((EEPromAddress < 0) || (EEPromAddress + dataLength >= CONFIGURATION_SIZE))
+    return(false);
 
-  dataPntr = (byte*) (&value);
-  
-  EEPROM.write(EEPromAddress + 1, dataPntr[0]);
-  EEPROM.write(EEPromAddress + 2, dataPntr[1]);
-  EEPROM.write(EEPromAddress + 3, dataPntr[2]);
-  EEPROM.write(EEPromAddress + 4, dataPntr[3]);
+  loadConfigurationShadow();
+
+  if (configurationShadow[EEPromAddress] == 0xff)
+    return(false);
+
+  for (int i = 0; i < dataLength; i++)
+    dataPntr[i] = configurationShadow[EEPromAddress + 1 + i];
+  return(true);
 }
 
 
 
+
+
 //
-// read a configuration int (32 bit) from the EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to read from 
-//          defaultValue = default value to return if value has never been 
-//            written to the EEPROM
-//          note: 5 bytes of EEPROM space are used 
-//  Exit:   long value from EEPROM (or default value) returned
+// get the number of bytes used to save a configuration field
+//  Enter:  fieldType = CONFIG_FIELD_TYPE_BYTE, _SHORT, _INT or _FLOAT
+//  Exit:   number of bytes returned
 //
-int TouchUserInterfaceForArduino::readConfigurationInt(int EEPromAddress, int defaultValue)
+int TouchUserInterfaceForArduino::configFieldSize(byte fieldType)
 {
-  int value;
-  byte *dataPntr;
-  
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    return(defaultValue);
-
-  dataPntr = (byte*) (&value);
-
-  dataPntr[0] = EEPROM.read(EEPromAddress + 1);
-  dataPntr[1] = EEPROM.read(EEPromAddress + 2);
-  dataPntr[2] = EEPROM.read(EEPromAddress + 3);
-  dataPntr[3] = EEPROM.read(EEPromAddress + 4);
-  return(value);
+  switch(fieldType)
+  {
+    case CONFIG_FIELD_TYPE_BYTE:
+      return(sizeof(byte));
+    case CONFIG_FIELD_TYPE_SHORT:
+      return(sizeof(short));
+    case CONFIG_FIELD_TYPE_INT:
+      return(sizeof(int));
+    case CONFIG_FIELD_TYPE_FLOAT:
+      return(sizeof(float));
+  }
+  return(0);
 }
 
 
 
 //
-// write a configuration float (32 bit) to the EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to write 
-//          value = 32 bit float to write to EEPROM
-//          note: 5 bytes of EEPROM space are used 
+// check if a saved configuration value is within the field's range
+//  Enter:  field -> the field's entry in the schema
+//          valuePntr -> the saved value's bytes
+//  Exit:   true returned if in range (or the field has no range), else false
 //
-void TouchUserInterfaceForArduino::writeConfigurationFloat(int EEPromAddress, float value)
+boolean TouchUserInterfaceForArduino::configFieldInRange(const CONFIG_FIELD *field, const byte *valuePntr)
 {
-  byte *dataPntr;
-  
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    EEPROM.write(EEPromAddress, 0);
+  double value;
+  byte byteValue;
+  short shortValue;
+  int intValue;
+  float floatValue;
 
-  dataPntr = (byte*) (&value);
-  
-  EEPROM.write(EEPromAddress + 1, dataPntr[0]);
-  EEPROM.write(EEPromAddress + 2, dataPntr[1]);
-  EEPROM.write(EEPromAddress + 3, dataPntr[2]);
-  EEPROM.write(EEPromAddress + 4, dataPntr[3]);
+  if (field->minimumValue >= field->maximumValue)
+    return(true);
+
+  switch(field->fieldType)
+  {
+    case CONFIG_FIELD_TYPE_BYTE:
+      memcpy(&byteValue, valuePntr, sizeof(byteValue));
+      value = byteValue;
+      break;
+    case CONFIG_FIELD_TYPE_SHORT:
+      memcpy(&shortValue, valuePntr, sizeof(shortValue));
+      value = shortValue;
+      break;
+    case CONFIG_FIELD_TYPE_INT:
+      memcpy(&intValue, valuePntr, sizeof(intValue));
+      value = intValue;
+      break;
+    case CONFIG_FIELD_TYPE_FLOAT:
+      memcpy(&floatValue, valuePntr, sizeof(floatValue));
+      if (isnan(floatValue))
+        return(false);
+      value = floatValue;
+      break;
+    default:
+      return(false);
+  }
+
+  return((value >= field->minimumValue) && (value <= field->maximumValue));
 }
 
 
 
 //
-// read a configuration float (32 bit) from the EEPROM
-//  Enter:  EEPromAddress = address in EEPROM to read from 
-//          defaultValue = default value to return if value has never been 
-//            written to the EEPROM
-//          note: 5 bytes of EEPROM space are used 
-//  Exit:   float value from EEPROM (or default value) returned
+// compute the CRC-16 (CCITT) of a block of bytes
+//  Enter:  dataPntr -> the bytes
+//          length = number of bytes
+//          crc = starting CRC value, 0xffff for a new CRC
+//  Exit:   updated CRC returned
 //
-float TouchUserInterfaceForArduino::readConfigurationFloat(int EEPromAddress, float defaultValue)
+uint16_t TouchUserInterfaceForArduino::configurationCRC(const byte *dataPntr, int length, uint16_t crc)
 {
-  float value;
-  byte *dataPntr;
-  
-  if (EEPROM.read(EEPromAddress) == 0xff)
-    return(defaultValue);
-
-  dataPntr = (byte*) (&value);
-
-  dataPntr[0] = EEPROM.read(EEPromAddress + 1);
-  dataPntr[1] = EEPROM.read(EEPromAddress + 2);
-  dataPntr[2] = EEPROM.read(EEPromAddress + 3);
-  dataPntr[3] = EEPROM.read(EEPromAddress + 4);
-  return(value);
+  for (int i = 0; i < length; i++)
+  {
+    crc ^= (uint16_t) dataPntr[i] << 8;
+    for (int bit = 0; bit < 8; bit++)
+    {
+      if (crc & 0x8000)
+        crc = (crc << 1) ^ 0x1021;
+      else
+        crc = crc << 1;
+    }
+  }
+  return(crc);
 }
-#endif
 
 
 // -------------------------------------- End --------------------------------------
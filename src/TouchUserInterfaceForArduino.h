@@ -33,9 +33,20 @@
 #ifndef TouchUserInterfaceForArduino_h
 #define TouchUserInterfaceForArduino_h
 
+#include <stddef.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_ILI9341.h>
 
+class XPT2046_Touchscreen;
+
+
+//
+// uncomment to build the draw-call profiler into the library (or define it in the
+// compiler's flags), see getProfileStats().  When it's not defined the profiler
+// compiles to nothing.
+//
+//#define TOUCH_UI_PROFILER
+
 
 //
 // lcd display screen orientations
@@ -71,6 +82,80 @@ const uint16_t LCD_ORANGE =      0xFD20;
 const uint16_t LCD_GREENYELLOW = 0xAFE5;
 
 
+//
+// a label measured when the sketch is compiled, made with UI_TEXT("label", font),
+// it holds the text's width and where it can break onto a second line
+//
+const int UI_LABEL_MAX_BREAKS = 4;
+
+typedef struct 
+{
+  const char *text;
+  const byte *font;                         // the font it was measured in
+  int16_t length;                           // number of characters
+  int16_t width;                            // width in pixels
+  byte spaceCount;                          // number of spaces the text can break at
+  byte breakIndexes[UI_LABEL_MAX_BREAKS];   // index of each of the first spaces
+  int16_t breakWidths[UI_LABEL_MAX_BREAKS]; // width of the text before each of them
+} UI_LABEL;
+
+
+//
+// functions that UI_TEXT() uses to measure the text, the compiler runs these
+//
+constexpr int uiLabelCharacterWidth(const byte *widths, byte c)
+{
+  return(((c < 0x20) || (c > 0x7f)) ? 0 : widths[c - 0x20 + 1] + widths[0]);
+}
+
+constexpr int uiLabelLength(const char *s)
+{
+  return((*s == 0) ? 0 : 1 + uiLabelLength(s + 1));
+}
+
+constexpr int uiLabelWidth(const byte *widths, const char *s, int length)
+{
+  return((length <= 0) ? 0 : uiLabelWidth(widths, s, length - 1) + uiLabelCharacterWidth(widths, (byte) s[length - 1]));
+}
+
+constexpr int uiLabelSpaceCount(const char *s)
+{
+  return((*s == 0) ? 0 : (*s == ' ') + uiLabelSpaceCount(s + 1));
+}
+
+constexpr int uiLabelSpaceIndex(const char *s, int spaceNumber, int idx = 0)
+{
+  return((s[idx] == 0) ? 0 :
+    (s[idx] != ' ') ? uiLabelSpaceIndex(s, spaceNumber, idx + 1) :
+    (spaceNumber == 1) ? idx : uiLabelSpaceIndex(s, spaceNumber - 1, idx + 1));
+}
+
+constexpr UI_LABEL uiMakeLabel(const char *text, const byte *font, const byte *widths)
+{
+  return(UI_LABEL {text, font, (int16_t) uiLabelLength(text), (int16_t) uiLabelWidth(widths, text, uiLabelLength(text)),
+    (byte) ((uiLabelSpaceCount(text) > 255) ? 255 : uiLabelSpaceCount(text)),
+    {(byte) uiLabelSpaceIndex(text, 1), (byte) uiLabelSpaceIndex(text, 2), 
+     (byte) uiLabelSpaceIndex(text, 3), (byte) uiLabelSpaceIndex(text, 4)},
+    {(int16_t) uiLabelWidth(widths, text, uiLabelSpaceIndex(text, 1)), (int16_t) uiLabelWidth(widths, text, uiLabelSpaceIndex(text, 2)),
+     (int16_t) uiLabelWidth(widths, text, uiLabelSpaceIndex(text, 3)), (int16_t) uiLabelWidth(widths, text, uiLabelSpaceIndex(text, 4))}});
+}
+
+#define UI_TEXT(text, font) uiMakeLabel(text, font, font##_Widths)
+
+
+//
+// format numbers as text, much faster than itoa() and dtostrf() on processors 
+// without an FPU.  They write to a buffer of at least UI_NUMBER_BUFFER_LENGTH bytes
+// and return the length of the text.
+//
+const int UI_NUMBER_BUFFER_LENGTH = 24;
+const int UI_NUMBER_MAX_DIGITS_RIGHT_OF_DECIMAL = 9;
+
+int uiFormatInt(char *buffer, long n);
+int uiFormatFixed(char *buffer, long scaledValue, int digitsRightOfDecimal);
+int uiFormatFloat(char *buffer, double n, int digitsRightOfDecimal);
+
+
 //
 // definition of a Button, the menu's colors and font are used 
 //
@@ -186,6 +271,28 @@ typedef struct
 } SLIDER;
 
 
+//
+// definition of a Text Box, showing text that's word wrapped to fit and scrolled 
+// by touching it.  The text is broken into lines once, the index in the text of 
+// each line is kept in a buffer given by the app.
+//
+typedef struct 
+{
+  const char *text;                         // lines are broken at spaces and at '\n'
+  int centerX;
+  int centerY;
+  int width;
+  int height;
+  uint16_t *lineStarts;                     // buffer for the index of each line
+  int lineStartsSize;                       // number of entries in the buffer, more lines aren't shown
+  int topLine;                              // first line shown, starts at 0
+  int lineCount;                            // set when the text is broken into lines
+  const char *layoutText;                   // text, font and width the lines were found for
+  const byte *layoutFont;
+  int layoutWidth;
+} TEXT_BOX;
+
+
 //
 // definition of an entry in menu's table
 //
@@ -218,6 +325,327 @@ const byte MENU_ITEM_TYPE_END_OF_MENU      = 5;
 #define MENU_COLUMNS_4  ((void (*)()) 4)
 
 
+//
+// position and size of a button on a menu
+//
+typedef struct
+{
+  int16_t x;                                // upper left corner
+  int16_t y;
+  int16_t width;
+  int16_t height;
+} MENU_BUTTON_RECT;
+
+
+//
+// the layout of the buttons on a menu, given the number of buttons, the number of 
+// columns and the display space, these are constexpr so a layout of constants is 
+// found when compiling
+//
+const int MENU_BUTTON_PADDING = 10;         // space between the buttons, and around them
+
+constexpr int uiMenuRows(int buttonCount, int columnsOfButtons)
+{
+  return((buttonCount + columnsOfButtons - 1) / columnsOfButtons);
+}
+
+constexpr int uiMenuButtonSize(int displaySpaceSize, int buttonsAcross)
+{
+  return((displaySpaceSize - (MENU_BUTTON_PADDING*2) - (MENU_BUTTON_PADDING*(buttonsAcross-1))) / buttonsAcross);
+}
+
+constexpr int uiMenuOffset(int displaySpaceSize, int buttonSize, int buttonsAcross)
+{
+  return((displaySpaceSize - (buttonSize * buttonsAcross) - (MENU_BUTTON_PADDING*(buttonsAcross-1))) / 2);
+}
+
+constexpr int uiMenuButtonsOnRow(int buttonRow, int buttonCount, int columnsOfButtons)
+{
+  return(((buttonRow != uiMenuRows(buttonCount, columnsOfButtons) - 1) || (buttonCount % columnsOfButtons == 0)) ?
+    columnsOfButtons : buttonCount % columnsOfButtons);
+}
+
+constexpr MENU_BUTTON_RECT uiMenuButtonRect(int buttonNumber, int buttonCount, int columnsOfButtons, 
+  int displaySpaceLeftX, int displaySpaceTopY, int displaySpaceWidth, int displaySpaceHeight)
+{
+  return(MENU_BUTTON_RECT {
+    (int16_t) (displaySpaceLeftX + 
+      uiMenuOffset(displaySpaceWidth, uiMenuButtonSize(displaySpaceWidth, columnsOfButtons), 
+        uiMenuButtonsOnRow(buttonNumber / columnsOfButtons, buttonCount, columnsOfButtons)) +
+      (uiMenuButtonSize(displaySpaceWidth, columnsOfButtons) + MENU_BUTTON_PADDING) * (buttonNumber % columnsOfButtons)),
+    (int16_t) (displaySpaceTopY + 
+      uiMenuOffset(displaySpaceHeight, uiMenuButtonSize(displaySpaceHeight, uiMenuRows(buttonCount, columnsOfButtons)), 
+        uiMenuRows(buttonCount, columnsOfButtons)) +
+      (uiMenuButtonSize(displaySpaceHeight, uiMenuRows(buttonCount, columnsOfButtons)) + MENU_BUTTON_PADDING) * (buttonNumber / columnsOfButtons)),
+    (int16_t) uiMenuButtonSize(displaySpaceWidth, columnsOfButtons),
+    (int16_t) uiMenuButtonSize(displaySpaceHeight, uiMenuRows(buttonCount, columnsOfButtons))});
+}
+
+
+//
+// number of a menu's buttons whose layout is kept, the buttons of larger menus are 
+// laid out each time they're used
+//
+const int MENU_LAYOUT_MAX_BUTTONS = 16;
+
+
+//
+// statistics about writing configuration values to the EEPROM
+//
+typedef struct 
+{
+  unsigned long commitCount;                // number of times changed values have been saved
+  unsigned long bytesWritten;               // number of EEPROM bytes written
+  unsigned long lastCommitMicros;           // time spent writing the most recent save, in us
+  unsigned long longestCommitMicros;        // longest time spent writing one save, in us
+  unsigned long longestStallMicros;         // longest time the UI was held up by one write step, in us
+} CONFIGURATION_COMMIT_STATS;
+
+
+//
+// definition of a field in a configuration schema, fields are saved in the order
+// of the schema's table
+//
+typedef struct 
+{
+  byte fieldType;                           // CONFIG_FIELD_TYPE_BYTE, _SHORT, _INT or _FLOAT
+  int structOffset;                         // location in the app's struct, ie: offsetof(MY_CONFIG, brightness)
+  double defaultValue;                      // value used if the field has never been saved
+  double minimumValue;                      // saved values outside of min/max are replaced by the default
+  double maximumValue;                      //   (set both to 0 to skip the range check)
+  byte versionAdded;                        // schema version the field was added in
+} CONFIG_FIELD;
+
+
+//
+// types of fields in a configuration schema
+//
+const byte CONFIG_FIELD_TYPE_BYTE          = 0;
+const byte CONFIG_FIELD_TYPE_SHORT         = 1;
+const byte CONFIG_FIELD_TYPE_INT           = 2;
+const byte CONFIG_FIELD_TYPE_FLOAT         = 3;
+const byte CONFIG_FIELD_TYPE_END_OF_FIELDS = 4;
+
+
+//
+// definition of a configuration schema, a table of fields saved together as one 
+// block in EEPROM
+//
+typedef struct 
+{
+  int EEPromAddress;                        // where the block starts in EEPROM
+  byte version;                             // schema version, 1 to 254, bump when adding fields
+  const CONFIG_FIELD *fields;               // the table of fields, ending with CONFIG_FIELD_TYPE_END_OF_FIELDS
+  void (*migrateFunction)(byte oldVersion, void *configStruct);   // called after loading an older version, or NULL
+} CONFIG_SCHEMA;
+
+
+//
+// a sample from the touch screen, recorded by startTouchRecording() and played 
+// back by startTouchReplay()
+//
+typedef struct 
+{
+  unsigned long time;                       // ms since the recording started
+  boolean touchedFlg;                       // true if the screen was being touched
+  short xRaw;                               // raw touch screen coordinates of the touch
+  short yRaw;
+} TOUCH_SAMPLE;
+
+
+//
+// a clipping rectangle, set with pushClip().  While it's set, drawing only changes
+// the pixels inside of it.
+//
+typedef struct 
+{
+  int16_t leftX;                            // edges of the rectangle, the pixels on them are inside
+  int16_t topY;
+  int16_t rightX;
+  int16_t bottomY;
+} CLIP_RECT;
+
+const int CLIP_STACK_DEPTH = 8;
+
+
+//
+// counters kept by the draw-call profiler, one for each LCD primitive, widget draw
+// function and widget check function
+//
+const int PROFILE_LCD_CLEAR_SCREEN                   = 0;
+const int PROFILE_LCD_DRAW_PIXEL                     = 1;
+const int PROFILE_LCD_DRAW_LINE                      = 2;
+const int PROFILE_LCD_DRAW_HORIZONTAL_LINE           = 3;
+const int PROFILE_LCD_DRAW_VERTICAL_LINE             = 4;
+const int PROFILE_LCD_DRAW_RECTANGLE                 = 5;
+const int PROFILE_LCD_DRAW_ROUNDED_RECTANGLE         = 6;
+const int PROFILE_LCD_DRAW_TRIANGLE                  = 7;
+const int PROFILE_LCD_DRAW_CIRCLE                    = 8;
+const int PROFILE_LCD_DRAW_FILLED_RECTANGLE          = 9;
+const int PROFILE_LCD_DRAW_FILLED_ROUNDED_RECTANGLE  = 10;
+const int PROFILE_LCD_DRAW_FILLED_TRIANGLE           = 11;
+const int PROFILE_LCD_DRAW_FILLED_CIRCLE             = 12;
+const int PROFILE_LCD_DRAW_IMAGE                     = 13;
+const int PROFILE_LCD_PRINT_CHARACTER                = 14;
+const int PROFILE_GET_TOUCH_EVENTS                   = 15;
+const int PROFILE_DRAW_MENU                          = 16;
+const int PROFILE_DRAW_TITLE_BAR                     = 17;
+const int PROFILE_CLEAR_DISPLAY_SPACE                = 18;
+const int PROFILE_DRAW_BUTTON                        = 19;
+const int PROFILE_DRAW_IMAGE_BUTTON                  = 20;
+const int PROFILE_DRAW_NUMBER_BOX                    = 21;
+const int PROFILE_DRAW_SELECTION_BOX                 = 22;
+const int PROFILE_DRAW_SLIDER                        = 23;
+const int PROFILE_CHECK_FOR_TITLE_BAR_BUTTON         = 24;
+const int PROFILE_CHECK_FOR_BUTTON                   = 25;
+const int PROFILE_CHECK_FOR_IMAGE_BUTTON             = 26;
+const int PROFILE_CHECK_FOR_NUMBER_BOX               = 27;
+const int PROFILE_CHECK_FOR_SELECTION_BOX            = 28;
+const int PROFILE_CHECK_FOR_SLIDER                   = 29;
+const int PROFILE_COUNTER_COUNT                      = 30;
+
+
+//
+// one of the draw-call profiler's counters, the pixels and time include everything
+// the function calls (ie drawing a button includes drawing its text)
+//
+typedef struct 
+{
+  unsigned long calls;                      // number of times the function was called
+  unsigned long pixels;                     // pixels drawn (curves and triangles are estimated)
+  unsigned long micros;                     // time spent in the function, in us
+} PROFILE_COUNTER;
+
+
+//
+// statistics from the draw-call profiler, since it was last reset
+//
+typedef struct 
+{
+  unsigned long elapsedMicros;              // time since the profiler was reset, in us
+  PROFILE_COUNTER counters[PROFILE_COUNTER_COUNT];   // indexed by PROFILE_LCD_CLEAR_SCREEN...
+} PROFILE_STATS;
+
+
+//
+// operations recorded in a trace, the app's own operations are numbered from TRACE_USER
+//
+const byte TRACE_DRAW_MENU                = 0;
+const byte TRACE_DRAW_TITLE_BAR           = 1;
+const byte TRACE_CLEAR_DISPLAY_SPACE      = 2;
+const byte TRACE_DRAW_BUTTON              = 3;
+const byte TRACE_DRAW_IMAGE_BUTTON        = 4;
+const byte TRACE_DRAW_NUMBER_BOX          = 5;
+const byte TRACE_DRAW_SELECTION_BOX       = 6;
+const byte TRACE_DRAW_SLIDER              = 7;
+const byte TRACE_TOUCH_SAMPLE             = 8;
+const byte TRACE_CONFIGURATION_COMMIT     = 9;
+const byte TRACE_MENU_COMMAND             = 10;
+const byte TRACE_MENU_CALLBACK            = 11;
+const byte TRACE_NUMERIC_KEYPAD           = 12;
+const byte TRACE_ID_COUNT                 = 13;
+const byte TRACE_USER                     = 32;
+
+
+//
+// types of trace events
+//
+const byte TRACE_EVENT_BEGIN = 0;
+const byte TRACE_EVENT_END   = 1;
+
+
+//
+// an event in a trace, recorded by startTrace()
+//
+typedef struct 
+{
+  unsigned long time;                       // micros() when the event happened
+  byte traceId;                             // the operation, ie: TRACE_DRAW_MENU
+  byte eventType;                           // TRACE_EVENT_BEGIN or TRACE_EVENT_END
+} TRACE_EVENT;
+
+
+//
+// a drawing command in the render queue, added by the LCD functions while 
+// startRenderQueue() is running
+//
+typedef struct 
+{
+  byte opcode;                              // what to draw, ie: a filled rectangle
+  int16_t args[6];                          // coordinates and sizes
+  uint16_t color;                           // 16 bit color, bit format: rrrrrggggggbbbbb
+  const void *pntr;                         // the image or font, or NULL
+} RENDER_COMMAND;
+
+
+//
+// the cursor, font and color used by the print functions, a task can keep its own 
+// rather than using the ones shared with the UI
+//
+typedef struct 
+{
+  const byte *font;                         // the font typeface, ie: UI_Font_13_Bold
+  uint16_t fontColor;                       // 16 bit color, bit format: rrrrrggggggbbbbb
+  int cursorX;                              // the cursor, advanced when printing
+  int cursorY;
+} DRAW_CONTEXT;
+
+
+//
+// where a button's text was broken onto lines and how wide they are, drawButton()
+// keeps the most recently used ones so redrawing a button (ie when it's pressed and 
+// released) doesn't break and measure its text again
+//
+const int BUTTON_LAYOUT_CACHE_SIZE = 8;
+const int BUTTON_LAYOUT_MAX_TEXT_LENGTH = 24;   // longer text isn't kept
+
+typedef struct 
+{
+  char text[BUTTON_LAYOUT_MAX_TEXT_LENGTH];     // the button's text
+  const byte *font;                         // font the text is drawn with
+  int16_t maxTextWidthInPixels;
+  byte line1Length;                         // characters on the first line
+  byte line2Index;                          // where the second line starts, 0 if none
+  int16_t line1Width;
+  int16_t line2Width;
+  unsigned long lastUsed;
+} BUTTON_LAYOUT;
+
+
+//
+// a button for the compositor: its face, a frame, an arrow or bars, and its lines
+// of text are drawn into a band buffer, then sent to the display through one 
+// address window
+//
+typedef struct 
+{
+  int x;                                    // the button, everything is drawn inside of it
+  int y;
+  int width;
+  int height;
+  uint16_t faceColor;
+  int radius;                               // radius of the face's corners, 0 for square
+  uint16_t backgroundColor;                 // color outside of the rounded corners
+  boolean frameFlg;                         // true for a raised frame on the left and top edges
+  uint16_t frameColor;
+  const byte *font;
+  uint16_t textColor;
+  const char *text[2];                      // lines of text, NULL if not used
+  int textX[2];                             // upper left corner of each line
+  int textY[2];
+  uint16_t symbolColor;                     // color of the arrow and bars
+  boolean arrowFlg;                         // true to draw a triangle
+  int arrowX[3];
+  int arrowY[3];
+  int barCount;                             // bars on the Menu button, 0 for none
+  int barX;
+  int barY;                                 // top of the first bar
+  int barWidth;
+  int barHeight;
+  int barSpacing;                           // from the top of one bar to the next
+} BUTTON_COMPOSITE;
+
+
 //
 // types of touch events
 //
@@ -258,6 +686,7 @@ class TouchUserInterfaceForArduino
     //
     TouchUserInterfaceForArduino(void);
     void begin(int lcdCSPin, int LcdDCPin, int TouchScreenCSPin, int lcdOrientation, const byte *font);
+    void begin(SPIClass &spi, int lcdCSPin, int LcdDCPin, int TouchScreenCSPin, int lcdOrientation, const byte *font);
     void setOrientation(int lcdOrientation);
     void setColorPaletteBlue(void);
     void setColorPaletteGray(void);
@@ -273,6 +702,9 @@ class TouchUserInterfaceForArduino
     void drawTitleBar(const char *titleBarText);
     void drawTitleBarWithBackButton(const char *titleBarText);
     void drawTitleBarWithMenuButton(const char *titleBarText);
+    void drawTitleBar(const UI_LABEL &titleBarLabel);
+    void drawTitleBarWithBackButton(const UI_LABEL &titleBarLabel);
+    void drawTitleBarWithMenuButton(const UI_LABEL &titleBarLabel);
     boolean checkForBackButtonClicked(void);
     boolean checkForMenuButtonClicked(void);
     void clearDisplaySpace(void);
@@ -280,6 +712,8 @@ class TouchUserInterfaceForArduino
 
     void drawButton(BUTTON &uiButton);
     void drawButton(BUTTON_EXTENDED &uiButtonExt);
+    void drawButton(BUTTON &uiButton, const UI_LABEL &label);
+    void drawButton(BUTTON_EXTENDED &uiButtonExt, const UI_LABEL &label);
     boolean checkForButtonClicked(BUTTON &uiButton);
     boolean checkForButtonClicked(BUTTON_EXTENDED &uiButton);
     boolean checkForButtonAutoRepeat(BUTTON &uiButton);
@@ -304,6 +738,11 @@ class TouchUserInterfaceForArduino
     void drawSliderBall(SLIDER &slider, uint16_t ballColor);
     boolean checkForSliderTouched(SLIDER &slider);
 
+    void drawTextBox(TEXT_BOX &textBox);
+    void setTextBoxText(TEXT_BOX &textBox, const char *text);
+    void scrollTextBox(TEXT_BOX &textBox, int lines);
+    boolean checkForTextBoxTouched(TEXT_BOX &textBox);
+
     boolean numericKeyPad(const char *titleBar, float &value, float minValue, float maxValue);
     boolean numericKeyPad(const char *titleBar, int &value, int minValue, int maxValue);
 
@@ -312,7 +751,34 @@ class TouchUserInterfaceForArduino
     void setDefaultTouchScreenCalibrationConstants(int lcdOrientation);
     void setTouchScreenCalibrationConstants(int tsToLCDOffsetX, float tsToLCDScalerX, int tsToLCDOffsetY, float tsToLCDScalerY);
     boolean getTouchScreenCoords(int *xLCD, int *yLCD);
+    void startTouchRecording(TOUCH_SAMPLE *sampleBuffer, int bufferSize);
+    int stopTouchRecording(void);
+    void printTouchRecording(Print &port);
+    void startTouchReplay(const TOUCH_SAMPLE *samples, int sampleCount);
+    boolean isTouchReplayRunning(void);
+    unsigned long getTouchReplayTime(void);
+    void startTrace(TRACE_EVENT *eventBuffer, int bufferSize);
+    void stopTrace(void);
+    void traceBegin(byte traceId);
+    void traceEnd(byte traceId);
+    void printTrace(Print &port);
+    void startStackMeasurement(int paintBytes);
+    int getStackHighWater(void);
+    void printStackReport(Print &port);
+    void startRenderQueue(RENDER_COMMAND *commandBuffer, int bufferSize);
+    void stopRenderQueue(void);
+    boolean renderQueuedCommands(void);
+    void waitForRenderQueue(void);
+#if defined(ARDUINO_ARCH_ESP32)
+    void startRenderTask(RENDER_COMMAND *commandBuffer, int bufferSize, int core);
+#endif
+    void setBusLockFunctions(void (*lockFunction)(void), void (*unlockFunction)(void));
+#if defined(ARDUINO_ARCH_ESP32)
+    void enableThreadSafeDrawing(void);
+#endif
 
+    boolean pushClip(int x, int y, int width, int height);
+    void popClip(void);
     void lcdClearScreen(uint16_t color);
     void lcdDrawPixel(int x, int y, uint16_t color);
     void lcdDrawLine(int x1, int y1, int x2, int y2, uint16_t color);
@@ -342,9 +808,15 @@ class TouchUserInterfaceForArduino
     void lcdPrintCentered(int n);
     void lcdPrintCentered(double n, int digitsRightOfDecimal = 5);
     void lcdPrintCharacter(byte character);
+    void lcdPrint(DRAW_CONTEXT &context, const char *s);
+    void lcdPrintRightJustified(DRAW_CONTEXT &context, const char *s);
+    void lcdPrintCentered(DRAW_CONTEXT &context, const char *s);
+    void lcdPrintCharacter(DRAW_CONTEXT &context, byte character);
     int lcdStringWidthInPixels(char *s);
     int lcdStringWidthInPixels(const char *s);
+    int lcdStringWidthInPixels(DRAW_CONTEXT &context, const char *s);
     int lcdCharacterWidth(byte c);
+    int lcdCharacterWidth(DRAW_CONTEXT &context, byte c);
     int lcdGetFontHeightWithDecenders(void);
     int lcdGetFontHeightWithoutDecenders(void);
     int lcdGetFontHeightWithDecentersAndLineSpacing(void);
@@ -360,6 +832,19 @@ class TouchUserInterfaceForArduino
     int readConfigurationInt(int EEPromAddress, int defaultValue);
     void writeConfigurationFloat(int EEPromAddress, float value);
     float readConfigurationFloat(int EEPromAddress, float defaultValue);
+    void flushConfiguration(void);
+    void setConfigurationCommitDelay(unsigned long idleMilliseconds);
+    void getConfigurationCommitStats(CONFIGURATION_COMMIT_STATS &stats);
+    boolean loadConfiguration(const CONFIG_SCHEMA &schema, void *configStruct);
+    void saveConfiguration(const CONFIG_SCHEMA &schema, const void *configStruct);
+    void setConfigurationDefaults(const CONFIG_SCHEMA &schema, void *configStruct);
+    int getConfigurationSize(const CONFIG_SCHEMA &schema);
+
+    void getProfileStats(PROFILE_STATS &stats);
+    void resetProfileStats(void);
+    void printProfileStats(Print &port);
+    void showPerformanceOverlay(const byte *font);
+    void hidePerformanceOverlay(void);
 
 
 
@@ -368,10 +853,16 @@ class TouchUserInterfaceForArduino
     // private member variables
     //
     MENU_ITEM *currentMenuTable;
-    const byte *currentFont;
-    uint16_t fontColor;
-    int textCursorX;
-    int textCursorY;
+    DRAW_CONTEXT drawContext;
+
+    const MENU_ITEM *menuLayoutTable;         // menu that menuLayout[] was found for
+    int menuLayoutDisplaySpaceWidth;          // and the display space's size then
+    int menuLayoutButtonCount;
+    int menuLayoutColumns;
+    MENU_BUTTON_RECT menuLayout[MENU_LAYOUT_MAX_BUTTONS];
+
+    BUTTON_LAYOUT buttonLayouts[BUTTON_LAYOUT_CACHE_SIZE];
+    unsigned long buttonLayoutUseCount;
 
     void (*inMenuCallbackFunction)();
 
@@ -396,6 +887,42 @@ class TouchUserInterfaceForArduino
     int touchScreenToLCDOffsetY;
     float touchScreenToLCDScalerY;
     int touchState;
+    unsigned long touchEventStartTime;
+    int recordedTouchX;
+    int recordedTouchY;
+
+    Adafruit_ILI9341 *lcd;
+    XPT2046_Touchscreen *ts;
+    SPIClass *touchScreenSPI;
+
+    TOUCH_SAMPLE *touchRecordingSamples;
+    boolean touchRecordingFlg;
+    int touchRecordingBufferSize;
+    int touchRecordingCount;
+    unsigned long touchRecordingStartTime;
+    const TOUCH_SAMPLE *touchReplaySamples;
+    int touchReplayCount;
+    int touchReplayIdx;
+    unsigned long touchReplayTime;
+
+    RENDER_COMMAND *volatile renderQueue;
+    int renderQueueSize;
+    volatile int renderQueueHead;             // where the app's core adds the next command
+    volatile int renderQueueTail;             // the next command for the render loop to draw
+
+    CLIP_RECT clipStack[CLIP_STACK_DEPTH + 1];  // [0] is no clipping, the top is the clip in use
+    int clipStackDepth;                       // pushes not yet popped, can be more than CLIP_STACK_DEPTH
+    CLIP_RECT drawClip;                       // clip the display draws with, set by the render loop when queuing
+
+    const byte *performanceOverlayFont;       // NULL when the overlay isn't shown
+    boolean lcdBusyTimingFlg;                 // true while LCD_BUSY_TIMER() adds to lcdBusyMicros
+    unsigned long lcdBusyMicros;
+    unsigned long performanceOverlayPeriodStartTime;
+    unsigned long performanceOverlayLastCallTime;
+    unsigned long performanceOverlayLoopCount;
+    unsigned long performanceOverlayWorstLatency;
+    int performanceOverlayValues[3];
+    int performanceOverlayShownValues[3];
 
 
     //
@@ -406,8 +933,10 @@ class TouchUserInterfaceForArduino
     void drawMenuItem(int menuIdx, boolean buttonSelectedFlg);
     int findMenuButtonForTouchEvent(void);
     void getMenuButtonSizeAndLocation(int menuButtonNumber, int *buttonX, int *buttonY, int *buttonWidth, int *buttonHeight);
+    void layoutMenu(void);
 
     void drawTitleBar(const char *titleBarText, int buttonType);
+    void drawTitleBar(const char *titleBarText, const UI_LABEL *titleBarLabel, int buttonType);
     void drawTitleBarBackButton(boolean buttonSelectedFlg);
     void drawTitleBarMenuButton(boolean buttonSelectedFlg);
     void getBackButtonSizeAndLocation(int *buttonX, int *buttonY, int *buttonWidth, int *buttonHeight);
@@ -415,8 +944,12 @@ class TouchUserInterfaceForArduino
 
     void drawButton(BUTTON &uiButton, boolean buttonSelectedFlg);
     void drawButton(BUTTON_EXTENDED &uiButtonExt, boolean buttonSelectedFlg);
-    void drawButton(const char *buttonText, boolean buttonSelectedFlg, int buttonX, int buttonY, int buttonWidth, int buttonHeight);
-    void drawButton(const char *buttonText, int buttonX, int buttonY, int buttonWidth, int buttonHeight, uint16_t buttonColor, uint16_t buttonFrameColor, uint16_t buttonTextColor, const byte *buttonFont);
+    void drawButton(const char *buttonText, boolean buttonSelectedFlg, int buttonX, int buttonY, int buttonWidth, int buttonHeight, boolean submenuArrowFlg = false);
+    void drawButton(const char *buttonText, int buttonX, int buttonY, int buttonWidth, int buttonHeight, uint16_t buttonColor, uint16_t buttonFrameColor, uint16_t buttonTextColor, const byte *buttonFont, const UI_LABEL *label = NULL, boolean submenuArrowFlg = false);
+    boolean drawCompositeButton(BUTTON_COMPOSITE &button);
+    boolean breakLabel(const UI_LABEL *label, int maxTextWidthInPixels, int destBufferLength, int *line1Length, int *line1Width);
+    BUTTON_LAYOUT *findButtonLayout(const char *text, const byte *font, int maxTextWidthInPixels);
+    void saveButtonLayout(const char *text, const byte *font, int maxTextWidthInPixels, int line1Length, int line2Index, int line1Width, int line2Width);
     boolean breakStringAtWhiteSpace(const char *srcString, int *srcIndex, char *destString, int destBufferLength, int breakAtWhiteCount);
 
     void drawImageButton(IMAGE_BUTTON &uiImageButton, boolean showButtonTouchedFlg);
@@ -438,6 +971,8 @@ class TouchUserInterfaceForArduino
     int countSelectionBoxChoices(SELECTION_BOX &selectionBox);
 
     int getSliderBallXPosition(SLIDER &slider);
+    void layoutTextBox(TEXT_BOX &textBox, int maxTextWidthInPixels);
+    int getTextBoxVisibleLines(TEXT_BOX &textBox);
     int getBallsValue(SLIDER &slider, int lcdX);
 
     void keypad_DisplayValueInStringBuf(void);
@@ -446,9 +981,37 @@ class TouchUserInterfaceForArduino
     void touchScreenInitialize(int lcdOrientation);
     void touchScreenSetOrientation(int lcdOrientation);
     boolean getRAWTouchScreenCoords(int *xRaw, int *yRaw);
+    void recordTouchSample(boolean touchedFlg, int xRaw, int yRaw);
+    boolean getReplayedTouchSample(int *xRaw, int *yRaw);
      
+    void beginUI(int lcdOrientation, const byte *font);
     void lcdInitialize(int lcdOrientation, const byte *font);
     void lcdSetOrientation(int lcdOrientation);
+    void lcdDrawCharacterPixels(int x, int y, byte c, const byte *font, uint16_t color);
+    boolean isClippedOut(int leftX, int topY, int rightX, int bottomY);
+    void setDrawClip(void);
+    void lcdDrawFilledRoundedRectanglePixels(int x, int y, int width, int height, int radius, uint16_t color);
+    void lcdDrawFilledTrianglePixels(int x0, int y0, int x1, int y1, int x2, int y2, uint16_t color);
+    void lcdDrawFilledCirclePixels(int x, int y, int radius, uint16_t color);
+    void lcdDrawFilledRoundedColumns(int leftX, int rightX, int centerY, int radius, int stretch, uint16_t color);
+    void queueRenderCommand(byte opcode, uint16_t color, const void *pntr, 
+      int arg0 = 0, int arg1 = 0, int arg2 = 0, int arg3 = 0, int arg4 = 0, int arg5 = 0);
+
+    void loadConfigurationShadow(void);
+    void writeConfigurationValue(int EEPromAddress, const byte *dataPntr, int dataLength);
+    void setConfigurationBytes(int EEPromAddress, const byte *dataPntr, int dataLength);
+    boolean readConfigurationValue(int EEPromAddress, byte *dataPntr, int dataLength);
+    void commitConfigurationWhenIdle(void);
+    boolean writeConfigurationCommitStep(boolean oneByteFlg);
+    boolean loadConfigurationSlot(int slot, const byte *header);
+    void recordConfigurationCommitTime(unsigned long stepMicros, boolean commitCompleteFlg);
+    int configFieldSize(byte fieldType);
+    boolean configFieldInRange(const CONFIG_FIELD *field, const byte *valuePntr);
+    uint16_t configurationCRC(const byte *dataPntr, int length, uint16_t crc);
+
+    void updatePerformanceOverlay(void);
+    void drawPerformanceOverlay(boolean redrawAllFlg);
+    void drawPerformanceOverlayValue(int valueIdx, const char *units, const char *widestText, int rightX, int topY, boolean redrawAllFlg);
 };
 
 // ------------------------------------ End ---------------------------------
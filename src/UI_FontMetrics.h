@@ -0,0 +1,149 @@
+//      ******************************************************************
+//      *                                                                *
+//      *          Character widths of the UI fonts, for UI_TEXT()       *
+//      *                                                                *
+//      *               Copyright (c) S. Reifel & Co,  2023              *
+//      *                                                                *
+//      ******************************************************************
+
+//
+// Generated by extras/host/font_metrics.py from UI_Fonts.c, don't edit.  For each
+// font: the pixels added after each character, then the widths of the characters
+// 0x20 to 0x7f.  These are only read when compiling.
+//
+
+#ifndef UI_FontMetrics_h
+#define UI_FontMetrics_h
+
+constexpr byte UI_Font_9_Widths[] = {
+	1,
+	3, 2, 3, 4, 5, 7, 6, 1, 3, 3, 3, 5, 2, 2, 2, 3,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 2, 2, 4, 4, 4, 5,
+	9, 7, 5, 6, 6, 6, 5, 6, 6, 2, 4, 6, 5, 7, 6, 6,
+	5, 6, 6, 5, 5, 6, 7, 9, 5, 6, 6, 3, 3, 2, 3, 5,
+	2, 4, 4, 4, 4, 4, 3, 4, 4, 1, 1, 4, 1, 7, 4, 4,
+	4, 4, 3, 4, 2, 4, 5, 5, 4, 5, 3, 3, 2, 3, 4, 6,
+};
+
+constexpr byte UI_Font_10_Widths[] = {
+	1,
+	3, 1, 3, 5, 5, 9, 6, 1, 3, 3, 3, 5, 2, 3, 2, 3,
+	5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 1, 1, 5, 5, 5, 5,
+	10, 7, 6, 6, 6, 5, 5, 7, 6, 1, 4, 6, 5, 7, 6, 7,
+	5, 7, 6, 6, 5, 6, 7, 10, 6, 7, 6, 2, 3, 2, 5, 6,
+	2, 5, 5, 5, 5, 5, 3, 5, 5, 1, 1, 4, 1, 7, 5, 5,
+	5, 5, 3, 5, 2, 5, 5, 9, 5, 5, 5, 3, 1, 4, 5, 7,
+};
+
+constexpr byte UI_Font_10_Bold_Widths[] = {
+	1,
+	4, 3, 5, 7, 5, 10, 7, 2, 4, 4, 5, 6, 2, 3, 2, 5,
+	5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 3, 3, 6, 6, 6, 5,
+	8, 7, 6, 5, 6, 5, 5, 6, 6, 4, 4, 6, 5, 7, 6, 7,
+	6, 7, 7, 5, 6, 6, 6, 10, 6, 6, 5, 4, 5, 4, 7, 6,
+	5, 5, 5, 4, 5, 5, 5, 5, 5, 2, 3, 5, 2, 8, 5, 5,
+	5, 5, 4, 4, 5, 5, 5, 8, 5, 5, 4, 5, 3, 5, 7, 8,
+};
+
+constexpr byte UI_Font_11_Widths[] = {
+	1,
+	4, 2, 4, 7, 6, 10, 7, 2, 4, 3, 5, 6, 2, 4, 2, 3,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 2, 2, 6, 6, 6, 6,
+	11, 7, 7, 8, 8, 7, 7, 8, 8, 2, 5, 8, 7, 10, 8, 8,
+	8, 8, 8, 7, 7, 8, 7, 11, 8, 7, 6, 3, 3, 2, 5, 7,
+	3, 6, 6, 6, 6, 6, 3, 6, 6, 2, 2, 6, 2, 10, 6, 6,
+	6, 6, 4, 5, 3, 6, 5, 9, 6, 5, 5, 4, 2, 3, 7, 3,
+};
+
+constexpr byte UI_Font_11_Bold_Widths[] = {
+	0,
+	4, 3, 6, 8, 7, 9, 7, 3, 4, 4, 5, 7, 4, 4, 3, 6,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 3, 4, 6, 7, 6, 7,
+	12, 8, 7, 8, 8, 7, 7, 8, 8, 3, 5, 8, 7, 9, 8, 8,
+	8, 8, 8, 7, 7, 8, 8, 12, 8, 8, 8, 4, 6, 4, 7, 7,
+	4, 7, 7, 7, 7, 7, 4, 7, 7, 3, 3, 7, 3, 9, 7, 7,
+	7, 7, 4, 6, 4, 7, 7, 9, 6, 6, 6, 5, 3, 5, 8, 4,
+};
+
+constexpr byte UI_Font_12_Bold_Widths[] = {
+	1,
+	4, 2, 5, 6, 6, 8, 8, 2, 3, 3, 4, 6, 2, 3, 2, 3,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 2, 2, 6, 6, 6, 6,
+	11, 7, 7, 7, 7, 6, 5, 7, 7, 2, 6, 7, 6, 9, 7, 8,
+	7, 8, 8, 7, 6, 7, 8, 12, 7, 7, 6, 3, 3, 3, 6, 7,
+	3, 6, 6, 6, 6, 6, 4, 6, 6, 2, 2, 6, 2, 10, 6, 6,
+	6, 6, 4, 6, 3, 6, 6, 9, 6, 6, 5, 5, 2, 4, 6, 8,
+};
+
+constexpr byte UI_Font_13_Widths[] = {
+	1,
+	4, 2, 4, 8, 6, 11, 9, 2, 4, 3, 5, 8, 3, 3, 2, 4,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 2, 2, 7, 7, 7, 6,
+	12, 9, 8, 8, 8, 8, 7, 9, 8, 2, 5, 9, 7, 10, 8, 9,
+	8, 9, 8, 8, 7, 8, 9, 13, 7, 8, 7, 3, 4, 3, 5, 7,
+	3, 6, 6, 6, 6, 6, 4, 6, 6, 2, 2, 6, 2, 10, 6, 6,
+	6, 6, 4, 6, 3, 6, 5, 9, 6, 6, 6, 3, 2, 4, 7, 8,
+};
+
+constexpr byte UI_Font_13_Bold_Widths[] = {
+	1,
+	5, 3, 6, 6, 6, 9, 9, 3, 4, 3, 5, 7, 3, 4, 3, 4,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 3, 3, 6, 7, 7, 7,
+	13, 9, 8, 9, 8, 7, 7, 9, 8, 3, 6, 8, 7, 10, 8, 9,
+	8, 9, 9, 8, 8, 8, 9, 13, 8, 8, 7, 4, 4, 3, 6, 7,
+	3, 7, 7, 7, 7, 7, 5, 7, 7, 3, 3, 7, 3, 11, 7, 7,
+	7, 7, 5, 6, 4, 7, 7, 11, 7, 7, 6, 5, 2, 5, 7, 8,
+};
+
+constexpr byte UI_Font_14_Widths[] = {
+	1,
+	5, 3, 4, 8, 7, 12, 10, 2, 4, 4, 5, 8, 3, 4, 3, 4,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 2, 2, 8, 8, 8, 7,
+	14, 9, 9, 10, 10, 9, 8, 10, 9, 2, 6, 10, 8, 10, 9, 11,
+	9, 11, 10, 9, 9, 9, 9, 15, 9, 9, 8, 4, 4, 3, 5, 8,
+	3, 7, 7, 7, 7, 7, 4, 7, 7, 2, 2, 7, 2, 12, 7, 7,
+	7, 7, 5, 7, 4, 7, 7, 11, 7, 7, 7, 5, 2, 5, 8, 9,
+};
+
+constexpr byte UI_Font_14_Bold_Widths[] = {
+	1,
+	6, 3, 7, 7, 7, 12, 11, 3, 5, 4, 5, 8, 3, 5, 3, 4,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 3, 3, 7, 8, 7, 8,
+	14, 9, 10, 10, 10, 9, 8, 11, 10, 3, 7, 10, 8, 12, 10, 11,
+	9, 11, 11, 9, 9, 10, 9, 13, 9, 9, 8, 5, 4, 4, 8, 8,
+	3, 8, 8, 7, 8, 8, 6, 8, 8, 3, 3, 7, 3, 11, 8, 8,
+	8, 8, 6, 7, 5, 8, 8, 11, 7, 7, 7, 6, 3, 5, 8, 9,
+};
+
+constexpr byte UI_Font_15_Widths[] = {
+	1,
+	5, 3, 5, 9, 8, 13, 10, 2, 4, 4, 5, 8, 3, 4, 3, 4,
+	8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 2, 2, 8, 8, 8, 8,
+	16, 10, 10, 11, 11, 10, 9, 11, 10, 2, 7, 10, 8, 12, 10, 11,
+	10, 11, 10, 10, 9, 10, 10, 15, 11, 9, 9, 4, 4, 3, 7, 9,
+	3, 8, 8, 7, 8, 8, 4, 8, 7, 2, 2, 8, 2, 12, 7, 8,
+	8, 8, 5, 7, 4, 7, 7, 11, 7, 7, 7, 5, 2, 5, 8, 10,
+};
+
+constexpr byte UI_Font_15_Bold_Widths[] = {
+	1,
+	6, 3, 7, 8, 8, 15, 12, 3, 5, 4, 5, 8, 3, 5, 3, 4,
+	8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 4, 4, 8, 8, 8, 9,
+	16, 11, 11, 11, 11, 10, 9, 11, 11, 3, 8, 11, 9, 12, 11, 11,
+	10, 11, 12, 10, 10, 11, 11, 15, 10, 10, 9, 5, 4, 4, 8, 9,
+	3, 9, 9, 8, 9, 8, 6, 9, 9, 3, 3, 8, 3, 13, 9, 9,
+	9, 9, 6, 8, 5, 9, 8, 13, 8, 9, 8, 6, 3, 6, 9, 10,
+};
+
+constexpr byte UI_Font_16_Bold_Widths[] = {
+	1,
+	7, 4, 7, 11, 10, 15, 12, 3, 6, 5, 7, 10, 4, 5, 4, 4,
+	9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 4, 4, 10, 9, 10, 9,
+	12, 12, 10, 10, 10, 10, 9, 11, 11, 4, 9, 13, 9, 13, 11, 11,
+	10, 11, 11, 10, 11, 11, 12, 16, 12, 11, 10, 6, 4, 5, 9, 8,
+	4, 10, 10, 10, 10, 10, 6, 10, 10, 4, 4, 11, 4, 14, 10, 10,
+	10, 10, 7, 9, 6, 10, 9, 15, 11, 9, 8, 6, 3, 6, 10, 8,
+};
+
+
+#endif
@@ -97,5 +97,13 @@
 #endif
 
 
+//
+// the character widths used by UI_TEXT() to measure labels when compiling
+//
+#ifdef __cplusplus
+  #include "UI_FontMetrics.h"
+#endif
+
+
 
 #endif